@@ -0,0 +1,64 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* IMA ADPCM Codec for Live Audio Streaming */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Tables
+   2.0 Codec
+========================================*/
+
+/* ==================== 1.0 Includes & Tables ==================== */
+#include "adpcm.h"
+
+static const int16_t step_table[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143,
+    157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552,
+    1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767 };
+static const int8_t index_table[16] = { -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8 };
+
+/* ==================== 2.0 Codec ==================== */
+// Shared by both directions so the encoder tracks exactly what the decoder will reconstruct
+static void adpcm_step(adpcm_state_t *st, uint8_t code) {
+    int step = step_table[st->index], diff = step >> 3;
+    if(code & 4) { diff += step; } if(code & 2) { diff += step >> 1; } if(code & 1) { diff += step >> 2; }
+    int pred = st->predictor + ((code & 8) ? -diff : diff);
+    st->predictor = (pred > 32767) ? 32767 : (pred < -32768) ? -32768 : pred;
+    int idx = st->index + index_table[code]; st->index = (idx < 0) ? 0 : (idx > 88) ? 88 : idx;
+}
+
+size_t adpcm_encode(adpcm_state_t *st, const int16_t *pcm, size_t samples, uint8_t *out) {
+    for(size_t i = 0; i < samples; i++) {
+        int step = step_table[st->index], diff = pcm[i] - st->predictor; uint8_t code = 0;
+        if(diff < 0) { code = 8; diff = -diff; }
+        if(diff >= step) { code |= 4; diff -= step; } step >>= 1;
+        if(diff >= step) { code |= 2; diff -= step; } step >>= 1;
+        if(diff >= step) { code |= 1; }
+        adpcm_step(st, code);
+        if(i & 1) out[i >> 1] |= code << 4; else out[i >> 1] = code;
+    }
+    return (samples + 1) / 2;
+}
+
+size_t adpcm_decode(adpcm_state_t *st, const uint8_t *in, size_t samples, int16_t *pcm) {
+    for(size_t i = 0; i < samples; i++) { adpcm_step(st, (i & 1) ? (in[i >> 1] >> 4) : (in[i >> 1] & 0x0F)); pcm[i] = st->predictor; }
+    return samples;
+}
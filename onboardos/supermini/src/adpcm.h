@@ -0,0 +1,41 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* IMA ADPCM Encoder Header */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Structs
+   2.0 Prototypes
+========================================*/
+
+/* ==================== 1.0 Includes & Structs ==================== */
+#ifndef ADPCM_H
+#define ADPCM_H
+#include <stdint.h>
+#include <stddef.h>
+
+typedef struct { int16_t predictor; uint8_t index; } adpcm_state_t;
+
+/* ==================== 2.0 Prototypes ==================== */
+// Packs two 4-bit codes per byte, low nibble first (same order as IMA ADPCM in WAV). Returns bytes written.
+size_t adpcm_encode(adpcm_state_t *st, const int16_t *pcm, size_t samples, uint8_t *out);
+size_t adpcm_decode(adpcm_state_t *st, const uint8_t *in, size_t samples, int16_t *pcm);
+
+#endif
@@ -0,0 +1,65 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Interleaved I2S to PCM16 Conversion Kernels */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes
+   2.0 Mono & Stereo Conversion
+   3.0 Channel Select & Sum
+========================================*/
+
+/* ==================== 1.0 Includes ==================== */
+#include "audio_convert.h"
+
+/* Loops are unrolled by 4 with restrict pointers so the Xtensa compiler can keep loads, shifts and stores
+   in flight without aliasing checks. Kept free of IDF headers so they can be compiled on a host as-is. */
+#define CVT(x) sat16((x) >> AUDIO_SAMPLE_SHIFT)
+
+// The 18-bit sample is wider than int16: clip loud input at the rails instead of wrapping it to the other sign.
+// The compare pair maps to a single CLAMPS on the S3.
+static inline int16_t sat16(int32_t v) { return (int16_t)(v > INT16_MAX ? INT16_MAX : v < INT16_MIN ? INT16_MIN : v); }
+
+/* ==================== 2.0 Mono & Stereo Conversion ==================== */
+void audio_convert_mono(const int32_t *restrict in, int16_t *restrict out, size_t samples) {
+    size_t i = 0;
+    for(; i + 4 <= samples; i += 4) { out[i] = CVT(in[i]); out[i+1] = CVT(in[i+1]); out[i+2] = CVT(in[i+2]); out[i+3] = CVT(in[i+3]); }
+    for(; i < samples; i++) out[i] = CVT(in[i]);
+}
+
+// Interleaved L/R words stay interleaved, so stereo is the mono kernel over twice the samples
+void audio_convert_stereo(const int32_t *restrict in, int16_t *restrict out, size_t frames) { audio_convert_mono(in, out, frames * 2); }
+
+/* ==================== 3.0 Channel Select & Sum ==================== */
+void audio_select_channel(const int32_t *restrict in, int16_t *restrict out, size_t frames, int channel) {
+    const int32_t *src = in + (channel ? 1 : 0); size_t i = 0;
+    for(; i + 4 <= frames; i += 4) { out[i] = CVT(src[2*i]); out[i+1] = CVT(src[2*i+2]); out[i+2] = CVT(src[2*i+4]); out[i+3] = CVT(src[2*i+6]); }
+    for(; i < frames; i++) out[i] = CVT(src[2*i]);
+}
+
+// Averages both mics (each pre-halved so the add cannot overflow) to keep the level of a single mic
+void audio_sum_channels(const int32_t *restrict in, int16_t *restrict out, size_t frames) {
+    size_t i = 0;
+    for(; i + 4 <= frames; i += 4) {
+        const int32_t *p = in + 2*i;
+        out[i] = CVT((p[0] >> 1) + (p[1] >> 1)); out[i+1] = CVT((p[2] >> 1) + (p[3] >> 1)); out[i+2] = CVT((p[4] >> 1) + (p[5] >> 1)); out[i+3] = CVT((p[6] >> 1) + (p[7] >> 1));
+    }
+    for(; i < frames; i++) out[i] = CVT((in[2*i] >> 1) + (in[2*i+1] >> 1));
+}
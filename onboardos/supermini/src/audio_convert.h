@@ -0,0 +1,43 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* I2S Sample Conversion Kernels Header */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes
+   2.0 Prototypes
+========================================*/
+
+/* ==================== 1.0 Includes ==================== */
+#ifndef AUDIO_CONVERT_H
+#define AUDIO_CONVERT_H
+#include <stdint.h>
+#include <stddef.h>
+
+#define AUDIO_SAMPLE_SHIFT 14 // SPH0645 left-justifies 18 bits in a 32-bit slot
+
+/* ==================== 2.0 Prototypes ==================== */
+// All kernels take raw 32-bit I2S words and clip to int16; "frames" counts one sample per channel. in/out must not overlap.
+void audio_convert_mono(const int32_t *in, int16_t *out, size_t samples);
+void audio_convert_stereo(const int32_t *in, int16_t *out, size_t frames);
+void audio_select_channel(const int32_t *in, int16_t *out, size_t frames, int channel);
+void audio_sum_channels(const int32_t *in, int16_t *out, size_t frames);
+
+#endif
@@ -0,0 +1,38 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Sector Block Device Interface */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+#ifndef BLOCKDEV_H
+#define BLOCKDEV_H
+#include <stdint.h>
+
+#define BLOCKDEV_SECTOR_SIZE 512
+
+// Minimal 512-byte sector device. Kept free of IDF types so the storage code on top of it also builds on a host
+// against a file-backed image. Callbacks return 0 on success, anything else is an I/O error.
+typedef struct {
+    void *ctx;
+    uint32_t sector_count;
+    int (*read)(void *ctx, uint32_t lba, void *buf, uint32_t count);
+    int (*write)(void *ctx, uint32_t lba, const void *buf, uint32_t count);
+} blockdev_t;
+
+#endif
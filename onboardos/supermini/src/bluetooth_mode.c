@@ -32,61 +32,191 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <inttypes.h>
 #include <dirent.h>
 #include <sys/stat.h>
 #include <sys/time.h>
+#include <sys/unistd.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
+#include "freertos/semphr.h"
 #include "esp_bt.h"
 #include "esp_gap_ble_api.h"
 #include "esp_gatts_api.h"
 #include "esp_bt_main.h"
 #include "esp_gatt_common_api.h"
-#include "driver/sdspi_host.h"
-#include "esp_vfs_fat.h"
+#include "esp_timer.h"
+#include "esp_system.h"
+#include "esp_heap_caps.h"
 #include "globals.h"
 #include "rtc_module.h"
 #include "config_manager.h"
 #include "self_test.h"
 #include "gps_module.h"
+#include "bluetooth_mode.h"
+#include "live_stream.h"
+#include "logstore_sd.h"
+#include "sd_bench.h"
+#include "usb_msc.h"
+#include "sd_clock.h"
+#include "retention.h"
+#include "catalog.h"
+#include "storage_service.h"
+#include "stage.h"
+#include "wav_meta.h"
+#include "elc_writer.h"
+#include "telemetry.h"
+#include "xfer_proto.h"
+#include "crc32.h"
+#include "cmd_proto.h"
 
-#define MOUNT_POINT "/sdcard"
-#define TRANSFER_BLOCK_SIZE 490
+#define MOUNT_POINT STORAGE_MOUNT_POINT
+#define TRANSFER_BLOCK_SIZE 512 // Largest ATT value; each notification is min(this, MTU - 3)
+#define DLE_MAX_OCTETS 251     // LL payload with data length extension, 27 without
+#define CMD_PATH_LEN 300
+#define SUM_BLOCK 4096         // Read size for "sum"
+#define LSB_HDR 4              // "LSB" + entry count
+#define LSB_ENTRY 11           // Fixed part of a packed listing entry
+#define LSB_SCAN 64            // Records looked at per storage request, so a filter that matches little never holds the card
+#define UP_BLOCK_SIZE (16 * 1024) // Upload data per SD write
+#define UP_POOL_BLOCKS 4          // Blocks in the upload pool; the client's credit is this much past what is on the card
+#define CMD_PROGRESS_MS 1000   // PROGRESS interval for a binary request running on the job task
+#define LZ_WIN_SIZE 8192       // Read-ahead for compressed gets, which read XFER_LZ_SPAN per frame but consume less
 
 /* ==================== 2.0 Variables ==================== */
 static const uint8_t service_uuid[16] = {0x4b,0x91,0x31,0xc3,0xc9,0xc5,0xcc,0x8f,0x9e,0x45,0xb5,0x1f,0x01,0xc2,0xaf,0x4f};
 static const uint8_t char_cmd_uuid[16] = {0xa8,0x26,0x1b,0x36,0x07,0xea,0xf5,0xb7,0x88,0x46,0xe1,0x36,0x3e,0x48,0xb5,0xbe};
 static const uint8_t char_data_uuid[16] = {0x3b,0x70,0x7c,0x68,0xb9,0x70,0x42,0x94,0x22,0x4c,0xc4,0x03,0x7c,0x28,0x9a,0x82};
 static const uint8_t char_upload_uuid[16] = {0x0f,0x41,0xb3,0x04,0x10,0x00,0x20,0x81,0x03,0x49,0x83,0x58,0x12,0x1b,0x2e,0xce};
-enum { IDX_SVC, IDX_CHAR_CMD, IDX_CHAR_VAL_CMD, IDX_CHAR_DATA, IDX_CHAR_VAL_DATA, IDX_CHAR_CFG_DATA, IDX_CHAR_UPLOAD, IDX_CHAR_VAL_UPLOAD, HRS_IDX_NB };
+static const uint8_t char_stream_uuid[16] = {0x6e,0x2d,0x5a,0x17,0x84,0x3c,0x4f,0x9b,0xa1,0x52,0x0d,0xe7,0x39,0xc4,0x8b,0x1f};
+enum { IDX_SVC, IDX_CHAR_CMD, IDX_CHAR_VAL_CMD, IDX_CHAR_DATA, IDX_CHAR_VAL_DATA, IDX_CHAR_CFG_DATA, IDX_CHAR_UPLOAD, IDX_CHAR_VAL_UPLOAD, IDX_CHAR_STREAM, IDX_CHAR_VAL_STREAM, IDX_CHAR_CFG_STREAM, HRS_IDX_NB };
 
-typedef struct { uint16_t len; uint8_t data[512]; } up_chunk_t;
-QueueHandle_t up_queue = NULL;
+typedef struct { uint32_t len; uint8_t data[UP_BLOCK_SIZE]; } up_block_t;
+static up_block_t *up_pool[UP_POOL_BLOCKS], *up_fill = NULL; static int up_blocks = 0; // Pool, and the block the GATTS handler is filling
+static QueueHandle_t up_free = NULL, up_full = NULL; // Block pointers: empty ones, and full ones waiting for the command task
+static volatile bool up_stop = false; static bool up_sd_err = false; // Upload cut short: no room for a write, or the card refused a block
+static int64_t up_t0 = 0; static uint32_t up_start = 0, up_writes = 0; // Upload throughput, reported at end_upload
+static QueueHandle_t ack_queue = NULL; // Download ACKs written to the command characteristic
 
 static uint16_t conn_id = 0, echo_handle_table[HRS_IDX_NB];
 static esp_gatt_if_t gatts_if_handle = 0;
-static bool device_connected = false, is_downloading = false, is_uploading = false, cmd_ready = false;
-FILE *transfer_file = NULL;
-char pending_cmd[128] = {0};
-static sdmmc_card_t *card = NULL;
+static bool device_connected = false, is_downloading = false, is_uploading = false;
+static bool ble_started = false, command_mode = false; // command_mode is false when recording mode runs the server for live streaming
+static uint16_t ble_mtu = 23; static volatile bool ble_congested = false;
+static TaskHandle_t cmd_task = NULL; static bool pace_sleep = false; // "link sleep" brings back the fixed-delay pacing to compare against
+static esp_bd_addr_t peer_bda; static bool link_fast = true; // 2M PHY and DLE requested on connect; "link 1m" drops back for comparison
+static uint8_t phy_tx = 1, phy_rx = 1; static uint16_t dle_tx = 27, dle_rx = 27;
+static int64_t dl_t0 = 0; static uint32_t dl_bytes = 0, last_dl_bytes = 0, last_dl_ms = 0, last_dl_retx = 0, dl_wakeups = 0, last_dl_wakeups = 0; // Firmware-side download throughput
+static int xfer_fd = -1; static uint32_t xfer_off = 0; // Storage-service handle and offset for the FAT get/upload in progress
+static char up_path[CATALOG_PATH_LEN]; // Relative name of the file being uploaded, catalogued at end_upload
+static logstore_entry_t dl_entry; static bool dl_from_log = false; // get @log/<id> source
+static uint32_t up_total = 0; // Size the client announced for the upload in progress, checked at end_upload
+static xfer_tx_t dl_tx; // Sliding window of the download in progress
+static int dl_len = 0; static xfer_hdr_t dl_hdr; // Frame packed in fileBuf and waiting for a free buffer (-1 after a failed read)
+static const uint8_t *dl_src = NULL; static uint16_t dl_raw = 0; // File bytes behind the packed frame, for the range CRC
+static uint8_t *lz_win = NULL; static uint32_t lz_win_off = 0, lz_win_len = 0; // Read-ahead window of a compressed get
+static uint32_t dl_lz_us = 0, last_dl_lz_us = 0, last_dl_lz_raw = 0, last_dl_lz_wire = 0; // Compressor time and what it saved
+
+typedef struct { uint16_t id; uint8_t op; bool bin; char arg[CMD_ARG_LEN]; } cmd_req_t; // bin is false for a text command
+static QueueHandle_t req_queue = NULL, job_queue = NULL; // Every command from the GATTS handler, text or binary; long commands for the job task
+static TaskHandle_t job_task = NULL;
+static const cmd_req_t *cmd_ctx = NULL, *job_ctx = NULL; // Request each task is replying to
+static uint32_t idle_wakeups = 0; // Times the command task woke with no transfer running, reported by "link"
+static volatile bool job_bin = false; static uint16_t job_id = 0; static int64_t job_t0 = 0, job_prog_us = 0; // Binary job in progress
+static bool usb_restart = false; // usbmsc reboots once its reply is out
 
 /* ==================== 3.0 BLE & Notification Methods ==================== */
-static void park_cs_pins() { gpio_set_direction(SD_PIN_NUM_CS, GPIO_MODE_OUTPUT); gpio_set_level(SD_PIN_NUM_CS, 1); gpio_set_direction(ADXL_PIN_NUM_CS, GPIO_MODE_OUTPUT); gpio_set_level(ADXL_PIN_NUM_CS, 1); }
+static esp_err_t notify_raw(const uint8_t *data, size_t len) {
+    if(device_connected) return esp_ble_gatts_send_indicate(gatts_if_handle, conn_id, echo_handle_table[IDX_CHAR_VAL_DATA], len, (uint8_t *)data, false);
+    return ESP_FAIL;
+}
+
+// Every command reply goes through here: while a task is serving a binary request the line is wrapped in a DATA
+// response carrying its id, so a handler sends the same bytes for both forms. Download frames use notify_raw.
+static const cmd_req_t *cur_req(void) { TaskHandle_t t = xTaskGetCurrentTaskHandle(); return t == cmd_task ? cmd_ctx : t == job_task ? job_ctx : NULL; }
+static size_t rsp_header(uint8_t *out, const cmd_req_t *r, uint8_t st) { out[0] = CMD_RSP_MAGIC; out[1] = st; out[2] = r->id; out[3] = r->id >> 8; return CMD_RSP_HDR_LEN; }
 
 esp_err_t send_notification(uint8_t *data, size_t len) {
-    if(device_connected) return esp_ble_gatts_send_indicate(gatts_if_handle, conn_id, echo_handle_table[IDX_CHAR_VAL_DATA], len, data, false);
+    const cmd_req_t *r = cur_req(); uint8_t buf[CMD_RSP_HDR_LEN + TRANSFER_BLOCK_SIZE];
+    if(!r || !r->bin) return notify_raw(data, len);
+    if(len > TRANSFER_BLOCK_SIZE) len = TRANSFER_BLOCK_SIZE;
+    memcpy(buf + rsp_header(buf, r, CMD_ST_DATA), data, len); return notify_raw(buf, CMD_RSP_HDR_LEN + len);
+}
+
+esp_err_t send_stream_notification(uint8_t *data, size_t len) {
+    if(device_connected) return esp_ble_gatts_send_indicate(gatts_if_handle, conn_id, echo_handle_table[IDX_CHAR_VAL_STREAM], len, data, false);
     return ESP_FAIL;
 }
 
-void send_eof() { 
-    while(send_notification((uint8_t*)"EOF", 3) != ESP_OK && device_connected) { 
-        vTaskDelay(pdMS_TO_TICKS(20)); 
-    } 
+uint16_t ble_get_mtu(void) { return ble_mtu; }
+
+// Download and listing payload per notification: the negotiated MTU less the 3-byte ATT header
+static size_t xfer_block(void) { size_t n = ble_mtu - 3; return n < TRANSFER_BLOCK_SIZE ? n : TRANSFER_BLOCK_SIZE; }
+
+// Room for one reply notification: a binary response carries its header in the same notification
+static size_t reply_room(void) { const cmd_req_t *r = cur_req(); return xfer_block() - (r && r->bin ? CMD_RSP_HDR_LEN : 0); }
+
+// Asks for 2M PHY and 251-byte LL PDUs, or puts both back to the 4.0 defaults. A central without 2M or DLE answers
+// the LL request with "unsupported" and the link simply stays at 1M / 27 bytes, so legacy centrals keep working.
+static void request_link(void) {
+    esp_ble_gap_phy_mask_t phy = link_fast ? ESP_BLE_GAP_PHY_2M_PREF_MASK : ESP_BLE_GAP_PHY_1M_PREF_MASK;
+    esp_ble_gap_set_preferred_phy(peer_bda, 0, phy, phy, ESP_BLE_GAP_PHY_OPTIONS_NO_PREF);
+    esp_ble_gap_set_pkt_data_len(peer_bda, link_fast ? DLE_MAX_OCTETS : 27);
+}
+
+static int link_stats(char *out, size_t len) {
+    return snprintf(out, len, "LINK|%u|%u|%u|%u|%u|%lu|%lu|%lu|%lu|%lu|%s|%lu|%lu|%lu", ble_mtu, phy_tx, phy_rx, dle_tx, dle_rx, (unsigned long)last_dl_bytes, (unsigned long)last_dl_ms,
+                    (unsigned long)(last_dl_ms ? (uint64_t)last_dl_bytes * 1000 / 1024 / last_dl_ms : 0), (unsigned long)last_dl_retx,
+                    (unsigned long)(last_dl_bytes ? (uint64_t)last_dl_wakeups * 1048576 / last_dl_bytes : 0), pace_sleep ? "SLEEP" : "EVENT", (unsigned long)idle_wakeups,
+                    (unsigned long)(last_dl_lz_raw ? (uint64_t)last_dl_lz_wire * 100 / last_dl_lz_raw : 0), (unsigned long)(last_dl_bytes ? (uint64_t)last_dl_lz_us * 1048576 / last_dl_bytes : 0));
+}
+bool ble_is_congested(void) { return ble_congested; }
+
+// The command task sleeps on its notification: the GATTS handler gives it for a command, ACK or upload chunk and when
+// the link stops being congested. Bluedroid reports CONF_EVT for a notification as soon as it is queued, so congestion
+// is the only buffer signal; sending until it is raised keeps the L2CAP queue, and so the controller, full.
+// The notification is only ever a wake-up hint for wait_event and the idle wait, which recheck their condition;
+// storage requests wait on their own semaphore, so a give landing mid-read cannot end one early. The job task is
+// only woken while it is serving a job (job_ctx, set up to its final status), so tokens never pile up on job_queue.
+static void wake_cmd_task(void) { if(cmd_task) xTaskNotifyGive(cmd_task); if(job_task && job_ctx) xTaskNotifyGive(job_task); }
+static void wait_event(uint32_t ms) { ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ms) + 1); if(is_downloading && xTaskGetCurrentTaskHandle() == cmd_task) dl_wakeups++; }
+static void pace_delay(uint32_t ms) { vTaskDelay(pdMS_TO_TICKS(ms)); if(is_downloading) dl_wakeups++; }
+
+// Replies and listing lines: held back while congested, then retried on the next event instead of a fixed sleep
+static void send_blocking(const uint8_t *data, size_t len) {
+    while(device_connected && (ble_congested || send_notification((uint8_t*)data, len) != ESP_OK)) wait_event(100);
+}
+
+void send_eof() { send_blocking((const uint8_t*)"EOF", 3); }
+
+// Status response for a binary request (OK, ERR, ACCEPTED, ...), with an optional short payload
+static void send_status(const cmd_req_t *r, uint8_t st, const void *data, size_t len) {
+    uint8_t buf[CMD_RSP_HDR_LEN + 8]; size_t n = rsp_header(buf, r, st);
+    if(len > sizeof(buf) - n) len = sizeof(buf) - n;
+    if(len) memcpy(buf + n, data, len);
+    n += len;
+    while(device_connected && (ble_congested || notify_raw(buf, n) != ESP_OK)) wait_event(100);
 }
 
 static void gap_event_handler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *param) {
-    if(event == ESP_GAP_BLE_ADV_DATA_SET_COMPLETE_EVT) esp_ble_gap_start_advertising(&(esp_ble_adv_params_t){.adv_int_min=0x20, .adv_int_max=0x40, .adv_type=ADV_TYPE_IND, .own_addr_type=BLE_ADDR_TYPE_PUBLIC, .channel_map=ADV_CHNL_ALL, .adv_filter_policy=ADV_FILTER_ALLOW_SCAN_ANY_CON_ANY});
+    if(event == ESP_GAP_BLE_PHY_UPDATE_COMPLETE_EVT && param->phy_update.status == ESP_BT_STATUS_SUCCESS) { phy_tx = param->phy_update.tx_phy; phy_rx = param->phy_update.rx_phy; }
+    else if(event == ESP_GAP_BLE_SET_PKT_LENGTH_COMPLETE_EVT && param->pkt_data_length_cmpl.status == ESP_BT_STATUS_SUCCESS) { dle_tx = param->pkt_data_length_cmpl.params.tx_len; dle_rx = param->pkt_data_length_cmpl.params.rx_len; }
+    else if(event == ESP_GAP_BLE_ADV_DATA_SET_COMPLETE_EVT) esp_ble_gap_start_advertising(&(esp_ble_adv_params_t){.adv_int_min=0x20, .adv_int_max=0x40, .adv_type=ADV_TYPE_IND, .own_addr_type=BLE_ADDR_TYPE_PUBLIC, .channel_map=ADV_CHNL_ALL, .adv_filter_policy=ADV_FILTER_ALLOW_SCAN_ANY_CON_ANY});
+}
+
+// Upload writes, in the BTC task: one copy from the stack's buffer into the block being filled, and full blocks go to
+// the command task by pointer. A write the pool has no room for (a client ignoring its credit) ends the upload at
+// that offset, so the card always holds a clean prefix that "UP|SHORT" reports and a resumed upload continues from.
+static bool up_accept(const uint8_t *data, size_t len) {
+    bool handed = false;
+    while(len && !up_stop) {
+        if(!up_fill && xQueueReceive(up_free, &up_fill, 0) != pdTRUE) { up_stop = true; break; }
+        size_t n = UP_BLOCK_SIZE - up_fill->len < len ? UP_BLOCK_SIZE - up_fill->len : len;
+        memcpy(up_fill->data + up_fill->len, data, n); up_fill->len += n; data += n; len -= n;
+        if(up_fill->len == UP_BLOCK_SIZE) { xQueueSend(up_full, &up_fill, 0); up_fill = NULL; handed = true; }
+    }
+    return handed;
 }
 
 static void gatts_event_handler(esp_gatts_cb_event_t event, esp_gatt_if_t gatts_if, esp_ble_gatts_cb_param_t *param) {
@@ -95,108 +225,591 @@ static void gatts_event_handler(esp_gatts_cb_event_t event, esp_gatt_if_t gatts_
             gatts_if_handle = gatts_if; esp_ble_gap_set_device_name("EchoLog");
             esp_ble_gap_config_adv_data(&(esp_ble_adv_data_t){.set_scan_rsp=false, .include_name=true, .include_txpower=false, .min_interval=0x0006, .max_interval=0x0010, .appearance=0x00, .service_uuid_len=16, .p_service_uuid=(uint8_t*)service_uuid, .flag=(ESP_BLE_ADV_FLAG_GEN_DISC|ESP_BLE_ADV_FLAG_BREDR_NOT_SPT)});
             static const uint16_t primary_service_uuid=ESP_GATT_UUID_PRI_SERVICE, character_declaration_uuid=ESP_GATT_UUID_CHAR_DECLARE, character_client_config_uuid=ESP_GATT_UUID_CHAR_CLIENT_CONFIG;
-            static const uint8_t char_prop_write=ESP_GATT_CHAR_PROP_BIT_WRITE, char_prop_read_notify=ESP_GATT_CHAR_PROP_BIT_READ|ESP_GATT_CHAR_PROP_BIT_NOTIFY, ccc_value[2]={0x00, 0x00};
+            static const uint8_t char_prop_write=ESP_GATT_CHAR_PROP_BIT_WRITE, char_prop_upload=ESP_GATT_CHAR_PROP_BIT_WRITE|ESP_GATT_CHAR_PROP_BIT_WRITE_NR, char_prop_read_notify=ESP_GATT_CHAR_PROP_BIT_READ|ESP_GATT_CHAR_PROP_BIT_NOTIFY, ccc_value[2]={0x00, 0x00};
             const esp_gatts_attr_db_t gatt_db[HRS_IDX_NB] = {
                 [IDX_SVC]={{ESP_GATT_AUTO_RSP},{ESP_UUID_LEN_16,(uint8_t*)&primary_service_uuid,ESP_GATT_PERM_READ,16,16,(uint8_t*)service_uuid}},
                 [IDX_CHAR_CMD]={{ESP_GATT_AUTO_RSP},{ESP_UUID_LEN_16,(uint8_t*)&character_declaration_uuid,ESP_GATT_PERM_READ,1,1,(uint8_t*)&char_prop_write}},
                 [IDX_CHAR_VAL_CMD]={{ESP_GATT_AUTO_RSP},{ESP_UUID_LEN_128,(uint8_t*)char_cmd_uuid,ESP_GATT_PERM_WRITE,200,0,NULL}},
                 [IDX_CHAR_DATA]={{ESP_GATT_AUTO_RSP},{ESP_UUID_LEN_16,(uint8_t*)&character_declaration_uuid,ESP_GATT_PERM_READ,1,1,(uint8_t*)&char_prop_read_notify}},
-                [IDX_CHAR_VAL_DATA]={{ESP_GATT_AUTO_RSP},{ESP_UUID_LEN_128,(uint8_t*)char_data_uuid,ESP_GATT_PERM_READ,200,0,NULL}},
+                [IDX_CHAR_VAL_DATA]={{ESP_GATT_AUTO_RSP},{ESP_UUID_LEN_128,(uint8_t*)char_data_uuid,ESP_GATT_PERM_READ,TRANSFER_BLOCK_SIZE,0,NULL}},
                 [IDX_CHAR_CFG_DATA]={{ESP_GATT_AUTO_RSP},{ESP_UUID_LEN_16,(uint8_t*)&character_client_config_uuid,ESP_GATT_PERM_READ|ESP_GATT_PERM_WRITE,2,2,(uint8_t*)ccc_value}},
-                [IDX_CHAR_UPLOAD]={{ESP_GATT_AUTO_RSP},{ESP_UUID_LEN_16,(uint8_t*)&character_declaration_uuid,ESP_GATT_PERM_READ,1,1,(uint8_t*)&char_prop_write}},
+                [IDX_CHAR_UPLOAD]={{ESP_GATT_AUTO_RSP},{ESP_UUID_LEN_16,(uint8_t*)&character_declaration_uuid,ESP_GATT_PERM_READ,1,1,(uint8_t*)&char_prop_upload}}, // Without response: the credit paces it
                 [IDX_CHAR_VAL_UPLOAD]={{ESP_GATT_AUTO_RSP},{ESP_UUID_LEN_128,(uint8_t*)char_upload_uuid,ESP_GATT_PERM_WRITE,512,0,NULL}},
+                [IDX_CHAR_STREAM]={{ESP_GATT_AUTO_RSP},{ESP_UUID_LEN_16,(uint8_t*)&character_declaration_uuid,ESP_GATT_PERM_READ,1,1,(uint8_t*)&char_prop_read_notify}},
+                [IDX_CHAR_VAL_STREAM]={{ESP_GATT_AUTO_RSP},{ESP_UUID_LEN_128,(uint8_t*)char_stream_uuid,ESP_GATT_PERM_READ,512,0,NULL}},
+                [IDX_CHAR_CFG_STREAM]={{ESP_GATT_AUTO_RSP},{ESP_UUID_LEN_16,(uint8_t*)&character_client_config_uuid,ESP_GATT_PERM_READ|ESP_GATT_PERM_WRITE,2,2,(uint8_t*)ccc_value}},
             };
             esp_ble_gatts_create_attr_tab(gatt_db, gatts_if, HRS_IDX_NB, 0); break;
         }
         case ESP_GATTS_CREAT_ATTR_TAB_EVT: memcpy(echo_handle_table, param->add_attr_tab.handles, sizeof(echo_handle_table)); esp_ble_gatts_start_service(echo_handle_table[IDX_SVC]); break;
         case ESP_GATTS_CONNECT_EVT: {
-            conn_id=param->connect.conn_id; device_connected=true; sys_led_state = LED_BT_PAIRED;
+            conn_id=param->connect.conn_id; device_connected=true; if(command_mode) sys_led_state = LED_BT_PAIRED;
             esp_ble_conn_update_params_t conn_params={0}; memcpy(conn_params.bda, param->connect.remote_bda, sizeof(esp_bd_addr_t)); 
             conn_params.min_int=0x0C; conn_params.max_int=0x18; conn_params.latency=0; conn_params.timeout=400;
-            esp_ble_gap_update_conn_params(&conn_params); esp_ble_gatt_set_local_mtu(517); break;
+            esp_ble_gap_update_conn_params(&conn_params); esp_ble_gatt_set_local_mtu(517);
+            memcpy(peer_bda, param->connect.remote_bda, sizeof(esp_bd_addr_t)); request_link(); break;
         }
+        case ESP_GATTS_MTU_EVT: ble_mtu = param->mtu.mtu; break;
+        case ESP_GATTS_CONGEST_EVT: ble_congested = param->congest.congested; if(!ble_congested) wake_cmd_task(); break;
         case ESP_GATTS_DISCONNECT_EVT:
-            device_connected=false; is_downloading=false; sys_led_state = LED_BT_DISCONNECTING;
-            if(transfer_file) { fclose(transfer_file); transfer_file=NULL; }
+            device_connected=false; is_downloading=false; dl_from_log=false; ble_congested=false; ble_mtu=23; phy_tx=phy_rx=1; dle_tx=dle_rx=27; live_stream_set_subscribed(false); if(command_mode) sys_led_state = LED_BT_DISCONNECTING;
+            is_uploading=false; wake_cmd_task(); // The command task closes the open transfer; the BTC task never waits on the storage service
             esp_ble_gap_start_advertising(&(esp_ble_adv_params_t){.adv_int_min=0x20, .adv_int_max=0x40, .adv_type=ADV_TYPE_IND, .own_addr_type=BLE_ADDR_TYPE_PUBLIC, .channel_map=ADV_CHNL_ALL, .adv_filter_policy=ADV_FILTER_ALLOW_SCAN_ANY_CON_ANY}); break;
         case ESP_GATTS_WRITE_EVT:
-            if(param->write.handle==echo_handle_table[IDX_CHAR_VAL_CMD]) { int len=(param->write.len<sizeof(pending_cmd)-1)?param->write.len:sizeof(pending_cmd)-1; memcpy(pending_cmd, param->write.value, len); pending_cmd[len]=0; cmd_ready=true; }
-            else if(param->write.handle==echo_handle_table[IDX_CHAR_VAL_UPLOAD]) { if(is_uploading && up_queue) { up_chunk_t chk; chk.len = param->write.len; memcpy(chk.data, param->write.value, chk.len); xQueueSendFromISR(up_queue, &chk, NULL); } }
+            if(param->write.handle==echo_handle_table[IDX_CHAR_VAL_CMD] && !command_mode) { char c[32]; int len=(param->write.len<sizeof(c)-1)?param->write.len:sizeof(c)-1; memcpy(c, param->write.value, len); c[len]=0; live_stream_handle_cmd(c); }
+            else if(param->write.handle==echo_handle_table[IDX_CHAR_VAL_CMD] && param->write.len == XFER_ACK_LEN && param->write.value[0] == XFER_ACK_MAGIC) { if(is_downloading && ack_queue) xQueueSend(ack_queue, param->write.value, 0); }
+            else if(param->write.handle==echo_handle_table[IDX_CHAR_VAL_CMD] && param->write.len >= CMD_REQ_HDR_LEN && param->write.value[0] == CMD_REQ_MAGIC) {
+                cmd_req_t r = { .id = param->write.value[1] | param->write.value[2] << 8, .op = param->write.value[3], .bin = true }; uint8_t busy[CMD_RSP_HDR_LEN];
+                int len = param->write.len - CMD_REQ_HDR_LEN < CMD_ARG_LEN - 1 ? param->write.len - CMD_REQ_HDR_LEN : CMD_ARG_LEN - 1; memcpy(r.arg, param->write.value + CMD_REQ_HDR_LEN, len); r.arg[len] = 0;
+                if(!req_queue || xQueueSend(req_queue, &r, 0) != pdTRUE) notify_raw(busy, rsp_header(busy, &r, CMD_ST_BUSY)); // Never waits in the BTC task
+            }
+            else if(param->write.handle==echo_handle_table[IDX_CHAR_VAL_CMD]) { // Text command: parsed by the command task; queued, so a second write never overwrites the first
+                cmd_req_t r = { .bin = false }; int len = param->write.len < CMD_ARG_LEN - 1 ? param->write.len : CMD_ARG_LEN - 1; memcpy(r.arg, param->write.value, len); r.arg[len] = 0;
+                if(!req_queue || xQueueSend(req_queue, &r, 0) != pdTRUE) notify_raw((const uint8_t*)"BUSY", 4);
+            }
+            else if(param->write.handle==echo_handle_table[IDX_CHAR_CFG_STREAM] && param->write.len == 2) { live_stream_set_subscribed(param->write.value[0] & 0x01); }
+            else if(param->write.handle==echo_handle_table[IDX_CHAR_VAL_UPLOAD]) { if(is_uploading && up_accept(param->write.value, param->write.len)) wake_cmd_task(); } // Woken per block, not per write
+            if(param->write.handle != echo_handle_table[IDX_CHAR_VAL_UPLOAD]) wake_cmd_task();
             if(param->write.need_rsp) { esp_ble_gatts_send_response(gatts_if, param->write.conn_id, param->write.trans_id, ESP_GATT_OK, NULL); } break;
         default: break;
     }
 }
 
 /* ==================== 4.0 Command Processing Task ==================== */
+// Names from the app are relative to the card root and may carry directories (rec/YYYY/MM/DD/...); ".." is refused
+static bool resolve_path(const char *name, char *out, size_t len) {
+    while(*name == '/') name++;
+    if(strstr(name, "..")) return false;
+    return snprintf(out, len, "%s/%s", MOUNT_POINT, name) < (int)len;
+}
+
+
+// Sends "path|size" for one listing line, holding off while the link is congested instead of a fixed per-line sleep
+static void send_list_line(const char *line, int len) { send_blocking((const uint8_t*)line, len); }
+
+// Served from idx.dat: one sequential read of the catalog, no readdir and no per-file stat(). Each record is its own
+// storage request, so a recording write never waits behind a whole listing.
+typedef struct { int i; catalog_rec_t r; } cat_get_t;
+static int cat_get_job(void *arg) { cat_get_t *g = arg; return catalog_get(g->i, &g->r) ? 0 : -1; }
+
+static void list_catalog(char *line, size_t len) {
+    cat_get_t g;
+    for(g.i = 0; g.i < catalog_count(); g.i++) if(!storage_call(cat_get_job, &g, STORAGE_VOL_FAT, STORAGE_PRIO_TRANSFER)) { int n = snprintf(line, len, "%s|%lu", g.r.path, (unsigned long)g.r.size); send_list_line(line, n); }
+}
+
+// Without a catalog (or for ls <dir>) the tree is walked the same way: one file per storage request, with the open
+// directory handles kept in the walk between requests. Day directories stay small, so the per-file stat() is cheap.
+#define LIST_DEPTH 4
+typedef struct { DIR *dir[LIST_DEPTH + 1]; size_t base[LIST_DEPTH + 1]; int depth; char path[CMD_PATH_LEN]; long size; } dir_walk_t;
+
+static int dir_open_job(void *arg) { dir_walk_t *w = arg; w->depth = 0; w->base[0] = strlen(w->path); return (w->dir[0] = opendir(w->path)) ? 0 : -1; }
+
+// Leaves the next regular file in w->path and w->size, or returns -1 once every directory has been closed
+static int dir_next_job(void *arg) {
+    dir_walk_t *w = arg; struct dirent *entry; struct stat st;
+    while(w->depth >= 0) {
+        size_t base = w->base[w->depth]; w->path[base] = 0;
+        if(!(entry = readdir(w->dir[w->depth]))) { closedir(w->dir[w->depth--]); continue; }
+        if(entry->d_name[0] == '.' || snprintf(w->path + base, sizeof(w->path) - base, "/%s", entry->d_name) >= (int)(sizeof(w->path) - base)) continue;
+        if(entry->d_type == DT_DIR && w->depth < LIST_DEPTH) { DIR *d = opendir(w->path); if(d) { w->dir[++w->depth] = d; w->base[w->depth] = strlen(w->path); } }
+        else if(entry->d_type == DT_REG && !stat(w->path, &st)) { w->size = st.st_size; return 0; }
+    }
+    return -1;
+}
+
+// Sends "relative/path|size" per file under root
+static void list_dir(const char *root, char *line, size_t len) {
+    dir_walk_t w; snprintf(w.path, sizeof(w.path), "%s", root);
+    if(storage_call(dir_open_job, &w, STORAGE_VOL_FAT, STORAGE_PRIO_TRANSFER)) return;
+    while(!storage_call(dir_next_job, &w, STORAGE_VOL_FAT, STORAGE_PRIO_TRANSFER)) { int n = snprintf(line, len, "%s|%ld", w.path + strlen(MOUNT_POINT) + 1, w.size); send_list_line(line, n); }
+}
+
+// lsb [cursor [max [since [prefix]]]]: the listing packed for BLE. Each notification is "LSB" + count, then per entry u32
+// size, u32 start time (Unix s), u8 catalog flags, u8 bytes shared with the previous name in the same notification, u8
+// length of the rest and the rest, so a day directory's path goes once per packet. Positions are the catalog in
+// recording order, then the log store; cursor is where to start, max caps the entries (0 = all), since skips
+// recordings that started earlier and prefix keeps names that begin with it. Ends "LSQ|entries|next|positions|ms",
+// next being the cursor to continue from, or 0 once the listing is complete.
+typedef struct { uint32_t cursor, left, since, total; const char *prefix; uint8_t *buf; size_t room, len; int n; } lsb_page_t;
+static int lsb_job(void *arg) { // Packs one notification
+    lsb_page_t *p = arg; logstore_t *log = logstore_sd_get(); uint32_t cat = catalog_count(); catalog_rec_t r;
+    char prev[CATALOG_PATH_LEN] = "", name[CATALOG_PATH_LEN]; size_t plen = strlen(p->prefix);
+    p->total = cat + (log ? log->count : 0); memcpy(p->buf, "LSB", 3); p->len = LSB_HDR; p->n = 0;
+    for(int scanned = 0; p->cursor < p->total && p->left && scanned < LSB_SCAN; scanned++) {
+        uint32_t size, t; uint8_t flags;
+        if(p->cursor < cat) { if(!catalog_get(p->cursor, &r)) { p->cursor++; continue; } snprintf(name, sizeof(name), "%s", r.path); size = r.size; t = r.start_time; flags = r.flags; }
+        else { const logstore_entry_t *e = &log->entries[p->cursor - cat]; logstore_sd_entry_name(e, name, sizeof(name)); size = logstore_export_size(e); t = e->meta.start_time; flags = e->closed ? 0 : CAT_FLAG_PARTIAL; }
+        if(t < p->since || strncmp(name, p->prefix, plen)) { p->cursor++; continue; }
+        size_t nl = strlen(name), keep = 0;
+        while(prev[keep] && prev[keep] == name[keep]) keep++;
+        if(p->len + LSB_ENTRY + nl - keep > p->room) break; // Starts the next notification
+        uint8_t *o = p->buf + p->len; memcpy(o, &size, 4); memcpy(o + 4, &t, 4); o[8] = flags; o[9] = keep; o[10] = nl - keep; memcpy(o + LSB_ENTRY, name + keep, nl - keep);
+        p->len += LSB_ENTRY + nl - keep; p->n++; p->left--; p->cursor++; memcpy(prev, name, nl + 1);
+    }
+    p->buf[3] = p->n; return 0;
+}
+
+// Removes the day/month/year directories a delete has left empty; rmdir simply fails on the first non-empty one
+static void prune_empty_dirs(char *path) {
+    char *slash;
+    while((slash = strrchr(path, '/')) && (size_t)(slash - path) > strlen(MOUNT_POINT "/rec")) { *slash = 0; if(rmdir(path)) break; }
+}
+
+// Log entries follow the FAT files in the same "name|size" form, sized as the exported WAV
+static void list_log_entries(char *line, size_t len) {
+    logstore_t *log = logstore_sd_get(); if(!log) return;
+    for(int i = 0; i < log->count; i++) { int n = logstore_sd_entry_name(&log->entries[i], line, len); n += snprintf(line + n, len - n, "|%lu", (unsigned long)logstore_export_size(&log->entries[i])); send_list_line(line, n); }
+}
+
+// Storage-task jobs for the commands below: each one is a single queued request at transfer priority, so a
+// listing, delete or bench sees a consistent volume and never races the recording writer for the card
+static int ls_job(void *rebuild) { if(*(bool *)rebuild) catalog_rebuild(); return catalog_load(); }
+static int cat_remove_job(void *path) { return catalog_remove(path); }
+static int upload_done_job(void *arg) { retention_note_write(xfer_off, false); return catalog_add_file(up_path, 0); }
+typedef struct { const logstore_entry_t *e; uint32_t off; void *buf; uint32_t len; } log_rd_t;
+static int log_read_job(void *arg) { log_rd_t *r = arg; logstore_t *log = logstore_sd_get(); return log ? logstore_export_read(log, r->e, r->off, r->buf, r->len) : 0; }
+static int size_job(void *path) { struct stat st; return stat(path, &st) ? -1 : (int)st.st_size; }
+static int log_del_job(void *id) { logstore_t *log = logstore_sd_get(); return log ? logstore_delete(log, *(uint32_t *)id) : -1; }
+static int df_job(void *line) { return retention_stats(line, 96); }
+static int sdclk_job(void *arg) { if(storage_card()) sd_clock_apply(storage_card(), true); return 0; }
+
+// Benches run as many short storage jobs rather than one long one, so transfers and listings keep being served
+// while they run. Each step's reply lines are sent from here once the storage task has handed the bench back.
+static void run_bench(sd_bench_kind_t kind, int files) {
+    sd_bench_t b; int more; sd_bench_begin(&b, kind, storage_card(), MOUNT_POINT, files);
+    do {
+        more = storage_call(sd_bench_step, &b, STORAGE_VOL_FAT, STORAGE_PRIO_TRANSFER) > 0;
+        for(int i = 0; i < b.lines; i++) send_list_line(b.line[i], strlen(b.line[i]));
+        b.lines = 0;
+    } while(more);
+}
+
+static int del_job(void *arg) {
+    char *path = arg; struct stat st;
+    if(stat(path, &st) || remove(path)) return -1;
+    retention_note_delete(st.st_size, !strncmp(path, MOUNT_POINT "/rec/", strlen(MOUNT_POINT "/rec/"))); catalog_remove(path + strlen(MOUNT_POINT) + 1); prune_empty_dirs(path);
+    return 0;
+}
+
+// meta <file>: reads only the header (and an .elc footer) and replies "META" + u32 file size + u32 audio bytes + wav_meta_t (little-endian),
+// so a client can show time, place, trigger and settings for a recording without fetching its audio
+typedef struct { const char *path; uint8_t *out; } meta_req_t;
+static int meta_job(void *arg) {
+    meta_req_t *q = arg; struct stat st; uint8_t h[WAV_META_HDR_SIZE]; wav_meta_t m; uint32_t off, len; FILE *f;
+    if(stat(q->path, &st) || !(f = fopen(q->path, "rb"))) return -1;
+    size_t n = fread(h, 1, sizeof(h), f); fclose(f);
+    uint32_t size = st.st_size; int64_t end_us;
+    if(wav_meta_parse(h, n, &m, &off, &len) >= 0 && off && off <= size) { if(!len || len > size - off) len = size - off; } // Placeholder size on a clip cut by power loss
+    else if(elc_describe(q->path, &m, &end_us) >= 0) len = end_us > 0 ? (uint64_t)end_us * m.sample_rate * m.channels * 2 / 1000000 : 0; // .elc: audio length from the footer
+    else return -1;
+    memcpy(q->out, "META", 4); memcpy(q->out + 4, &size, 4); memcpy(q->out + 8, &len, 4); memcpy(q->out + 12, &m, sizeof(m));
+    return 12 + sizeof(m);
+}
+
+typedef struct { const char *path; bool lock; } lock_req_t;
+static int lock_job(void *arg) {
+    lock_req_t *q = arg;
+    if(retention_set_lock(q->path, q->lock)) return -1;
+    catalog_set_flags(q->path, q->lock ? CAT_FLAG_LOCKED : 0, q->lock ? 0 : CAT_FLAG_LOCKED); return 0;
+}
+
+// ts <raw|min|hour> <from> <to> [hex series mask]: UTC seconds, to = 0 for no end. Each notification is "TSD" + count
+// + packed points (telemetry.h), one storage request per page; then "TSQ|points|ms" with the time the query took.
+static int ts_query_cmd(const char *args) {
+    uint8_t buf[TRANSFER_BLOCK_SIZE]; char lv[8] = "", line[48]; unsigned long from = 0, to = 0, mask = 0xFFFF; tsdb_cursor_t cur = {0}; uint32_t total = 0; int n; int64_t t0 = esp_timer_get_time();
+    int level = (sscanf(args, "%7s %lu %lu %lx", lv, &from, &to, &mask) < 1) ? -1 : !strcmp(lv, "raw") ? TSDB_RAW : !strcmp(lv, "min") ? TSDB_MIN : !strcmp(lv, "hour") ? TSDB_HOUR : -1;
+    size_t room = reply_room() - 4;
+    if(level < 0) { send_notification((uint8_t*)"TSQ|ERR", 7); return -1; }
+    while(device_connected && (n = telemetry_query(level, from, to ? to : UINT32_MAX, mask, &cur, buf + 4, room / TELEMETRY_WIRE_POINT)) > 0) {
+        memcpy(buf, "TSD", 3); buf[3] = n; send_list_line((const char *)buf, 4 + n * TELEMETRY_WIRE_POINT); total += n;
+    }
+    n = snprintf(line, sizeof(line), "TSQ|%lu|%lu", (unsigned long)total, (unsigned long)((esp_timer_get_time() - t0) / 1000)); send_notification((uint8_t*)line, n);
+    return 0;
+}
+
+// "get <file> [offset [len [lz]]]" and "upload <file> [offset total]": cuts the numbers off the name; missing ones read as 0
+static void split_args(char *name, uint32_t *a, uint32_t *b) {
+    char *sp = strchr(name, ' '); *a = *b = 0;
+    if(sp) { *sp = 0; sscanf(sp + 1, "%" SCNu32 " %" SCNu32, a, b); }
+}
+
+// Both get forms: the range is clamped to the file and fixed up front so the END frame can carry its end and CRC.
+// A resumed get starts at the client's offset once "sum" has confirmed the bytes before it match.
+// A compressed get (lz) only compresses when the read-ahead window could be allocated; the frames say which it got.
+static void start_download(uint32_t size, uint32_t off, uint32_t len, bool lz) {
+    if(off > size) off = size;
+    if(!len || len > size - off) len = size - off;
+    xfer_tx_begin(&dl_tx, off, off + len, xfer_block() - XFER_HDR_LEN, lz && lz_win ? XFER_LZ_SPAN : 0, esp_timer_get_time() / 1000); xQueueReset(ack_queue);
+    is_downloading = true; dl_t0 = esp_timer_get_time(); dl_bytes = 0; dl_wakeups = 0; dl_lz_us = 0; lz_win_len = 0;
+}
+
+static int dl_read(uint32_t off, void *buf, uint32_t len) {
+    if(dl_from_log) { log_rd_t r = { &dl_entry, off, buf, len }; return storage_call(log_read_job, &r, STORAGE_VOL_LOG, STORAGE_PRIO_TRANSFER); }
+    return storage_read_at(xfer_fd, off, buf, len, STORAGE_PRIO_TRANSFER);
+}
+
+// Serves a frame's bytes out of the window, refilling it from off when they are not all there; a compressed frame
+// consumes only part of its span, so the next one mostly finds its bytes already read. NULL if the card failed.
+static const uint8_t *dl_span(uint32_t off, uint32_t len) {
+    if(off < lz_win_off || off + len > lz_win_off + lz_win_len) {
+        uint32_t want = dl_tx.total - off < LZ_WIN_SIZE ? dl_tx.total - off : LZ_WIN_SIZE; int n = dl_read(off, lz_win, want);
+        lz_win_off = off; lz_win_len = n > 0 ? n : 0; if(n != (int)want) return NULL;
+    }
+    return lz_win + (off - lz_win_off);
+}
+
+// upload <file> <offset> <total> continues a partial file only when offset is exactly what is on the card (the client
+// checked that prefix with "sum"); anything else starts over. The offset actually used goes back in "READY|<offset>".
+static int start_upload(const char *path, uint32_t *off) {
+    int size = *off ? storage_call(size_job, (void *)path, STORAGE_VOL_FAT, STORAGE_PRIO_TRANSFER) : -1;
+    if(size >= 0 && (uint32_t)size == *off) return storage_open(path, "r+b", STORAGE_PRIO_TRANSFER);
+    *off = 0; storage_delete(path, STORAGE_PRIO_TRANSFER); return storage_open(path, "wb", STORAGE_PRIO_TRANSFER);
+}
+
+// Credit: "CRD|<offset>|<largest write>". The client may write up to offset, which is what is on the card plus the
+// whole pool, so it can never overrun it; a new grant goes out as each block is written. Sent before the client waits
+// on it, so no timer is needed for a lost grant.
+static void up_credit(void) {
+    char line[32];
+    if(is_uploading && !up_stop) send_blocking((uint8_t*)line, snprintf(line, sizeof(line), "CRD|%lu|%u", (unsigned long)(xfer_off + up_blocks * UP_BLOCK_SIZE), (unsigned)xfer_block()));
+}
+
+static void up_reset(uint32_t off) {
+    xQueueReset(up_free); xQueueReset(up_full); up_fill = NULL;
+    for(int i = 0; i < up_blocks; i++) { up_pool[i]->len = 0; xQueueSend(up_free, &up_pool[i], 0); }
+    up_stop = up_sd_err = false; up_start = off; up_writes = 0; up_t0 = esp_timer_get_time();
+}
+
+// One storage request per block; after a failed write the rest are discarded so nothing lands past the gap
+static void up_flush(up_block_t *b) {
+    if(!up_sd_err && storage_append(xfer_fd, b->data, b->len, STORAGE_PRIO_TRANSFER) == (int)b->len) { xfer_off += b->len; up_writes++; }
+    else up_sd_err = up_stop = true;
+    b->len = 0; xQueueSend(up_free, &b, 0); up_credit();
+}
+
+// Writes what is still pooled, the part-filled block last. Only called once is_uploading is false, so the GATTS
+// handler no longer touches up_fill.
+static void up_drain(void) {
+    up_block_t *b;
+    while(xQueueReceive(up_full, &b, 0)) up_flush(b);
+    if(up_fill && up_fill->len) up_flush(up_fill);
+    up_fill = NULL;
+}
+
+// sum <file> [len]: CRC-32 of the first len bytes (the whole file by default), one SUM_BLOCK per storage request so a
+// long file never holds the card. Replies "SUM|size|bytes covered|crc" (crc in hex) or "SUM|ERR".
+static int sum_cmd(char *args) {
+    uint32_t want, unused, crc = 0, off = 0; int size = -1, fd = -1; char line[48], path[CMD_PATH_LEN]; logstore_entry_t e; uint8_t *buf = malloc(SUM_BLOCK);
+    split_args(args, &want, &unused);
+    bool from_log = !strncmp(args, LOGSTORE_PREFIX, strlen(LOGSTORE_PREFIX));
+    if(from_log) { logstore_t *log = logstore_sd_get(); const logstore_entry_t *f = log ? logstore_find(log, strtoul(args + strlen(LOGSTORE_PREFIX), NULL, 10)) : NULL; if(f) { e = *f; size = logstore_export_size(f); } }
+    else if(resolve_path(args, path, CMD_PATH_LEN) && (size = storage_call(size_job, path, STORAGE_VOL_FAT, STORAGE_PRIO_TRANSFER)) >= 0 && (fd = storage_open(path, "rb", STORAGE_PRIO_TRANSFER)) < 0) size = -1;
+    if(size >= 0 && (!want || want > (uint32_t)size)) want = size;
+    while(size >= 0 && off < want) {
+        uint32_t len = want - off < SUM_BLOCK ? want - off : SUM_BLOCK; log_rd_t r = { &e, off, buf, len };
+        int n = !buf ? -1 : from_log ? storage_call(log_read_job, &r, STORAGE_VOL_LOG, STORAGE_PRIO_TRANSFER) : storage_read_at(fd, off, buf, len, STORAGE_PRIO_TRANSFER);
+        if(n != (int)len) { size = -1; break; }
+        crc = crc32_update(crc, buf, len); off += len;
+    }
+    free(buf); if(fd >= 0) storage_close(fd, STORAGE_PRIO_TRANSFER);
+    if(size < 0) { send_notification((uint8_t*)"SUM|ERR", 7); return -1; }
+    send_notification((uint8_t*)line, snprintf(line, sizeof(line), "SUM|%d|%lu|%08lx", size, (unsigned long)want, (unsigned long)crc)); return 0;
+}
+
+// Command handlers: arg is the text after the command name (also the argument text of a binary request). Each returns
+// how the request ended; the text form sends "EOF" after DONE or FAIL, and a get or upload that started never does.
+enum { CMD_DONE, CMD_FAIL, CMD_STARTED, CMD_REFUSED };
+
+static int list_all(bool rebuild) {
+    char path[CMD_PATH_LEN];
+    if(!storage_call(ls_job, &rebuild, STORAGE_VOL_FAT, STORAGE_PRIO_TRANSFER)) list_catalog(path, sizeof(path));
+    else list_dir(MOUNT_POINT, path, sizeof(path));
+    list_log_entries(path, sizeof(path)); return CMD_DONE;
+}
+static int cmd_ls(char *arg) {
+    char path[CMD_PATH_LEN], line[CMD_PATH_LEN + 16]; if(!*arg) return list_all(false);
+    if(!resolve_path(arg, path, sizeof(path))) return CMD_FAIL;
+    list_dir(path, line, sizeof(line)); return CMD_DONE;
+}
+static int cmd_ls_rebuild(char *arg) { return list_all(true); }
+
+static int cmd_lsb(char *arg) {
+    uint8_t buf[TRANSFER_BLOCK_SIZE]; char pfx[CATALOG_PATH_LEN] = "", line[64]; unsigned long cur = 0, max = 0, since = 0; bool rebuild = false; int64_t t0 = esp_timer_get_time();
+    lsb_page_t p = { .prefix = pfx, .buf = buf, .room = reply_room() }; uint32_t want;
+    if(p.room < LSB_HDR + LSB_ENTRY + CATALOG_PATH_LEN) { send_notification((uint8_t*)"LSQ|ERR", 7); return CMD_FAIL; } // MTU too small for a full name: use "ls"
+    sscanf(arg, "%lu %lu %lu %87s", &cur, &max, &since, pfx); p.cursor = cur; p.left = want = max ? max : UINT32_MAX; p.since = since;
+    storage_call(ls_job, &rebuild, STORAGE_VOL_FAT, STORAGE_PRIO_TRANSFER); // No catalog (no card) still lists the log store
+    do {
+        if(storage_call(lsb_job, &p, STORAGE_VOL_FAT, STORAGE_PRIO_TRANSFER)) break;
+        if(p.n) send_blocking(buf, p.len);
+    } while(device_connected && p.left && p.cursor < p.total);
+    send_notification((uint8_t*)line, snprintf(line, sizeof(line), "LSQ|%lu|%lu|%lu|%lu", (unsigned long)(want - p.left), (unsigned long)(p.cursor < p.total ? p.cursor : 0), (unsigned long)p.total, (unsigned long)((esp_timer_get_time() - t0) / 1000)));
+    return CMD_DONE;
+}
+
+static int cmd_get(char *arg) {
+    const char *opt = strrchr(arg, ' '); bool lz = opt && !strcmp(opt + 1, "lz");
+    uint32_t off, len; char path[CMD_PATH_LEN]; split_args(arg, &off, &len); dl_len = 0;
+    if(is_uploading) return CMD_FAIL; // xfer_fd is the upload's: the pooled blocks still to flush would land in the get's file
+    if(!strncmp(arg, LOGSTORE_PREFIX, strlen(LOGSTORE_PREFIX))) {
+        logstore_t *log = logstore_sd_get(); const logstore_entry_t *e = log ? logstore_find(log, strtoul(arg + strlen(LOGSTORE_PREFIX), NULL, 10)) : NULL;
+        if(!e) return CMD_FAIL;
+        dl_entry = *e; dl_from_log = true; start_download(logstore_export_size(e), off, len, lz); return CMD_STARTED;
+    }
+    if(xfer_fd >= 0) storage_close(xfer_fd, STORAGE_PRIO_TRANSFER);
+    dl_from_log = false; // A get that replaces an @log/ download reads the file, not the old entry
+    int size = resolve_path(arg, path, sizeof(path)) ? storage_call(size_job, path, STORAGE_VOL_FAT, STORAGE_PRIO_TRANSFER) : -1;
+    xfer_fd = size >= 0 ? storage_open(path, "rb", STORAGE_PRIO_TRANSFER) : -1;
+    if(xfer_fd < 0) { storage_call(cat_remove_job, arg, STORAGE_VOL_FAT, STORAGE_PRIO_TRANSFER); return CMD_FAIL; } // Stale entry: drop it
+    start_download(size, off, len, lz); return CMD_STARTED;
+}
+
+static int cmd_upload(char *arg) {
+    uint32_t off; char path[CMD_PATH_LEN], line[24]; split_args(arg, &off, &up_total); is_uploading = false;
+    if(xfer_fd >= 0) { storage_close(xfer_fd, STORAGE_PRIO_TRANSFER); xfer_fd = -1; }
+    snprintf(up_path, sizeof(up_path), "%s", arg);
+    if(up_blocks && resolve_path(arg, path, sizeof(path))) xfer_fd = start_upload(path, &off); // No pool: refused like a card fault
+    if(xfer_fd < 0) { send_notification((uint8_t*)"ERROR", 5); return CMD_REFUSED; }
+    xfer_off = off; up_reset(off); is_uploading = true;
+    send_notification((uint8_t*)line, snprintf(line, sizeof(line), "READY|%lu", (unsigned long)off)); up_credit(); return CMD_STARTED;
+}
+
+static int cmd_end_upload(char *arg) {
+    char line[64]; int st = CMD_DONE; is_uploading = false;
+    if(xfer_fd >= 0) {
+        up_drain(); storage_close(xfer_fd, STORAGE_PRIO_TRANSFER); xfer_fd = -1;
+        uint32_t ms = (esp_timer_get_time() - up_t0) / 1000, n = xfer_off - up_start;
+        if((!up_total && !up_stop) || xfer_off == up_total) {
+            storage_call(upload_done_job, NULL, STORAGE_VOL_FAT, STORAGE_PRIO_TRANSFER);
+            send_notification((uint8_t*)line, snprintf(line, sizeof(line), "UP|OK|%lu|%lu|%lu|%lu", (unsigned long)n, (unsigned long)ms, (unsigned long)(ms ? (uint64_t)n * 1000 / 1024 / ms : 0), (unsigned long)up_writes));
+        }
+        else { send_notification((uint8_t*)line, snprintf(line, sizeof(line), "UP|SHORT|%lu", (unsigned long)xfer_off)); st = CMD_FAIL; } // A short file stays uncatalogued until a resumed upload completes it
+    }
+    return st;
+}
+
+static int cmd_sum(char *arg) { return sum_cmd(arg) ? CMD_FAIL : CMD_DONE; }
+
+static int cmd_del(char *arg) {
+    char path[CMD_PATH_LEN];
+    if(!strncmp(arg, LOGSTORE_PREFIX, strlen(LOGSTORE_PREFIX))) { uint32_t id = strtoul(arg + strlen(LOGSTORE_PREFIX), NULL, 10); return storage_call(log_del_job, &id, STORAGE_VOL_LOG, STORAGE_PRIO_TRANSFER) ? CMD_FAIL : CMD_DONE; }
+    return resolve_path(arg, path, sizeof(path)) && !storage_call(del_job, path, STORAGE_VOL_FAT, STORAGE_PRIO_TRANSFER) ? CMD_DONE : CMD_FAIL;
+}
+
+static int cmd_meta(char *arg) {
+    char path[CMD_PATH_LEN]; uint8_t out[12 + sizeof(wav_meta_t)]; meta_req_t q = { path, out };
+    int n = resolve_path(arg, path, sizeof(path)) ? storage_call(meta_job, &q, STORAGE_VOL_FAT, STORAGE_PRIO_TRANSFER) : -1;
+    if(n <= 0) { send_notification((uint8_t*)"META|ERR", 8); return CMD_FAIL; }
+    send_notification(out, n); return CMD_DONE;
+}
+
+static int set_lock(char *arg, bool lock) {
+    lock_req_t q = { arg, lock }; bool err = storage_call(lock_job, &q, STORAGE_VOL_FAT, STORAGE_PRIO_TRANSFER) != 0; const char *r = err ? "LOCK|ERR" : "LOCK|OK";
+    send_notification((uint8_t*)r, strlen(r)); return err ? CMD_FAIL : CMD_DONE;
+}
+static int cmd_lock(char *arg) { return set_lock(arg, true); }
+static int cmd_unlock(char *arg) { return set_lock(arg, false); }
+
+static int cmd_cfg_rec(char *arg) { device_config_t cfg; load_config(&cfg); sscanf(arg, "%hu %hu", &cfg.record_length_sec, &cfg.record_max_sec); save_config(&cfg); return CMD_DONE; }
+static int cmd_cfg_acc(char *arg) { device_config_t cfg; load_config(&cfg); sscanf(arg, "%hu %hu %hu %hu", &cfg.accel_act_thresh, &cfg.accel_act_time, &cfg.accel_inact_thresh, &cfg.accel_inact_time); save_config(&cfg); return CMD_DONE; }
+static int cmd_cfg_mic(char *arg) {
+    device_config_t cfg; load_config(&cfg); int m = atoi(arg);
+    if(m < MIC_MODE_LEFT || m > MIC_MODE_STEREO) return CMD_FAIL;
+    cfg.mic_mode = m; save_config(&cfg); return CMD_DONE;
+}
+static int cmd_cfg_live(char *arg) { device_config_t cfg; load_config(&cfg); cfg.live_stream = atoi(arg) ? 1 : 0; save_config(&cfg); return CMD_DONE; }
+static int cmd_cfg_store(char *arg) { device_config_t cfg; load_config(&cfg); int b = atoi(arg); cfg.storage_backend = (b == STORAGE_LOG || b == STORAGE_ELC) ? b : STORAGE_FAT; save_config(&cfg); return CMD_DONE; }
+static int cmd_cfg_ret(char *arg) { device_config_t cfg; load_config(&cfg); sscanf(arg, "%hu %" SCNu32, &cfg.reserve_mb, &cfg.quota_mb); save_config(&cfg); return CMD_DONE; }
+static int cmd_cfg_stage(char *arg) { device_config_t cfg; load_config(&cfg); int n = atoi(arg); cfg.stage_flush_sec = (n < 0) ? 0 : (n > 60) ? 60 : n; save_config(&cfg); return CMD_DONE; }
+
+static int cmd_time(char *arg) {
+    int y, m, d, hh, mm, ss;
+    if(sscanf(arg, "%d %d %d %d %d %d", &y, &m, &d, &hh, &mm, &ss) != 6) { send_notification((uint8_t*)"TIME_ERR", 8); return CMD_FAIL; }
+    rtc_set_time_manual(y, m, d, hh, mm, ss); send_notification((uint8_t*)"SET:OK", 6); return CMD_DONE;
+}
+
+static int cmd_df(char *arg) { char line[96]; int n = storage_call(df_job, line, STORAGE_VOL_FAT, STORAGE_PRIO_TRANSFER); if(n > 0) send_notification((uint8_t*)line, n); return n > 0 ? CMD_DONE : CMD_FAIL; }
+static int cmd_stage(char *arg) { char line[128]; send_notification((uint8_t*)line, stage_stats(line, sizeof(line))); return CMD_DONE; }
+static int cmd_stor(char *arg) { char line[96]; send_notification((uint8_t*)line, storage_stats(line, sizeof(line))); return CMD_DONE; }
+static int cmd_ts(char *arg) {
+    char line[96]; if(strcmp(arg, "stat")) return ts_query_cmd(arg) ? CMD_FAIL : CMD_DONE;
+    send_notification((uint8_t*)line, telemetry_stats(line, sizeof(line))); return CMD_DONE;
+}
+static int cmd_link(char *arg) {
+    char line[128];
+    if(!*arg) send_notification((uint8_t*)line, link_stats(line, sizeof(line)));
+    else if(!strcmp(arg, "1m") || !strcmp(arg, "2m")) { link_fast = arg[0] == '2'; request_link(); }
+    else if(!strcmp(arg, "sleep") || !strcmp(arg, "event")) pace_sleep = arg[0] == 's';
+    else return CMD_FAIL;
+    return CMD_DONE;
+}
+static int cmd_sdclk(char *arg) { char line[64]; send_notification((uint8_t*)line, sd_clock_status(line, sizeof(line))); return CMD_DONE; }
+static int cmd_usbmsc(char *arg) { send_notification((uint8_t*)"USB|RESTART", 11); usb_restart = true; return CMD_DONE; } // Next boot exposes the card over USB
+
+// Long commands, run on the job task so downloads and other requests keep moving meanwhile
+static int cmd_selftest(char *arg) { send_notification((uint8_t*)"TEST_START", 10); run_self_test(); return CMD_DONE; }
+static int cmd_lsbench(char *arg) { run_bench(SD_BENCH_LOG_VS_FAT, 0); return CMD_DONE; }
+static int cmd_sdbench(char *arg) { run_bench(SD_BENCH_PROFILE, 0); return CMD_DONE; }
+static int cmd_fsbench(char *arg) { run_bench(SD_BENCH_FS, *arg ? atoi(arg) : 1000); return CMD_DONE; }
+static int cmd_sdclk_train(char *arg) { storage_call(sdclk_job, NULL, STORAGE_VOL_FAT, STORAGE_PRIO_TRANSFER); return cmd_sdclk(arg); }
+
+#define CMD_F_ARGS 0x01 // The text form takes arguments after a space
+#define CMD_F_JOB  0x02 // Runs on the job task
+typedef struct { uint8_t op, flags; const char *name; int (*fn)(char *arg); } cmd_def_t;
+static const cmd_def_t cmd_table[] = {
+    { CMD_OP_LS, CMD_F_ARGS, "ls", cmd_ls }, { CMD_OP_LS_REBUILD, 0, "ls_rebuild", cmd_ls_rebuild }, { CMD_OP_LSB, CMD_F_ARGS, "lsb", cmd_lsb }, { CMD_OP_GET, CMD_F_ARGS, "get", cmd_get },
+    { CMD_OP_UPLOAD, CMD_F_ARGS, "upload", cmd_upload }, { CMD_OP_END_UPLOAD, 0, "end_upload", cmd_end_upload }, { CMD_OP_SUM, CMD_F_ARGS, "sum", cmd_sum },
+    { CMD_OP_DEL, CMD_F_ARGS, "del", cmd_del }, { CMD_OP_META, CMD_F_ARGS, "meta", cmd_meta }, { CMD_OP_LOCK, CMD_F_ARGS, "lock", cmd_lock }, { CMD_OP_UNLOCK, CMD_F_ARGS, "unlock", cmd_unlock },
+    { CMD_OP_CFG_REC, CMD_F_ARGS, "cfg_rec", cmd_cfg_rec }, { CMD_OP_CFG_ACC, CMD_F_ARGS, "cfg_acc", cmd_cfg_acc }, { CMD_OP_CFG_MIC, CMD_F_ARGS, "cfg_mic", cmd_cfg_mic },
+    { CMD_OP_CFG_LIVE, CMD_F_ARGS, "cfg_live", cmd_cfg_live }, { CMD_OP_CFG_STORE, CMD_F_ARGS, "cfg_store", cmd_cfg_store }, { CMD_OP_CFG_RET, CMD_F_ARGS, "cfg_ret", cmd_cfg_ret },
+    { CMD_OP_CFG_STAGE, CMD_F_ARGS, "cfg_stage", cmd_cfg_stage }, { CMD_OP_TIME, CMD_F_ARGS, "time", cmd_time },
+    { CMD_OP_DF, 0, "df", cmd_df }, { CMD_OP_STAGE, 0, "stage", cmd_stage }, { CMD_OP_STOR, 0, "stor", cmd_stor }, { CMD_OP_TS, CMD_F_ARGS, "ts", cmd_ts },
+    { CMD_OP_LINK, CMD_F_ARGS, "link", cmd_link }, { CMD_OP_SDCLK, 0, "sdclk", cmd_sdclk },
+    { CMD_OP_SELFTEST, CMD_F_JOB, "selftest", cmd_selftest }, { CMD_OP_LSBENCH, CMD_F_JOB, "lsbench", cmd_lsbench }, { CMD_OP_FSBENCH, CMD_F_ARGS | CMD_F_JOB, "fsbench", cmd_fsbench },
+    { CMD_OP_SDBENCH, CMD_F_JOB, "sdbench", cmd_sdbench }, { CMD_OP_SDCLK_TRAIN, CMD_F_JOB, "sdclk_train", cmd_sdclk_train }, { CMD_OP_USBMSC, 0, "usbmsc", cmd_usbmsc },
+};
+#define CMD_COUNT (sizeof(cmd_table) / sizeof(cmd_table[0]))
+
+static const cmd_def_t *cmd_find(uint8_t op) { for(size_t i = 0; i < CMD_COUNT; i++) if(cmd_table[i].op == op) return &cmd_table[i]; return NULL; }
+
+// The text commands are kept as a shim over the same table: "name" or "name args" becomes the request a binary client sends
+// (the whole line arrives in arg and is cut down to the arguments in place)
+static bool cmd_from_text(cmd_req_t *r) {
+    for(size_t i = 0; i < CMD_COUNT; i++) {
+        const cmd_def_t *d = &cmd_table[i]; size_t n = strlen(d->name);
+        if(strncmp(r->arg, d->name, n) || (r->arg[n] && (r->arg[n] != ' ' || !(d->flags & CMD_F_ARGS)))) continue;
+        char *args = r->arg + n + (r->arg[n] ? 1 : 0); r->id = 0; r->op = d->op; memmove(r->arg, args, strlen(args) + 1); return true;
+    }
+    return false;
+}
+
+// Closes a request the way its client expects: "EOF" for text, an OK or ERR response for binary
+static void cmd_end(const cmd_req_t *r, int st) {
+    if(r->bin) send_status(r, (st == CMD_DONE || st == CMD_STARTED) ? CMD_ST_OK : CMD_ST_ERR, NULL, 0);
+    else if(st == CMD_DONE || st == CMD_FAIL) send_eof();
+}
+
+static void cmd_dispatch(cmd_req_t *r) {
+    const cmd_def_t *d = cmd_find(r->op);
+    if(!d) { if(r->bin) send_status(r, CMD_ST_UNKNOWN, NULL, 0); return; }
+    if((d->flags & CMD_F_JOB) && r->bin) { // One job runs and one more may wait; beyond that BUSY rather than minutes in a queue
+        send_status(r, xQueueSend(job_queue, r, 0) == pdTRUE ? CMD_ST_ACCEPTED : CMD_ST_BUSY, NULL, 0); return;
+    } // A text client reads the reply stream in order, so its long commands still run inline
+    cmd_ctx = r; cmd_end(r, d->fn(r->arg)); cmd_ctx = NULL;
+}
+
+static void job_task_fn(void *arg) {
+    cmd_req_t r;
+    for(;;) { // Runs until op 0, the shutdown kick: the queue holds one entry, so a job left waiting would keep it out
+        if(xQueueReceive(job_queue, &r, portMAX_DELAY) != pdTRUE) continue;
+        if(!r.op) break;
+        if(get_system_mode() != MODE_BLUETOOTH) continue; // Queued behind the job that was running at the switch: dropped
+        job_id = r.id; job_t0 = job_prog_us = esp_timer_get_time(); job_bin = r.bin; job_ctx = &r;
+        int st = cmd_find(r.op)->fn(r.arg);
+        job_bin = false; cmd_end(&r, st); job_ctx = NULL;
+    }
+    job_task = NULL; vTaskDelete(NULL);
+}
+
+// Sent from the command task so a binary client sees a long job is alive: PROGRESS + u32 milliseconds elapsed
+static void job_progress(void) {
+    int64_t now = esp_timer_get_time();
+    if(!job_bin || now - job_prog_us < CMD_PROGRESS_MS * 1000LL || ble_congested) return;
+    cmd_req_t r = { .id = job_id, .bin = true }; uint8_t buf[CMD_RSP_HDR_LEN + 4]; uint32_t ms = (now - job_t0) / 1000; size_t n = rsp_header(buf, &r, CMD_ST_PROGRESS);
+    memcpy(buf + n, &ms, 4); notify_raw(buf, n + 4); job_prog_us = now;
+}
+
 void process_command_task(void *pvParameters) {
-    uint8_t *fileBuf = malloc(TRANSFER_BLOCK_SIZE); char filepath[300]; int dl_len = 0; up_chunk_t chk;
+    cmd_task = xTaskGetCurrentTaskHandle(); uint8_t *fileBuf = malloc(TRANSFER_BLOCK_SIZE); up_block_t *blk; cmd_req_t req;
+    xTaskCreate(job_task_fn, "bt_job", 4096*2, NULL, 4, &job_task);
     
     while(get_system_mode() == MODE_BLUETOOTH) {
-        if(cmd_ready) {
-            if(!strcmp(pending_cmd, "ls")) { DIR *dir = opendir(MOUNT_POINT); if(dir) { struct dirent *entry; while((entry=readdir(dir))) { if(entry->d_type==DT_REG) { snprintf(filepath, sizeof(filepath), "%s/%s", MOUNT_POINT, entry->d_name); struct stat st; if(!stat(filepath, &st)) { char line[300]; int len=snprintf(line, sizeof(line), "%s|%ld", entry->d_name, st.st_size); send_notification((uint8_t*)line, len); vTaskDelay(pdMS_TO_TICKS(20)); } } } closedir(dir); } send_eof(); }
-            else if(!strncmp(pending_cmd, "get ", 4)) { char *fname = pending_cmd+4; snprintf(filepath, sizeof(filepath), "%s/%s", MOUNT_POINT, (fname[0]=='/')?fname+1:fname); if(transfer_file) { fclose(transfer_file); } transfer_file = fopen(filepath, "rb"); if(transfer_file) { is_downloading = true; dl_len = 0; } else { send_eof(); } }
-            else if(!strncmp(pending_cmd, "upload ", 7)) { char *fname = pending_cmd+7; snprintf(filepath, sizeof(filepath), "%s/%s", MOUNT_POINT, (fname[0]=='/')?fname+1:fname); if(transfer_file) { fclose(transfer_file); } remove(filepath); transfer_file = fopen(filepath, "wb"); if(transfer_file) { is_uploading = true; xQueueReset(up_queue); send_notification((uint8_t*)"READY", 5); } else { send_notification((uint8_t*)"ERROR", 5); } }
-            else if(!strcmp(pending_cmd, "end_upload")) { if(transfer_file) { fclose(transfer_file); transfer_file = NULL; } is_uploading = false; send_eof(); }
-            else if(!strncmp(pending_cmd, "del ", 4)) { char *fname = pending_cmd+4; snprintf(filepath, sizeof(filepath), "%s/%s", MOUNT_POINT, (fname[0]=='/')?fname+1:fname); remove(filepath); send_eof(); }
-            else if(!strncmp(pending_cmd, "cfg_rec ", 8)) { device_config_t cfg; load_config(&cfg); cfg.record_length_sec = atoi(pending_cmd+8); save_config(&cfg); send_eof(); }
-            else if(!strncmp(pending_cmd, "cfg_acc ", 8)) { device_config_t cfg; load_config(&cfg); sscanf(pending_cmd+8, "%hu %hu %hu %hu", &cfg.accel_act_thresh, &cfg.accel_act_time, &cfg.accel_inact_thresh, &cfg.accel_inact_time); save_config(&cfg); send_eof(); }
-            else if(!strncmp(pending_cmd, "time ", 5)) { int y, m, d, hh, mm, ss; if(sscanf(pending_cmd+5, "%d %d %d %d %d %d", &y, &m, &d, &hh, &mm, &ss)==6) { rtc_set_time_manual(y, m, d, hh, mm, ss); send_notification((uint8_t*)"SET:OK", 6); } else { send_notification((uint8_t*)"TIME_ERR", 8); } send_eof(); }
-            else if(!strcmp(pending_cmd, "selftest")) { send_notification((uint8_t*)"TEST_START", 10); run_self_test(); send_eof(); }
-            cmd_ready = false;
-        }
+        if(xQueueReceive(req_queue, &req, 0) && (req.bin || cmd_from_text(&req))) cmd_dispatch(&req); // One per pass, so a burst of commands never stalls a transfer
+        if(usb_restart) { usb_msc_request(); vTaskDelay(pdMS_TO_TICKS(500)); telemetry_close(); storage_stop(); esp_restart(); }
+        job_progress();
         
-        if(is_uploading && transfer_file && xQueueReceive(up_queue, &chk, 0)) { 
-            fwrite(chk.data, 1, chk.len, transfer_file); 
-        }
-        else if(is_downloading && device_connected && transfer_file) {
-            if(dl_len == 0) dl_len = fread(fileBuf, 1, TRANSFER_BLOCK_SIZE, transfer_file);
-            
-            if(dl_len > 0) {
-                esp_err_t err = send_notification(fileBuf, dl_len);
-                if(err == ESP_OK) {
-                    dl_len = 0; 
-                    vTaskDelay(pdMS_TO_TICKS(4)); 
-                } else {
-                    vTaskDelay(pdMS_TO_TICKS(20)); 
+        if(xfer_fd >= 0 && !is_uploading && !is_downloading) { up_drain(); storage_close(xfer_fd, STORAGE_PRIO_TRANSFER); xfer_fd = -1; } // Link dropped mid-transfer: keep what arrived for a resume
+        if(is_uploading && xfer_fd >= 0 && xQueueReceive(up_full, &blk, 0)) up_flush(blk);
+        else if(is_downloading && device_connected && (xfer_fd >= 0 || dl_from_log)) {
+            uint32_t now = esp_timer_get_time() / 1000; uint8_t ack[XFER_ACK_LEN];
+            while(xQueueReceive(ack_queue, ack, 0)) xfer_tx_ack(&dl_tx, ack, now);
+            if(xfer_tx_done(&dl_tx) || xfer_tx_stalled(&dl_tx, now) || dl_len < 0) { // Complete, abandoned by the client, or the card failed
+                if(xfer_fd >= 0) { storage_close(xfer_fd, STORAGE_PRIO_TRANSFER); xfer_fd = -1; } dl_from_log = false; is_downloading = false;
+                last_dl_bytes = dl_bytes; last_dl_ms = (esp_timer_get_time() - dl_t0) / 1000; last_dl_retx = dl_tx.retx; last_dl_wakeups = dl_wakeups; dl_len = 0;
+                last_dl_lz_us = dl_lz_us; last_dl_lz_raw = dl_tx.lz_raw; last_dl_lz_wire = dl_tx.lz_wire;
+            }
+            else if(dl_len == 0 && !xfer_tx_poll(&dl_tx, now, &dl_hdr)) { if(pace_sleep) pace_delay(10); else wait_event(xfer_tx_wait_ms(&dl_tx, now)); } // Window full: until an ACK or the next resend is due
+            else {
+                if(dl_len == 0) { // Payloads are re-read at their offset, so a retransmission costs a card read rather than a buffer per frame
+                    int n = dl_hdr.len; uint8_t *payload = fileBuf + XFER_HDR_LEN; dl_src = payload; dl_raw = dl_hdr.len;
+                    if(!(dl_hdr.flags & XFER_F_END) && dl_tx.span) { // Compressed get: every data frame is cut from the window
+                        if(!(dl_src = dl_span(dl_hdr.offset, dl_hdr.len))) n = -1;
+                        else if(dl_hdr.flags & XFER_F_LZ) { int64_t t0 = esp_timer_get_time(); dl_raw = xfer_lz_fill(&dl_tx, &dl_hdr, dl_src, payload); n = dl_hdr.len; dl_lz_us += esp_timer_get_time() - t0; }
+                        else memcpy(payload, dl_src, n);
+                    }
+                    else if(!(dl_hdr.flags & XFER_F_END)) n = dl_read(dl_hdr.offset, payload, dl_hdr.len);
+                    if(n == dl_hdr.len) { xfer_pack(&dl_tx, &dl_hdr, fileBuf); dl_len = XFER_HDR_LEN + n; } else dl_len = -1;
+                }
+                if(dl_len > 0 && !pace_sleep && ble_congested) wait_event(100); // Buffers full: the congestion-cleared event wakes us
+                else if(dl_len > 0) {
+                    esp_err_t err = notify_raw(fileBuf, dl_len);
+                    if(err == ESP_OK) {
+                        if(!(dl_hdr.flags & (XFER_F_END | XFER_F_RETX))) dl_bytes += dl_raw;
+                        xfer_tx_sent(&dl_tx, &dl_hdr, dl_src, dl_raw, now); dl_len = 0;
+                        if(pace_sleep) pace_delay(4); // No sleep at all otherwise: the next frame goes straight into the free buffer
+                    } else if(pace_sleep) {
+                        pace_delay(20); 
+                    } else wait_event(20);
                 }
-            } else { 
-                fclose(transfer_file); transfer_file = NULL; is_downloading = false; send_eof(); 
             }
-        } else { 
-            vTaskDelay(pdMS_TO_TICKS(10)); 
+        } else if(!uxQueueMessagesWaiting(req_queue)) { // Idle: no timer at all, only a write, congestion change, disconnect or shutdown wakes the task
+            ulTaskNotifyTake(pdTRUE, job_bin ? pdMS_TO_TICKS(CMD_PROGRESS_MS) : portMAX_DELAY); idle_wakeups++;
         }
     }
     
-    free(fileBuf); vTaskDelete(NULL); 
+    cmd_task = NULL; free(fileBuf); vTaskDelete(NULL); 
 }
 
 /* ==================== 5.0 Bluetooth Setup & Main ==================== */
+// Brings up the controller and GATT server once per boot; both modes end in esp_restart() so it is never torn down
+void ble_server_start(bool cmd_mode) {
+    command_mode = cmd_mode; if(ble_started) return; ble_started = true;
+    esp_bt_controller_config_t bt_cfg=BT_CONTROLLER_INIT_CONFIG_DEFAULT(); esp_bt_controller_init(&bt_cfg); esp_bt_controller_enable(ESP_BT_MODE_BLE); esp_bluedroid_init(); esp_bluedroid_enable();
+    esp_ble_gatts_register_callback(gatts_event_handler); esp_ble_gap_register_callback(gap_event_handler); esp_ble_gatts_app_register(0);
+}
+
 void bluetooth_mode_main() {
     gps_force_sleep();
-    park_cs_pins(); 
-    gpio_set_pull_mode(SPI_PIN_NUM_MISO, GPIO_PULLUP_ONLY); gpio_set_pull_mode(SPI_PIN_NUM_MOSI, GPIO_PULLUP_ONLY); gpio_set_pull_mode(SPI_PIN_NUM_CLK, GPIO_PULLUP_ONLY);
-    
-    if(!up_queue) up_queue = xQueueCreate(20, sizeof(up_chunk_t));
+    if(!up_free) { up_free = xQueueCreate(UP_POOL_BLOCKS, sizeof(up_block_t *)); up_full = xQueueCreate(UP_POOL_BLOCKS, sizeof(up_block_t *)); }
+    for(; up_blocks < UP_POOL_BLOCKS; up_blocks++) { // PSRAM when fitted; fewer blocks only shrink the credit window
+        up_block_t *b = heap_caps_malloc(sizeof(up_block_t), MALLOC_CAP_SPIRAM);
+        if(!b && !(b = heap_caps_malloc(sizeof(up_block_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT))) break;
+        up_pool[up_blocks] = b;
+    }
+    if(!lz_win && !(lz_win = heap_caps_malloc(LZ_WIN_SIZE, MALLOC_CAP_SPIRAM))) lz_win = heap_caps_malloc(LZ_WIN_SIZE, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT); // None: gets stay plain
+    if(!ack_queue) ack_queue = xQueueCreate(8, XFER_ACK_LEN);
+    if(!req_queue) req_queue = xQueueCreate(CMD_MAX_PENDING, sizeof(cmd_req_t));
+    if(!job_queue) job_queue = xQueueCreate(1, sizeof(cmd_req_t));
 
-    esp_vfs_fat_sdmmc_mount_config_t mount_config = {.format_if_mount_failed=false, .max_files=5, .allocation_unit_size=16*1024};
-    sdmmc_host_t host = SDSPI_HOST_DEFAULT(); host.slot = SPI2_HOST; host.max_freq_khz = 20000;
-    spi_bus_config_t bus_cfg = {.mosi_io_num=SPI_PIN_NUM_MOSI, .miso_io_num=SPI_PIN_NUM_MISO, .sclk_io_num=SPI_PIN_NUM_CLK, .quadwp_io_num=-1, .quadhd_io_num=-1, .max_transfer_sz=4000};
-    spi_bus_initialize(host.slot, &bus_cfg, SPI_DMA_CH_AUTO);
-    sdspi_device_config_t slot_config = SDSPI_DEVICE_CONFIG_DEFAULT(); slot_config.gpio_cs=SD_PIN_NUM_CS; slot_config.host_id=host.slot;
-    esp_vfs_fat_sdspi_mount(MOUNT_POINT, &host, &slot_config, &mount_config, &card);
+    storage_start(); storage_mount(); // A missing card still leaves config, time and self test usable
 
-    esp_bt_controller_config_t bt_cfg=BT_CONTROLLER_INIT_CONFIG_DEFAULT(); esp_bt_controller_init(&bt_cfg); esp_bt_controller_enable(ESP_BT_MODE_BLE); esp_bluedroid_init(); esp_bluedroid_enable();
-    esp_ble_gatts_register_callback(gatts_event_handler); esp_ble_gap_register_callback(gap_event_handler); esp_ble_gatts_app_register(0);
+    ble_server_start(true);
 
     xTaskCreate(process_command_task, "bt_sd", 4096*2, NULL, 5, NULL);
 
     while(get_system_mode() == MODE_BLUETOOTH) { vTaskDelay(pdMS_TO_TICKS(250)); } 
+    wake_cmd_task(); if(job_queue) xQueueSend(job_queue, &(cmd_req_t){ .op = 0 }, portMAX_DELAY); // Both tasks block without a timeout
 
     if(device_connected) { esp_ble_gatts_close(gatts_if_handle, conn_id); }
     vTaskDelay(pdMS_TO_TICKS(500)); 
-    if(transfer_file) { fclose(transfer_file); transfer_file = NULL; }
-    if(card) { esp_vfs_fat_sdcard_unmount(MOUNT_POINT, card); card = NULL; }
-    if(up_queue) { vQueueDelete(up_queue); up_queue = NULL; }
+    while(job_task || cmd_task) vTaskDelay(pdMS_TO_TICKS(50)); // A running self test or bench finishes before the card and queues go
+    telemetry_close(); storage_stop(); xfer_fd = -1; // Closes any transfer the command task left open
+    if(up_free) { vQueueDelete(up_free); vQueueDelete(up_full); up_free = up_full = NULL; }
+    while(up_blocks) heap_caps_free(up_pool[--up_blocks]);
+    if(lz_win) { heap_caps_free(lz_win); lz_win = NULL; }
+    if(ack_queue) { vQueueDelete(ack_queue); ack_queue = NULL; }
+    if(req_queue) { vQueueDelete(req_queue); req_queue = NULL; }
+    if(job_queue) { vQueueDelete(job_queue); job_queue = NULL; }
     
     return;
-}
\ No newline at end of file
+}
@@ -28,8 +28,17 @@
 /* ==================== 1.0 Includes & Definitions ==================== */
 #ifndef BLUETOOTH_MODE_H
 #define BLUETOOTH_MODE_H
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
 
 /* ==================== 2.0 Function Prototypes ==================== */
 void bluetooth_mode_main(void);
+void ble_server_start(bool cmd_mode);
+esp_err_t send_notification(uint8_t *data, size_t len);
+esp_err_t send_stream_notification(uint8_t *data, size_t len);
+uint16_t ble_get_mtu(void);
+bool ble_is_congested(void);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,223 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Append-Only Recording Catalog (idx.dat) */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Variables
+   2.0 Record I/O
+   3.0 Appends
+   4.0 Load & Replay
+   5.0 Rebuild from Directory Scan
+   6.0 Queries
+========================================*/
+
+/* ==================== 1.0 Includes & Variables ==================== */
+#include <stdio.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/unistd.h>
+#include "esp_log.h"
+#include "crc32.h"
+#include "catalog.h"
+#include "wav_meta.h"
+#include "elc_writer.h"
+
+#define MOUNT_POINT "/sdcard"
+#define CATALOG_FILE MOUNT_POINT "/idx.dat"
+#define CATALOG_TMP MOUNT_POINT "/idx.tmp"
+#define CAT_MAGIC 0x31524345 // "ECR1"
+#define CAT_REC_SIZE sizeof(catalog_rec_t)
+
+typedef struct { uint32_t hash, rec_no; uint8_t flags; } cat_live_t;
+
+static const char *TAG = "CATALOG";
+static cat_live_t *live = NULL; static int live_count = 0, live_cap = 0;
+static bool loaded = false, rebuilding = false; // rebuilding: a bad record in the fresh catalog is cut, not rebuilt again
+static FILE *rd = NULL; // Kept open across catalog_get calls so ls is one sequential pass; closed before any append
+
+/* ==================== 2.0 Record I/O ==================== */
+static uint32_t path_hash(const char *p) { return crc32_update(0, p, strnlen(p, CATALOG_PATH_LEN)); }
+
+static bool rec_valid(const catalog_rec_t *r) { return r->magic == CAT_MAGIC && crc32_update(0, r, offsetof(catalog_rec_t, crc)) == r->crc; }
+
+// Opens the catalog at its last valid record, cutting off a record torn by a power cut. A missing catalog is left
+// missing: appends are skipped and the next load rebuilds it from the directory tree.
+static FILE *open_for_append(long *pos) {
+    FILE *f = fopen(CATALOG_FILE, "r+b"); if(!f) return NULL;
+    fseek(f, 0, SEEK_END); long end = ftell(f), keep = end - end % CAT_REC_SIZE; catalog_rec_t last;
+    if(keep >= (long)CAT_REC_SIZE && (fseek(f, keep - CAT_REC_SIZE, SEEK_SET) || fread(&last, CAT_REC_SIZE, 1, f) != 1 || !rec_valid(&last))) keep -= CAT_REC_SIZE;
+    if(keep != end) { fflush(f); ftruncate(fileno(f), keep); }
+    fseek(f, keep, SEEK_SET); *pos = keep; return f;
+}
+
+// Every append is flushed and synced on its own, so the file on the card is always a valid prefix plus at most one torn record
+static int append_rec(catalog_rec_t *r) {
+    r->magic = CAT_MAGIC; r->crc = crc32_update(0, r, offsetof(catalog_rec_t, crc));
+    if(rd) { fclose(rd); rd = NULL; }
+    long pos; FILE *f = open_for_append(&pos); if(!f) return -1; bool ok = fwrite(r, CAT_REC_SIZE, 1, f) == 1 && !fflush(f) && !fsync(fileno(f)); fclose(f);
+    if(!ok) return -1;
+    if(loaded) { // Keep the in-memory index in step with the file
+        uint32_t h = path_hash(r->path), no = pos / CAT_REC_SIZE; int i;
+        for(i = 0; i < live_count && live[i].hash != h; i++) {}
+        if(r->op == CAT_OP_ADD) {
+            if(i == live_count) { if(live_count == live_cap) { int cap = live_cap ? live_cap * 2 : 256; cat_live_t *n = realloc(live, cap * sizeof(*n)); if(!n) return 0; live = n; live_cap = cap; } live_count++; }
+            live[i] = (cat_live_t){ .hash = h, .rec_no = no, .flags = r->flags };
+        }
+        else if(r->op == CAT_OP_DEL && i < live_count) { memmove(&live[i], &live[i + 1], (--live_count - i) * sizeof(*live)); }
+        else if(r->op == CAT_OP_FLAGS && i < live_count) live[i].flags = r->flags;
+    }
+    return 0;
+}
+
+static void set_path(catalog_rec_t *r, const char *path) { while(*path == '/') path++; strncpy(r->path, path, CATALOG_PATH_LEN - 1); }
+
+/* ==================== 3.0 Appends ==================== */
+// Logged before a recording opens its file: a BEGIN with no matching ADD marks a clip cut short by power loss
+int catalog_begin(const char *path) { catalog_rec_t r = {0}; r.op = CAT_OP_BEGIN; set_path(&r, path); return append_rec(&r); }
+
+int catalog_add(catalog_rec_t *rec) { rec->op = CAT_OP_ADD; return append_rec(rec); }
+
+int catalog_remove(const char *path) { catalog_rec_t r = {0}; r.op = CAT_OP_DEL; set_path(&r, path); return append_rec(&r); }
+
+int catalog_set_flags(const char *path, uint8_t set, uint8_t clear) {
+    catalog_rec_t r = {0}, cur; r.op = CAT_OP_FLAGS; set_path(&r, path);
+    uint32_t h = path_hash(r.path);
+    for(int i = 0; i < live_count; i++) if(live[i].hash == h && catalog_get(i, &cur)) r.flags = cur.flags;
+    r.flags = (r.flags | set) & ~clear; return append_rec(&r);
+}
+
+// Start time and GPS come from the YYYYMMDD_HHMMSS_<lat>_<lon> name, so a rebuilt entry matches the original
+void catalog_fill_from_name(catalog_rec_t *rec, const char *path) {
+    const char *name = strrchr(path, '/'); name = name ? name + 1 : path;
+    struct tm ti = {0}; double lat, lon;
+    if(sscanf(name, "%4d%2d%2d_%2d%2d%2d", &ti.tm_year, &ti.tm_mon, &ti.tm_mday, &ti.tm_hour, &ti.tm_min, &ti.tm_sec) == 6) { ti.tm_year -= 1900; ti.tm_mon -= 1; rec->start_time = mktime(&ti); }
+    if(strlen(name) > 16 && sscanf(name + 16, "%lf_%lf", &lat, &lon) == 2) { rec->lat_e7 = (int32_t)(lat * 1e7); rec->lon_e7 = (int32_t)(lon * 1e7); }
+    else { rec->lat_e7 = CAT_NO_GPS; rec->lon_e7 = CAT_NO_GPS; }
+}
+
+// Format, rate and duration from the WAV header, and time and position from its elog chunk when there is one.
+// A clip cut by power loss still has the zero placeholder size written at open, so that falls back to the file size
+static void fill_from_file(catalog_rec_t *rec, const char *full, uint32_t size) {
+    rec->size = size; rec->format = CAT_FMT_OTHER; FILE *f = fopen(full, "rb"); uint8_t h[WAV_META_HDR_SIZE]; wav_meta_t m; uint32_t off, len;
+    size_t n = f ? fread(h, 1, sizeof(h), f) : 0; if(f) fclose(f);
+    int found = wav_meta_parse(h, n, &m, &off, &len); int64_t end_us;
+    if(found < 0 && (found = elc_describe(full, &m, &end_us)) >= 0) { // .elc: length from the footer, none on a clip cut by power loss
+        rec->format = CAT_FMT_ELC; rec->channels = m.channels; rec->sample_rate = m.sample_rate; rec->duration_ms = end_us > 0 ? end_us / 1000 : 0;
+        if(found && m.start_time) rec->start_time = m.start_time;
+        if(found && m.lat_e7 != CAT_NO_GPS) { rec->lat_e7 = m.lat_e7; rec->lon_e7 = m.lon_e7; }
+        return;
+    }
+    if(found < 0 || !off || off > size) return;
+    if(!len || len > size - off) len = size - off;
+    rec->format = CAT_FMT_WAV_PCM16; rec->channels = m.channels; rec->sample_rate = m.sample_rate; rec->duration_ms = (uint64_t)len * 1000 / (m.sample_rate * m.channels * 2);
+    if(found && m.start_time) rec->start_time = m.start_time;
+    if(found && m.lat_e7 != CAT_NO_GPS) { rec->lat_e7 = m.lat_e7; rec->lon_e7 = m.lon_e7; }
+}
+
+// Catalogs a file that was written without its metadata at hand (uploads, clips recovered after a power cut)
+int catalog_add_file(const char *path, uint8_t flags) {
+    char full[128]; struct stat st; catalog_rec_t r = {0}; set_path(&r, path); snprintf(full, sizeof(full), "%s/%s", MOUNT_POINT, r.path);
+    if(stat(full, &st)) return catalog_remove(r.path);
+    catalog_fill_from_name(&r, r.path); fill_from_file(&r, full, st.st_size); r.flags = flags; return catalog_add(&r);
+}
+
+/* ==================== 4.0 Load & Replay ==================== */
+// Replays idx.dat into the live index. A torn tail is cut off, and BEGINs left dangling by a power cut are closed
+// with an ADD from the file on the card (or a DEL if it never got created). Missing or unreadable: rebuild. So is a
+// bad record with whole records after it: a torn append only damages the last one, and cutting earlier would drop
+// every later file from the catalog.
+int catalog_load(void) {
+    if(loaded) return 0;
+    FILE *f = fopen(CATALOG_FILE, "rb"); if(!f) return catalog_rebuild();
+    catalog_rec_t r; uint32_t no = 0, pend[8]; char pend_path[8][CATALOG_PATH_LEN]; int npend = 0;
+    loaded = false; live_count = 0; bool bad = false, oom = false;
+    while(fread(&r, CAT_REC_SIZE, 1, f) == 1) {
+        if(!rec_valid(&r)) { bad = true; break; }
+        uint32_t h = path_hash(r.path); int i;
+        for(i = 0; i < live_count && live[i].hash != h; i++) {}
+        for(int p = 0; p < npend; p++) if(pend[p] == h && r.op != CAT_OP_BEGIN) { pend[p] = pend[--npend]; memcpy(pend_path[p], pend_path[npend], CATALOG_PATH_LEN); break; }
+        if(r.op == CAT_OP_BEGIN && npend < 8) { pend[npend] = h; memcpy(pend_path[npend++], r.path, CATALOG_PATH_LEN); }
+        else if(r.op == CAT_OP_ADD) {
+            if(i == live_count) { if(live_count == live_cap) { int cap = live_cap ? live_cap * 2 : 256; cat_live_t *n = realloc(live, cap * sizeof(*n)); if(!n) { oom = true; break; } live = n; live_cap = cap; } live_count++; }
+            live[i] = (cat_live_t){ .hash = h, .rec_no = no, .flags = r.flags };
+        }
+        else if(r.op == CAT_OP_DEL && i < live_count) { memmove(&live[i], &live[i + 1], (--live_count - i) * sizeof(*live)); } // Keeps recording order for ls
+        else if(r.op == CAT_OP_FLAGS && i < live_count) live[i].flags = r.flags;
+        no++;
+    }
+    long size = fseek(f, 0, SEEK_END) ? -1 : ftell(f); fclose(f);
+    if(oom || size < 0) { catalog_unload(); return -1; }
+    if(bad && !rebuilding && size >= (long)(no + 2) * CAT_REC_SIZE) { ESP_LOGW(TAG, "Bad record %lu of %ld, rebuilding", (unsigned long)no, size / CAT_REC_SIZE); catalog_unload(); return catalog_rebuild(); }
+    if(size != (long)(no * CAT_REC_SIZE)) { ESP_LOGW(TAG, "Dropping torn tail after record %lu", (unsigned long)no); truncate(CATALOG_FILE, no * CAT_REC_SIZE); }
+    loaded = true;
+
+    for(int p = 0; p < npend; p++) catalog_add_file(pend_path[p], CAT_FLAG_PARTIAL);
+    ESP_LOGI(TAG, "%d entries from %lu records", live_count, (unsigned long)no);
+    return 0;
+}
+
+// For a card something else has written (a USB host): the next load rebuilds from the directory tree
+void catalog_invalidate(void) { catalog_unload(); remove(CATALOG_FILE); }
+
+void catalog_unload(void) { if(rd) { fclose(rd); rd = NULL; } free(live); live = NULL; live_count = live_cap = 0; loaded = false; }
+
+/* ==================== 5.0 Rebuild from Directory Scan ==================== */
+static void scan_dir(FILE *out, char *path, size_t len, int depth, uint32_t *n) {
+    DIR *dir = opendir(path); if(!dir) return;
+    size_t base = strlen(path); struct dirent *entry; struct stat st;
+    while((entry = readdir(dir))) {
+        if(entry->d_name[0] == '.' || (depth == 0 && (!strncmp(entry->d_name, "idx.", 4) || !strncmp(entry->d_name, "fsb_", 4) || !strcmp(entry->d_name, "System Volume Information")))) continue;
+        if(snprintf(path + base, len - base, "/%s", entry->d_name) >= (int)(len - base)) continue;
+        if(entry->d_type == DT_DIR && depth < 4) scan_dir(out, path, len, depth + 1, n);
+        else if(entry->d_type == DT_REG && !stat(path, &st) && strlen(path) - strlen(MOUNT_POINT) - 1 < CATALOG_PATH_LEN) {
+            catalog_rec_t r = {0}; r.op = CAT_OP_ADD; set_path(&r, path + strlen(MOUNT_POINT) + 1); catalog_fill_from_name(&r, r.path); fill_from_file(&r, path, st.st_size);
+            r.magic = CAT_MAGIC; r.crc = crc32_update(0, &r, offsetof(catalog_rec_t, crc)); if(fwrite(&r, CAT_REC_SIZE, 1, out) == 1) (*n)++;
+        }
+    }
+    path[base] = 0; closedir(dir);
+}
+
+// Writes a fresh catalog next to the old one and swaps it in. A crash before the swap leaves the old catalog; one
+// between the remove and the rename leaves none, which the next load treats as "rebuild" again.
+int catalog_rebuild(void) {
+    FILE *out = fopen(CATALOG_TMP, "wb"); if(!out) return -1;
+    char path[160] = MOUNT_POINT; uint32_t n = 0; scan_dir(out, path, sizeof(path), 0, &n);
+    bool ok = !fflush(out) && !fsync(fileno(out)); fclose(out);
+    if(!ok) { remove(CATALOG_TMP); return -1; }
+    remove(CATALOG_FILE); if(rename(CATALOG_TMP, CATALOG_FILE)) return -1;
+    ESP_LOGI(TAG, "Rebuilt with %lu files", (unsigned long)n);
+    catalog_unload(); rebuilding = true; int r = catalog_load(); rebuilding = false; return r;
+}
+
+/* ==================== 6.0 Queries ==================== */
+int catalog_count(void) { return loaded ? live_count : 0; }
+
+bool catalog_get(int i, catalog_rec_t *out) {
+    if(!loaded || i < 0 || i >= live_count) return false;
+    if(!rd && !(rd = fopen(CATALOG_FILE, "rb"))) return false;
+    bool ok = !fseek(rd, (long)live[i].rec_no * CAT_REC_SIZE, SEEK_SET) && fread(out, CAT_REC_SIZE, 1, rd) == 1 && rec_valid(out);
+    if(ok) out->flags = live[i].flags;
+    return ok;
+}
@@ -0,0 +1,70 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Append-Only Recording Catalog (idx.dat) Header */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Definitions
+   2.0 Structs
+   3.0 Prototypes
+========================================*/
+
+/* ==================== 1.0 Includes & Definitions ==================== */
+#ifndef CATALOG_H
+#define CATALOG_H
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CATALOG_PATH_LEN 88
+#define CAT_FLAG_LOCKED  0x01
+#define CAT_FLAG_PARTIAL 0x02 // Recovered after a power cut mid-recording
+#define CAT_NO_GPS INT32_MIN
+
+typedef enum { CAT_OP_BEGIN = 1, CAT_OP_ADD, CAT_OP_DEL, CAT_OP_FLAGS } catalog_op_t;
+typedef enum { CAT_FMT_OTHER, CAT_FMT_WAV_PCM16, CAT_FMT_ELC } catalog_fmt_t;
+
+/* ==================== 2.0 Structs ==================== */
+// One 128-byte record per operation, each with its own CRC, so a torn append only ever loses the last record
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint8_t op, format, channels, flags;
+    uint32_t size, duration_ms;
+    int64_t start_time;          // Unix seconds
+    int32_t lat_e7, lon_e7;      // Degrees * 1e7, CAT_NO_GPS without a fix
+    uint32_t sample_rate;
+    char path[CATALOG_PATH_LEN]; // Relative to the card root
+    uint32_t crc;
+} catalog_rec_t;
+
+/* ==================== 3.0 Prototypes ==================== */
+int catalog_begin(const char *path);
+int catalog_add(catalog_rec_t *rec);
+int catalog_add_file(const char *path, uint8_t flags);
+int catalog_remove(const char *path);
+int catalog_set_flags(const char *path, uint8_t set, uint8_t clear);
+void catalog_fill_from_name(catalog_rec_t *rec, const char *path);
+int catalog_load(void);
+void catalog_unload(void);
+void catalog_invalidate(void);
+int catalog_rebuild(void);
+int catalog_count(void);
+bool catalog_get(int i, catalog_rec_t *out);
+
+#endif
@@ -0,0 +1,55 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Binary Command Protocol Header */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Wire Format
+   2.0 Status Codes & Opcodes
+========================================*/
+
+/* ==================== 1.0 Includes & Wire Format ==================== */
+#ifndef CMD_PROTO_H
+#define CMD_PROTO_H
+#include <stdint.h>
+
+/* Requests are written to the command characteristic as magic, request id (LE16), opcode and then the same argument
+   text the plain command takes ("get rec/a.wav 4096" is opcode CMD_OP_GET with "rec/a.wav 4096"). Every reply is a
+   notification of magic, status, request id (LE16) and payload: DATA carries one reply line exactly as the text
+   command would send it, and OK or ERR closes the request where the text command sends "EOF". Requests are queued,
+   so several can be outstanding; the long ones run on a background task and report ACCEPTED, then PROGRESS. */
+#define CMD_REQ_MAGIC   0xC3
+#define CMD_RSP_MAGIC   0xC5
+#define CMD_REQ_HDR_LEN 4
+#define CMD_RSP_HDR_LEN 4
+#define CMD_ARG_LEN     124  // Argument text, NUL included
+#define CMD_MAX_PENDING 16   // Requests, text or binary, queued ahead of the command task
+
+/* ==================== 2.0 Status Codes & Opcodes ==================== */
+enum { CMD_ST_DATA = 0, CMD_ST_OK, CMD_ST_ERR, CMD_ST_BUSY, CMD_ST_UNKNOWN, CMD_ST_ACCEPTED, CMD_ST_PROGRESS };
+
+enum {
+    CMD_OP_LS = 0x01, CMD_OP_LS_REBUILD, CMD_OP_GET, CMD_OP_UPLOAD, CMD_OP_END_UPLOAD, CMD_OP_SUM, CMD_OP_DEL, CMD_OP_META, CMD_OP_LOCK, CMD_OP_UNLOCK, CMD_OP_LSB,
+    CMD_OP_CFG_REC = 0x20, CMD_OP_CFG_ACC, CMD_OP_CFG_MIC, CMD_OP_CFG_LIVE, CMD_OP_CFG_STORE, CMD_OP_CFG_RET, CMD_OP_CFG_STAGE, CMD_OP_TIME,
+    CMD_OP_DF = 0x40, CMD_OP_STAGE, CMD_OP_STOR, CMD_OP_TS, CMD_OP_LINK, CMD_OP_SDCLK,
+    CMD_OP_SELFTEST = 0x60, CMD_OP_LSBENCH, CMD_OP_FSBENCH, CMD_OP_SDBENCH, CMD_OP_SDCLK_TRAIN, CMD_OP_USBMSC
+};
+
+#endif
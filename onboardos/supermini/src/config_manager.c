@@ -36,10 +36,10 @@
 /* ==================== 2.0 Config Functions ==================== */
 void load_config(device_config_t *cfg) {
     nvs_handle_t my_handle; esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &my_handle);
-    cfg->accel_act_thresh = 1800; cfg->accel_act_time = 10; cfg->accel_inact_thresh = 1500; cfg->accel_inact_time = 10; cfg->record_length_sec = 30;
+    cfg->accel_act_thresh = 1800; cfg->accel_act_time = 10; cfg->accel_inact_thresh = 1500; cfg->accel_inact_time = 10; cfg->record_length_sec = 30; cfg->mic_mode = MIC_MODE_LEFT; cfg->record_max_sec = 600; cfg->live_stream = 0; cfg->storage_backend = STORAGE_FAT; cfg->reserve_mb = 64; cfg->quota_mb = 0; cfg->stage_flush_sec = 10;
     if(err == ESP_OK) {
         size_t required_size = 0; nvs_get_blob(my_handle, NVS_KEY, NULL, &required_size);
-        if(required_size == sizeof(device_config_t)) { nvs_get_blob(my_handle, NVS_KEY, cfg, &required_size); }
+        if(required_size > 0 && required_size <= sizeof(device_config_t)) { nvs_get_blob(my_handle, NVS_KEY, cfg, &required_size); }
         nvs_close(my_handle);
     }
 }
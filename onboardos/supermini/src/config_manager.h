@@ -32,12 +32,23 @@
 #include <stdint.h>
 
 /* ==================== 2.0 Structs ==================== */
+typedef enum { MIC_MODE_LEFT, MIC_MODE_RIGHT, MIC_MODE_SUM, MIC_MODE_STEREO } mic_mode_t;
+typedef enum { STORAGE_FAT, STORAGE_LOG, STORAGE_ELC } storage_backend_t; // ELC: FAT files in the multi-stream .elc container
+
+// New fields are appended only, so blobs saved by older firmware still load (see load_config)
 typedef struct {
     uint16_t accel_act_thresh;
     uint16_t accel_act_time;
     uint16_t accel_inact_thresh;
     uint16_t accel_inact_time;
     uint16_t record_length_sec;
+    uint8_t mic_mode;
+    uint16_t record_max_sec;     // Hard cap when activity keeps extending a clip; record_length_sec is the minimum
+    uint8_t live_stream;         // Run the BLE server in recording mode and stream ADPCM to a subscribed client
+    uint8_t storage_backend;     // STORAGE_LOG records into the raw log partition, falling back to FAT if the card has none
+    uint16_t reserve_mb;         // Free space kept on the FAT volume; the oldest unlocked recordings are evicted to hold it
+    uint32_t quota_mb;           // Cap on the rec/ tree, 0 for none
+    uint16_t stage_flush_sec;    // Audio staged in RAM between SD bursts; 0 writes each block straight through
 } device_config_t;
 
 /* ==================== 3.0 Prototypes ==================== */
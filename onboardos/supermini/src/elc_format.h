@@ -0,0 +1,113 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* EchoLog Multi-Stream Container (.elc) Format */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Definitions
+   2.0 File Layout
+   3.0 Stream Records
+========================================*/
+
+/* ==================== 1.0 Includes & Definitions ==================== */
+// Plain C99 with no ESP-IDF dependency: the host reader in tools/elc builds against this same header. Everything is
+// little-endian; the reader decodes by the *_LEN sizes below rather than through the packed structs.
+#ifndef ELC_FORMAT_H
+#define ELC_FORMAT_H
+#include <stdint.h>
+
+#if defined(__GNUC__)
+#define ELC_PACKED __attribute__((packed))
+#else
+#define ELC_PACKED
+#endif
+
+#define ELC_MAGIC "ELCF"
+#define ELC_FOOTER_MAGIC "ELCX"
+#define ELC_VERSION 1
+#define ELC_MAX_PAYLOAD 65535
+#define ELC_FILE_HDR_LEN 24
+#define ELC_CHUNK_HDR_LEN 16
+#define ELC_DECL_LEN 24
+#define ELC_INDEX_LEN 16
+#define ELC_FOOTER_LEN 28
+#define ELC_ACCEL_LEN 10
+#define ELC_GPS_LEN 12
+#define ELC_EVENT_LEN 4
+
+// Stream ids below 0xF0 are data streams declared in the file; the rest are reserved chunk types
+#define ELC_STREAM_DECL  0xF0 // Payload: elc_stream_decl_t
+#define ELC_STREAM_META  0xF1 // Payload: 4-char tag + block ("elog" = wav_meta_t, "tbas" = timebase anchors)
+#define ELC_STREAM_INDEX 0xFF // Payload: elc_index_t[], always the last chunk before the footer
+
+typedef enum { ELC_KIND_AUDIO = 1, ELC_KIND_ACCEL, ELC_KIND_GPS, ELC_KIND_EVENT } elc_kind_t;
+typedef enum { ELC_EV_START = 1, ELC_EV_STOP, ELC_EV_ROLLOVER, ELC_EV_CARD_FULL } elc_event_code_t;
+
+/* ==================== 2.0 File Layout ==================== */
+// File: elc_file_hdr_t, then chunks (declarations first, then data and meta chunks in the order they were written),
+// then the index chunk and elc_footer_t. A file cut by power loss has no footer; every chunk still carries its own
+// CRC, so a reader scans forward and stops at the first chunk that does not check out.
+typedef struct ELC_PACKED {
+    char magic[4];        // ELC_MAGIC
+    uint16_t version, hdr_len; // hdr_len = sizeof(elc_file_hdr_t), so readers can skip fields added later
+    int64_t start_utc_us; // Wall-clock time of t_us = 0
+    uint8_t device_id[6]; // Factory base MAC
+    uint16_t reserved;
+} elc_file_hdr_t;
+
+// 16 bytes per chunk. t_us is the time of the first record in the payload, relative to start_utc_us. Chunks of one
+// stream are in time order, but streams interleave loosely (audio reaches the card in bursts).
+typedef struct ELC_PACKED {
+    uint8_t stream, flags;
+    uint16_t len;         // Payload bytes
+    uint32_t crc;         // CRC-32 of the payload, then of this header with crc = 0
+    int64_t t_us;
+} elc_chunk_hdr_t;
+
+typedef struct ELC_PACKED {
+    uint8_t id, kind;     // kind: elc_kind_t
+    uint16_t channels;    // Audio channels, accel axes
+    uint32_t rate_hz;     // Nominal sample rate, 0 for irregular streams (GPS fixes, events)
+    uint16_t bits, record_size; // record_size 0 for variable-length records
+    char name[12];
+} elc_stream_decl_t;
+
+// Seek index: at least one entry per stream every few seconds, so random access by time reads one entry
+// table and then at most a few chunks. Sparser entries are dropped evenly if a long clip fills the table.
+typedef struct ELC_PACKED {
+    int64_t t_us;
+    uint32_t offset;      // File offset of the chunk header
+    uint8_t stream, reserved[3];
+} elc_index_t;
+
+typedef struct ELC_PACKED {
+    char magic[4];        // ELC_FOOTER_MAGIC
+    uint32_t index_offset, index_count, chunk_count;
+    int64_t end_us;       // End of the last record in any stream
+    uint32_t crc;         // CRC-32 of the preceding footer bytes
+} elc_footer_t;
+
+/* ==================== 3.0 Stream Records ==================== */
+// Audio payloads are interleaved PCM16 and carry no per-record header
+typedef struct ELC_PACKED { uint32_t dt_us; int16_t x, y, z; } elc_accel_t; // mg, dt_us after the chunk t_us
+typedef struct ELC_PACKED { int32_t lat_e7, lon_e7; uint8_t quality, sats; uint16_t hdop_x10; } elc_gps_t;
+typedef struct ELC_PACKED { uint16_t code, len; } elc_event_t; // Followed by len bytes of UTF-8 detail
+
+#endif
@@ -0,0 +1,176 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Multi-Stream Container Writer Implementation */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Variables
+   2.0 Chunk Writer (Storage Task)
+   3.0 Posted Chunks (Any Task)
+   4.0 Lifecycle
+   5.0 Header Probe
+========================================*/
+
+/* ==================== 1.0 Includes & Variables ==================== */
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/ringbuf.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_mac.h"
+#include "crc32.h"
+#include "catalog.h"
+#include "storage_service.h"
+#include "elc_writer.h"
+
+#define ELC_INDEX_MAX 512               // 8 KB of index; entries are thinned evenly once it fills
+#define ELC_INDEX_STEP_US 2000000LL     // Starting spacing of index entries per stream, doubled on each thinning
+#define ELC_POST_RING (16 * 1024)       // Side-stream chunks waiting for the next audio burst
+#define ELC_DATA_STREAMS 8
+
+_Static_assert(sizeof(elc_file_hdr_t) == ELC_FILE_HDR_LEN && sizeof(elc_chunk_hdr_t) == ELC_CHUNK_HDR_LEN && sizeof(elc_stream_decl_t) == ELC_DECL_LEN, "elc header sizes");
+_Static_assert(sizeof(elc_index_t) == ELC_INDEX_LEN && sizeof(elc_footer_t) == ELC_FOOTER_LEN && sizeof(elc_accel_t) == ELC_ACCEL_LEN && sizeof(elc_gps_t) == ELC_GPS_LEN, "elc record sizes");
+
+static const char *TAG = "ELC";
+// Writer state is only ever touched on the storage task (inside jobs), so chunks from the flush task and the
+// sensor task never interleave mid-chunk and need no lock of their own
+static int w_fd = -1; static bool w_ok = false; static uint32_t w_off = 0, w_chunks = 0, dropped = 0;
+static elc_index_t *idx = NULL; static int idx_n = 0; static int64_t idx_step = ELC_INDEX_STEP_US, idx_last[ELC_DATA_STREAMS];
+static RingbufHandle_t post_ring = NULL; static StaticRingbuffer_t post_ctl; static uint8_t *post_mem = NULL;
+
+/* ==================== 2.0 Chunk Writer (Storage Task) ==================== */
+static void note_index(uint8_t stream, int64_t t_us, uint32_t off) {
+    if(stream >= ELC_DATA_STREAMS || !idx || (idx_last[stream] != INT64_MIN && t_us - idx_last[stream] < idx_step)) return;
+    if(idx_n == ELC_INDEX_MAX) { for(int i = 0; i < ELC_INDEX_MAX / 2; i++) idx[i] = idx[i * 2]; idx_n = ELC_INDEX_MAX / 2; idx_step *= 2; }
+    idx[idx_n++] = (elc_index_t){ .t_us = t_us, .offset = off, .stream = stream }; idx_last[stream] = t_us;
+}
+
+// h arrives with stream, len (prefix included) and t_us filled in; the CRC covers the payload and then the header
+// with crc = 0. The prefix is the 4-byte tag of a meta chunk, so neither needs copying into one buffer first.
+static int put_chunk(elc_chunk_hdr_t *h, const void *pre, size_t pre_len, const void *buf) {
+    if(w_fd < 0 || !w_ok) return -1;
+    size_t len = h->len - pre_len; h->flags = 0; h->crc = 0; h->crc = crc32_update(crc32_update(crc32_update(0, pre, pre_len), buf, len), h, sizeof(*h));
+    if(storage_append(w_fd, h, sizeof(*h), STORAGE_PRIO_RECORD) != sizeof(*h) || (pre_len && storage_append(w_fd, pre, pre_len, STORAGE_PRIO_RECORD) != (int)pre_len) ||
+       (len && storage_append(w_fd, buf, len, STORAGE_PRIO_RECORD) != (int)len)) { w_ok = false; ESP_LOGW(TAG, "Append failed at %lu", (unsigned long)w_off); return -1; }
+    note_index(h->stream, h->t_us, w_off); w_off += sizeof(*h) + h->len; w_chunks++; return 0;
+}
+
+// Posted side-stream chunks go out ahead of whatever is written next, which keeps them near the audio of the same time
+static void drain_posted(void) {
+    size_t n; uint8_t *item;
+    while(post_ring && (item = xRingbufferReceive(post_ring, &n, 0))) { elc_chunk_hdr_t h; memcpy(&h, item, sizeof(h)); put_chunk(&h, NULL, 0, item + sizeof(h)); vRingbufferReturnItem(post_ring, item); }
+}
+
+typedef struct { elc_chunk_hdr_t h; const void *pre; size_t pre_len; const void *buf; } chunk_req_t;
+static int write_job(void *arg) { chunk_req_t *q = arg; drain_posted(); return put_chunk(&q->h, q->pre, q->pre_len, q->buf); }
+
+// Blocks until the chunk is on its way to the card; called from the flush task (audio) and from storage jobs
+int elc_write(uint8_t stream, int64_t t_us, const void *buf, size_t len) {
+    if(len > ELC_MAX_PAYLOAD) return -1;
+    chunk_req_t q = { .h = { .stream = stream, .len = len, .t_us = t_us }, .buf = buf };
+    return storage_call(write_job, &q, STORAGE_VOL_FAT, STORAGE_PRIO_RECORD);
+}
+
+int elc_write_meta(const char *tag, const void *buf, size_t len) {
+    if(len + 4 > ELC_MAX_PAYLOAD) return -1;
+    chunk_req_t q = { .h = { .stream = ELC_STREAM_META, .len = len + 4 }, .pre = tag, .pre_len = 4, .buf = buf };
+    return storage_call(write_job, &q, STORAGE_VOL_FAT, STORAGE_PRIO_RECORD);
+}
+
+/* ==================== 3.0 Posted Chunks (Any Task) ==================== */
+// Never blocks and never touches the card: a sensor task must not wait behind an SD burst. The chunk is written
+// by the next elc_write, which in recording is the next audio burst. A full ring drops the chunk and counts it.
+bool elc_post(uint8_t stream, int64_t t_us, const void *buf, size_t len) {
+    uint8_t item[sizeof(elc_chunk_hdr_t) + ELC_POST_MAX]; elc_chunk_hdr_t h = { .stream = stream, .len = len, .t_us = t_us };
+    if(!post_ring || len > ELC_POST_MAX) return false;
+    memcpy(item, &h, sizeof(h)); memcpy(item + sizeof(h), buf, len);
+    if(xRingbufferSend(post_ring, item, sizeof(h) + len, 0) != pdTRUE) { dropped++; return false; }
+    return true;
+}
+
+bool elc_post_event(uint8_t stream, int64_t t_us, uint16_t code, const char *detail) {
+    uint8_t buf[ELC_POST_MAX]; elc_event_t ev = { .code = code, .len = detail ? strnlen(detail, ELC_POST_MAX - sizeof(ev)) : 0 };
+    memcpy(buf, &ev, sizeof(ev)); if(ev.len) memcpy(buf + sizeof(ev), detail, ev.len);
+    return elc_post(stream, t_us, buf, sizeof(ev) + ev.len);
+}
+
+/* ==================== 4.0 Lifecycle ==================== */
+// fd is a freshly created file; writes the file header and the stream declarations. The index and the posting ring
+// are allocated once and kept for the rest of the recording session.
+static int begin_job(void *arg) {
+    elc_file_hdr_t *fh = arg; w_off = 0; w_chunks = 0; dropped = 0; idx_n = 0; idx_step = ELC_INDEX_STEP_US; w_ok = true;
+    for(int i = 0; i < ELC_DATA_STREAMS; i++) idx_last[i] = INT64_MIN;
+    if(storage_append(w_fd, fh, sizeof(*fh), STORAGE_PRIO_RECORD) != sizeof(*fh)) { w_ok = false; return -1; }
+    w_off = sizeof(*fh); return 0;
+}
+
+bool elc_begin(int fd, int64_t start_utc_us, const elc_stream_decl_t *decls, int count) {
+    if(!idx && !(idx = heap_caps_malloc(ELC_INDEX_MAX * sizeof(elc_index_t), MALLOC_CAP_SPIRAM))) idx = heap_caps_malloc(ELC_INDEX_MAX * sizeof(elc_index_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if(!post_ring) {
+        if(!(post_mem = heap_caps_malloc(ELC_POST_RING, MALLOC_CAP_SPIRAM))) post_mem = heap_caps_malloc(ELC_POST_RING, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if(post_mem) post_ring = xRingbufferCreateStatic(ELC_POST_RING, RINGBUF_TYPE_NOSPLIT, post_mem, &post_ctl);
+    }
+    while(post_ring) { size_t n; void *item = xRingbufferReceive(post_ring, &n, 0); if(!item) break; vRingbufferReturnItem(post_ring, item); } // Leftovers of a clip that failed
+    elc_file_hdr_t fh = { .magic = ELC_MAGIC, .version = ELC_VERSION, .hdr_len = sizeof(fh), .start_utc_us = start_utc_us };
+    esp_efuse_mac_get_default(fh.device_id); w_fd = fd;
+    if(storage_call(begin_job, &fh, STORAGE_VOL_FAT, STORAGE_PRIO_RECORD)) { w_fd = -1; return false; }
+    for(int i = 0; i < count; i++) if(elc_write(ELC_STREAM_DECL, 0, &decls[i], sizeof(decls[i]))) { w_fd = -1; return false; }
+    return true;
+}
+
+// Writes whatever is still posted, then the index chunk and the footer. Returns the file size, or -1 if any chunk
+// failed (the file is then still readable up to the last good chunk, like one cut by power loss).
+static int finish_job(void *arg) {
+    drain_posted();
+    elc_chunk_hdr_t h = { .stream = ELC_STREAM_INDEX, .len = idx_n * sizeof(elc_index_t), .t_us = 0 };
+    elc_footer_t ft = { .magic = ELC_FOOTER_MAGIC, .index_offset = w_off, .index_count = idx_n, .end_us = *(int64_t *)arg };
+    if(put_chunk(&h, NULL, 0, idx)) return -1;
+    ft.chunk_count = w_chunks; ft.crc = crc32_update(0, &ft, offsetof(elc_footer_t, crc));
+    if(storage_append(w_fd, &ft, sizeof(ft), STORAGE_PRIO_RECORD) != sizeof(ft)) return -1;
+    w_off += sizeof(ft); return w_off;
+}
+
+int elc_finish(int64_t end_us) {
+    if(w_fd < 0) return -1;
+    int size = storage_call(finish_job, &end_us, STORAGE_VOL_FAT, STORAGE_PRIO_RECORD);
+    if(dropped) ESP_LOGW(TAG, "%lu side-stream chunks dropped", (unsigned long)dropped);
+    w_fd = -1; return size;
+}
+
+/* ==================== 5.0 Header Probe ==================== */
+// Start time and position from the "elog" meta chunk near the head, length from the footer (end_us stays -1 on a
+// file cut by power loss). Runs on the storage task for the catalog and the BLE meta command.
+int elc_describe(const char *path, wav_meta_t *m, int64_t *end_us) {
+    uint8_t h[512]; elc_footer_t ft; FILE *f = fopen(path, "rb"); if(!f) return -1;
+    size_t n = fread(h, 1, sizeof(h), f); bool has_ft = !fseek(f, -(long)sizeof(ft), SEEK_END) && fread(&ft, 1, sizeof(ft), f) == sizeof(ft); fclose(f);
+    memset(m, 0, sizeof(*m)); m->trigger = m->fix_quality = m->time_source = m->mic_mode = WAV_META_UNKNOWN; m->lat_e7 = CAT_NO_GPS; m->lon_e7 = CAT_NO_GPS;
+    *end_us = (has_ft && !memcmp(ft.magic, ELC_FOOTER_MAGIC, 4) && ft.crc == crc32_update(0, &ft, offsetof(elc_footer_t, crc))) ? ft.end_us : -1;
+    if(n < sizeof(elc_file_hdr_t) || memcmp(h, ELC_MAGIC, 4)) return -1;
+    uint16_t hl; memcpy(&hl, h + 6, 2);
+    for(size_t off = hl; off + sizeof(elc_chunk_hdr_t) <= n; ) {
+        elc_chunk_hdr_t ch; memcpy(&ch, h + off, sizeof(ch)); const uint8_t *b = h + off + sizeof(ch);
+        if(ch.stream == ELC_STREAM_META && ch.len > 4 && off + sizeof(ch) + ch.len <= n && !memcmp(b, "elog", 4)) { memcpy(m, b + 4, (ch.len - 4 < sizeof(*m)) ? ch.len - 4 : sizeof(*m)); return 1; }
+        if(ch.stream < ELC_STREAM_DECL) break; // Past the declarations and the opening meta chunks
+        off += sizeof(ch) + ch.len;
+    }
+    return 0;
+}
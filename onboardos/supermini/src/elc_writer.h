@@ -0,0 +1,48 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Multi-Stream Container Writer Header */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Definitions
+   2.0 Prototypes
+========================================*/
+
+/* ==================== 1.0 Includes & Definitions ==================== */
+#ifndef ELC_WRITER_H
+#define ELC_WRITER_H
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "elc_format.h"
+#include "wav_meta.h"
+
+#define ELC_POST_MAX 400 // Largest chunk payload elc_post takes (a batch of accel records, an event)
+
+/* ==================== 2.0 Prototypes ==================== */
+bool elc_begin(int fd, int64_t start_utc_us, const elc_stream_decl_t *decls, int count);
+int elc_write(uint8_t stream, int64_t t_us, const void *buf, size_t len);
+int elc_write_meta(const char *tag, const void *buf, size_t len);
+bool elc_post(uint8_t stream, int64_t t_us, const void *buf, size_t len);
+bool elc_post_event(uint8_t stream, int64_t t_us, uint16_t code, const char *detail);
+int elc_finish(int64_t end_us);
+int elc_describe(const char *path, wav_meta_t *m, int64_t *end_us);
+
+#endif
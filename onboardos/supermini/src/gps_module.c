@@ -36,6 +36,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include "esp_log.h"
+#include "esp_timer.h"
 
 #define I2C_GPS_NUM  I2C_NUM_1
 #define PA1010D_ADDR 0x10
@@ -43,6 +44,10 @@
 static volatile double current_lat = 0.0;
 static volatile double current_lon = 0.0;
 static volatile int current_fix = 0;
+static volatile int current_sats = 0, current_hdop_x10 = 0; // GGA fields 7 and 8, for the recording metadata
+static int64_t current_utc_us = 0, current_utc_rx_us = 0; // Last GGA time and the esp_timer value when it arrived
+static int current_date_days = -1; // Days since 1970-01-01 from the last RMC sentence
+static portMUX_TYPE time_mux = portMUX_INITIALIZER_UNLOCKED; // 64-bit fields are read from the recording task
 static TaskHandle_t gps_task_handle = NULL;
 static bool gps_running = false;
 
@@ -55,12 +60,30 @@ static double convert_to_decimal_degrees(const char* nmea_coord, const char* dir
     return decimal_degrees;
 }
 
+// Civil date to days since the epoch (proleptic Gregorian), avoids depending on the TZ used by mktime
+static int days_from_civil(int y, int m, int d) {
+    y -= m <= 2; int era = y / 400, yoe = y - era * 400, doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1, doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
 static void parse_nmea_sentence(char *sentence) {
-    if (strncmp(sentence, "$GNGGA", 6) == 0 || strncmp(sentence, "$GPGGA", 6) == 0) {
+    int64_t rx_us = esp_timer_get_time();
+    if (strncmp(sentence, "$GNRMC", 6) == 0 || strncmp(sentence, "$GPRMC", 6) == 0) {
+        char *tokens[13] = {0}; int idx = 0; tokens[idx++] = sentence;
+        for(char *p = sentence; *p; p++) { if(*p == ',') { *p = '\0'; if(idx < 13) tokens[idx++] = p + 1; } }
+        if (idx > 9 && tokens[2][0] == 'A' && strlen(tokens[9]) == 6) { int dt = atoi(tokens[9]); current_date_days = days_from_civil(2000 + dt % 100, (dt / 100) % 100, dt / 10000); }
+    }
+    else if (strncmp(sentence, "$GNGGA", 6) == 0 || strncmp(sentence, "$GPGGA", 6) == 0) {
         char *tokens[15] = {0}; int idx = 0; tokens[idx++] = sentence;
         for(char *p = sentence; *p; p++) { if(*p == ',') { *p = '\0'; if(idx < 15) tokens[idx++] = p + 1; } }
         
         if (idx > 6) current_fix = atoi(tokens[6]);
+        if (idx > 8) { current_sats = atoi(tokens[7]); current_hdop_x10 = (int)(atof(tokens[8]) * 10); }
+        if (current_fix > 0 && current_date_days >= 0 && strlen(tokens[1]) >= 6) {
+            double t = atof(tokens[1]); int hms = (int)t;
+            int64_t utc = ((int64_t)current_date_days * 86400 + (hms / 10000) * 3600 + ((hms / 100) % 100) * 60 + hms % 100) * 1000000LL + (int64_t)((t - hms) * 1e6);
+            portENTER_CRITICAL(&time_mux); current_utc_us = utc; current_utc_rx_us = rx_us; portEXIT_CRITICAL(&time_mux);
+        }
         if (current_fix > 0 && strlen(tokens[2]) > 0 && strlen(tokens[4]) > 0) {
             current_lat = convert_to_decimal_degrees(tokens[2], tokens[3]);
             current_lon = convert_to_decimal_degrees(tokens[4], tokens[5]);
@@ -117,7 +140,21 @@ void gps_force_sleep(void) {
     i2c_driver_delete(I2C_GPS_NUM);
 }
 
+// NMEA arrives a few hundred ms after the second it describes and is polled every 100 ms, so this is
+// good to roughly 0.1-0.5 s unless a PPS line is added; still far better than a drifting, hand-set RTC
+bool gps_get_time(int64_t *utc_us, int64_t *rx_timer_us) {
+    if (current_fix <= 0) return false;
+    portENTER_CRITICAL(&time_mux); *utc_us = current_utc_us; *rx_timer_us = current_utc_rx_us; portEXIT_CRITICAL(&time_mux);
+    return *rx_timer_us != 0;
+}
+
 void gps_get_coords_str(char* buf) {
     if (current_fix > 0) snprintf(buf, 32, "%.6f_%.6f", current_lat, current_lon);
     else snprintf(buf, 32, "XXXXXXXX_XXXXXXXX"); 
-}
\ No newline at end of file
+}
+
+bool gps_get_fix(gps_fix_t *fix) {
+    fix->quality = current_fix; fix->sats = current_sats; fix->hdop_x10 = current_hdop_x10;
+    fix->lat = current_fix > 0 ? current_lat : 0.0; fix->lon = current_fix > 0 ? current_lon : 0.0;
+    return current_fix > 0;
+}
@@ -22,10 +22,17 @@
 
 #ifndef GPS_MODULE_H
 #define GPS_MODULE_H
+#include <stdint.h>
+#include <stdbool.h>
+
+// Quality and satellite count as reported in the last GGA sentence (quality 0 means no fix)
+typedef struct { uint8_t quality, sats; uint16_t hdop_x10; double lat, lon; } gps_fix_t;
 
 void gps_init(void);
 void gps_deinit(void);
 void gps_get_coords_str(char* buf);
 void gps_force_sleep(void);
+bool gps_get_time(int64_t *utc_us, int64_t *rx_timer_us);
+bool gps_get_fix(gps_fix_t *fix);
 
 #endif
\ No newline at end of file
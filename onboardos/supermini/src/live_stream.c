@@ -0,0 +1,111 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Live ADPCM Audio Notifications While Recording */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Definitions
+   2.0 Variables
+   3.0 Producer (Recording Task)
+   4.0 Stream Task
+   5.0 Lifecycle & Commands
+========================================*/
+
+/* ==================== 1.0 Includes & Definitions ==================== */
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_timer.h"
+#include "live_stream.h"
+#include "bluetooth_mode.h"
+#include "adpcm.h"
+
+#define STREAM_FRAME_SAMPLES 256 // 16 ms at 16 kHz, 128 bytes of ADPCM
+#define STREAM_QUEUE_LEN 6       // ~100 ms of slack before the producer starts dropping
+#define STREAM_TASK_PRIO 1       // Same as app_main: the SD writer never waits on us, we only ever lose frames
+
+/* ==================== 2.0 Variables ==================== */
+typedef struct { uint32_t ts_ms; uint16_t n; int16_t pcm[STREAM_FRAME_SAMPLES]; } stream_frame_t;
+
+static QueueHandle_t frame_queue = NULL;
+static TaskHandle_t stream_task_handle = NULL;
+static volatile bool subscribed = false, running = false;
+static stream_frame_t acc; // Only touched by the recording task
+static uint16_t seq = 0; static uint8_t step_index = 0;
+static volatile uint32_t frames_sent = 0, frames_dropped = 0;
+
+/* ==================== 3.0 Producer (Recording Task) ==================== */
+// Called right after each I2S block is converted. Never blocks: a full queue means the link is behind, so the frame is dropped.
+void live_stream_push(const int16_t *pcm, size_t samples, uint16_t channels) {
+    if(!subscribed || !frame_queue) { acc.n = 0; return; }
+    for(size_t i = 0; i < samples; i += channels) {
+        acc.pcm[acc.n++] = pcm[i]; // Stereo streams the left mic only
+        if(acc.n == STREAM_FRAME_SAMPLES) {
+            acc.ts_ms = (uint32_t)(esp_timer_get_time() / 1000);
+            if(xQueueSend(frame_queue, &acc, 0) != pdTRUE) frames_dropped++;
+            acc.n = 0;
+        }
+    }
+}
+
+/* ==================== 4.0 Stream Task ==================== */
+// Each packet carries its own predictor/index, so a dropped packet never corrupts the ones after it
+static void stream_task(void *pvParameters) {
+    static stream_frame_t frm; uint8_t pkt[STREAM_HDR_LEN + STREAM_FRAME_SAMPLES / 2];
+    while(running) {
+        if(xQueueReceive(frame_queue, &frm, pdMS_TO_TICKS(100)) != pdTRUE) continue;
+        if(!subscribed || ble_is_congested()) { frames_dropped++; continue; }
+        int max_smp = (ble_get_mtu() - 3 - STREAM_HDR_LEN) * 2; if(max_smp <= 0) { frames_dropped++; continue; }
+        adpcm_state_t st = { .predictor = frm.pcm[0], .index = step_index }; bool ok = true; // Keep the adapted step size, restart the predictor on a real sample
+        for(int off = 0; off < frm.n && ok; off += max_smp) {
+            uint16_t n = (frm.n - off < max_smp) ? frm.n - off : max_smp;
+            pkt[0] = seq & 0xFF; pkt[1] = seq >> 8; memcpy(&pkt[2], &frm.ts_ms, 4); memcpy(&pkt[6], &st.predictor, 2); pkt[8] = st.index; pkt[9] = 0; pkt[10] = n & 0xFF; pkt[11] = n >> 8;
+            size_t len = STREAM_HDR_LEN + adpcm_encode(&st, &frm.pcm[off], n, &pkt[STREAM_HDR_LEN]);
+            ok = (send_stream_notification(pkt, len) == ESP_OK); seq++;
+        }
+        step_index = st.index; if(ok) frames_sent++; else frames_dropped++;
+    }
+    stream_task_handle = NULL; vTaskDelete(NULL);
+}
+
+/* ==================== 5.0 Lifecycle & Commands ==================== */
+void live_stream_start(void) {
+    if(running) return;
+    if(!frame_queue) frame_queue = xQueueCreate(STREAM_QUEUE_LEN, sizeof(stream_frame_t));
+    running = true; frames_sent = 0; frames_dropped = 0;
+    xTaskCreate(stream_task, "live_strm", 4096, NULL, STREAM_TASK_PRIO, &stream_task_handle);
+}
+
+void live_stream_stop(void) {
+    running = false; subscribed = false; vTaskDelay(pdMS_TO_TICKS(200));
+    if(frame_queue) { vQueueDelete(frame_queue); frame_queue = NULL; }
+}
+
+void live_stream_set_subscribed(bool on) { subscribed = on; if(on && frame_queue) xQueueReset(frame_queue); }
+
+// Only a handful of commands exist while recording: "clk" lets the client map ts_ms onto its own clock for latency
+void live_stream_handle_cmd(const char *cmd) {
+    char buf[48]; int len = 0;
+    if(!strcmp(cmd, "clk")) len = snprintf(buf, sizeof(buf), "CLK|%lu", (unsigned long)(esp_timer_get_time() / 1000));
+    else if(!strcmp(cmd, "stream_stats")) len = snprintf(buf, sizeof(buf), "STREAM|%lu|%lu", (unsigned long)frames_sent, (unsigned long)frames_dropped);
+    if(len > 0) send_notification((uint8_t*)buf, len);
+}
@@ -0,0 +1,45 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Live ADPCM Audio Streaming Header */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Definitions
+   2.0 Prototypes
+========================================*/
+
+/* ==================== 1.0 Includes & Definitions ==================== */
+#ifndef LIVE_STREAM_H
+#define LIVE_STREAM_H
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Packet: seq(u16) ts_ms(u32) predictor(i16) index(u8) flags(u8) samples(u16), little-endian, then 4-bit IMA codes
+#define STREAM_HDR_LEN 12
+
+/* ==================== 2.0 Prototypes ==================== */
+void live_stream_start(void);
+void live_stream_stop(void);
+void live_stream_push(const int16_t *pcm, size_t samples, uint16_t channels);
+void live_stream_set_subscribed(bool on);
+void live_stream_handle_cmd(const char *cmd);
+
+#endif
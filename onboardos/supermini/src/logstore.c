@@ -0,0 +1,219 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Append-Only Log of Checksummed Segments on a Raw SD Region */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Definitions
+   2.0 Segment Headers
+   3.0 Mount & Index Rebuild
+   4.0 Writer
+   5.0 Reader & WAV Export
+========================================*/
+
+/* ==================== 1.0 Includes & Definitions ==================== */
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "logstore.h"
+#include "crc32.h"
+
+/* The region is a ring of fixed LOG_SEG_SECTORS slots written strictly in order, each slot one multi-block write of
+   header + payload. Every header repeats its entry's metadata and first slot, so the index is rebuilt from roughly
+   two header reads per entry, and a torn or stale slot simply fails its CRC or sequence check. */
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic; uint16_t version; uint16_t flags;
+    uint32_t seq, entry_id, id_hwm, first_slot, entry_offset, payload_len, payload_crc;
+    logstore_meta_t meta;
+    uint32_t header_crc; // Over every byte before it
+} log_seg_hdr_t;
+
+#define SLOT_LBA(ls, s) ((ls)->base_lba + (s) * LOG_SEG_SECTORS)
+#define PREV(ls, s) (((s) + (ls)->nslots - 1) % (ls)->nslots)
+#define INITIAL_CAP 64
+
+/* ==================== 2.0 Segment Headers ==================== */
+// Reads a slot header and, for data segments, checks the payload CRC too. Returns false for blank, torn or foreign slots.
+static bool read_header(logstore_t *ls, uint32_t slot, log_seg_hdr_t *h, bool check_payload) {
+    if(ls->dev->read(ls->dev->ctx, SLOT_LBA(ls, slot), ls->sector_buf, 1)) return false;
+    memcpy(h, ls->sector_buf, sizeof(*h));
+    if(h->magic != LOG_MAGIC || h->version != 1 || crc32_update(0, h, offsetof(log_seg_hdr_t, header_crc)) != h->header_crc) return false;
+    if(!check_payload || h->payload_len == 0) return true;
+    if(h->payload_len > LOG_SEG_PAYLOAD) return false;
+    uint32_t crc = 0, left = h->payload_len;
+    for(uint32_t sec = 1; left; sec++) {
+        uint32_t n = (left < BLOCKDEV_SECTOR_SIZE) ? left : BLOCKDEV_SECTOR_SIZE;
+        if(ls->dev->read(ls->dev->ctx, SLOT_LBA(ls, slot) + sec, ls->sector_buf, 1)) return false;
+        crc = crc32_update(crc, ls->sector_buf, n); left -= n;
+    }
+    return crc == h->payload_crc;
+}
+
+static int index_push(logstore_t *ls, const logstore_entry_t *e) {
+    if(ls->count == ls->cap) { int cap = ls->cap ? ls->cap * 2 : INITIAL_CAP; logstore_entry_t *n = realloc(ls->entries, cap * sizeof(*n)); if(!n) return -1; ls->entries = n; ls->cap = cap; }
+    ls->entries[ls->count++] = *e; return 0;
+}
+
+static void index_remove(logstore_t *ls, int i) { memmove(&ls->entries[i], &ls->entries[i + 1], (ls->count - i - 1) * sizeof(logstore_entry_t)); ls->count--; }
+
+static bool slot_in(const logstore_t *ls, uint32_t slot, uint32_t first, uint32_t last) {
+    return ((slot + ls->nslots - first) % ls->nslots) <= ((last + ls->nslots - first) % ls->nslots);
+}
+
+/* ==================== 3.0 Mount & Index Rebuild ==================== */
+// Slots written in the current lap satisfy seq(i) == seq(0) + i, which is true up to the head and false after it
+static bool in_lap(logstore_t *ls, uint32_t slot, uint32_t seq0) { log_seg_hdr_t h; return read_header(ls, slot, &h, false) && h.seq == seq0 + slot; }
+
+int logstore_mount(logstore_t *ls, blockdev_t *dev, uint32_t base_lba, uint32_t sectors) {
+    memset(ls, 0, sizeof(*ls)); ls->dev = dev; ls->base_lba = base_lba; ls->nslots = sectors / LOG_SEG_SECTORS; ls->next_seq = 1; ls->next_id = 1;
+    if(ls->nslots < 2) return -1;
+    ls->sector_buf = malloc(BLOCKDEV_SECTOR_SIZE); ls->seg_buf = malloc(LOG_SEG_SECTORS * BLOCKDEV_SECTOR_SIZE);
+    if(!ls->sector_buf || !ls->seg_buf) { logstore_unmount(ls); return -1; }
+
+    // 1. Find the newest slot with a binary search over the current lap
+    log_seg_hdr_t h; int64_t newest = -1;
+    if(read_header(ls, 0, &h, false)) {
+        uint32_t seq0 = h.seq, lo = 0, hi = ls->nslots - 1;
+        while(lo < hi) { uint32_t mid = (lo + hi + 1) / 2; if(in_lap(ls, mid, seq0)) lo = mid; else hi = mid - 1; }
+        newest = lo;
+    } else if(read_header(ls, ls->nslots - 1, &h, false)) newest = ls->nslots - 1; // Slot 0 tore just after a wrap
+    if(newest < 0 || !read_header(ls, newest, &h, false)) return 0; // Blank region: empty log
+
+    ls->head = (newest + 1) % ls->nslots; ls->next_seq = h.seq + 1; ls->next_id = h.id_hwm + 1;
+
+    // 2. Walk back entry by entry (last segment -> first segment -> previous entry) until stale or overwritten data.
+    //    A segment whose payload tore in a power cut keeps its header, so the entry survives minus that one segment.
+    uint32_t s = newest, walked = 0, seq_top = h.seq, *tombs = NULL; int ntombs = 0;
+    while(walked < ls->nslots) {
+        if(!read_header(ls, s, &h, false) || h.seq != seq_top - walked) break;
+        if(h.flags & LOG_F_TOMB) { uint32_t *t = realloc(tombs, (ntombs + 1) * sizeof(uint32_t)); if(t) { tombs = t; tombs[ntombs++] = h.entry_id; } walked++; s = PREV(ls, s); continue; }
+        uint32_t span = (s + ls->nslots - h.first_slot) % ls->nslots + 1; log_seg_hdr_t f;
+        if(walked + span > ls->nslots) break;
+        if(span > 1 && (!read_header(ls, h.first_slot, &f, false) || f.entry_id != h.entry_id || f.seq != h.seq - (span - 1))) break;
+        bool torn = !read_header(ls, s, &h, true), dead = (h.meta.flags & LOG_F_HIDDEN) || (torn && span == 1);
+        for(int i = 0; i < ntombs && !dead; i++) dead = (tombs[i] == h.entry_id);
+        if(!dead) {
+            logstore_entry_t e = { .id = h.entry_id, .first_slot = h.first_slot, .last_slot = torn ? PREV(ls, s) : s, .bytes = h.entry_offset + (torn ? 0 : h.payload_len), .meta = h.meta, .closed = !torn && (h.flags & LOG_F_LAST) };
+            index_push(ls, &e);
+        }
+        walked += span; s = PREV(ls, h.first_slot);
+    }
+    free(tombs);
+    for(int i = 0; i < ls->count / 2; i++) { logstore_entry_t t = ls->entries[i]; ls->entries[i] = ls->entries[ls->count - 1 - i]; ls->entries[ls->count - 1 - i] = t; }
+    return 0;
+}
+
+void logstore_unmount(logstore_t *ls) {
+    if(ls->writing) logstore_end(ls);
+    free(ls->entries); free(ls->seg_buf); free(ls->sector_buf); ls->entries = NULL; ls->seg_buf = NULL; ls->sector_buf = NULL; ls->count = ls->cap = 0;
+}
+
+/* ==================== 4.0 Writer ==================== */
+// Writes header + payload for one slot at the head, dropping whichever old entry the slot lands on
+static int write_slot(logstore_t *ls, uint16_t flags, uint32_t entry_id, uint32_t first_slot, uint32_t entry_offset, const logstore_meta_t *meta) {
+    for(int i = 0; i < ls->count; i++) if(slot_in(ls, ls->head, ls->entries[i].first_slot, ls->entries[i].last_slot)) { index_remove(ls, i); break; }
+    log_seg_hdr_t h = { .magic = LOG_MAGIC, .version = 1, .flags = flags, .seq = ls->next_seq, .entry_id = entry_id, .id_hwm = ls->next_id - 1,
+                        .first_slot = first_slot, .entry_offset = entry_offset, .payload_len = ls->seg_fill };
+    h.payload_crc = crc32_update(0, ls->seg_buf + BLOCKDEV_SECTOR_SIZE, ls->seg_fill);
+    if(meta) h.meta = *meta;
+    h.header_crc = crc32_update(0, &h, offsetof(log_seg_hdr_t, header_crc));
+    memset(ls->seg_buf, 0, BLOCKDEV_SECTOR_SIZE); memcpy(ls->seg_buf, &h, sizeof(h));
+    uint32_t sectors = 1 + (ls->seg_fill + BLOCKDEV_SECTOR_SIZE - 1) / BLOCKDEV_SECTOR_SIZE;
+    if(ls->seg_fill % BLOCKDEV_SECTOR_SIZE) memset(ls->seg_buf + BLOCKDEV_SECTOR_SIZE + ls->seg_fill, 0, BLOCKDEV_SECTOR_SIZE - ls->seg_fill % BLOCKDEV_SECTOR_SIZE);
+    if(ls->dev->write(ls->dev->ctx, SLOT_LBA(ls, ls->head), ls->seg_buf, sectors)) return -1;
+    ls->head = (ls->head + 1) % ls->nslots; ls->next_seq++; return 0;
+}
+
+int logstore_begin(logstore_t *ls, const logstore_meta_t *meta) {
+    if(ls->writing || !ls->seg_buf) return -1;
+    memset(&ls->cur, 0, sizeof(ls->cur)); ls->cur.id = ls->next_id++; ls->cur.first_slot = ls->head; ls->cur.last_slot = ls->head; ls->cur.meta = *meta;
+    ls->seg_fill = 0; ls->writing = true; return 0;
+}
+
+static int flush_segment(logstore_t *ls, bool last) {
+    if(write_slot(ls, last ? LOG_F_LAST : 0, ls->cur.id, ls->cur.first_slot, ls->cur.bytes, &ls->cur.meta)) return -1;
+    ls->cur.last_slot = PREV(ls, ls->head); ls->cur.bytes += ls->seg_fill; ls->seg_fill = 0; return 0;
+}
+
+int logstore_append(logstore_t *ls, const void *data, uint32_t len) {
+    const uint8_t *p = data; if(!ls->writing) return -1;
+    while(len) {
+        uint32_t n = LOG_SEG_PAYLOAD - ls->seg_fill; if(n > len) n = len;
+        memcpy(ls->seg_buf + BLOCKDEV_SECTOR_SIZE + ls->seg_fill, p, n); ls->seg_fill += n; p += n; len -= n;
+        if(ls->seg_fill == LOG_SEG_PAYLOAD) {
+            if((ls->head + ls->nslots - ls->cur.first_slot) % ls->nslots >= ls->nslots - 2) return -1; // Entry would eat its own start
+            if(flush_segment(ls, false)) return -1;
+        }
+    }
+    return 0;
+}
+
+int logstore_end(logstore_t *ls) {
+    if(!ls->writing) return -1;
+    ls->writing = false; if(flush_segment(ls, true)) return -1;
+    ls->cur.closed = true; if(!(ls->cur.meta.flags & LOG_F_HIDDEN)) index_push(ls, &ls->cur);
+    return 0;
+}
+
+// Deletion appends a header-only tombstone; the data is reclaimed when the ring wraps over it
+int logstore_delete(logstore_t *ls, uint32_t id) {
+    if(ls->writing) return -1; // A tombstone inside an open entry would break its slot run
+    for(int i = 0; i < ls->count; i++) if(ls->entries[i].id == id) {
+        index_remove(ls, i); uint32_t fill = ls->seg_fill; ls->seg_fill = 0;
+        int r = write_slot(ls, LOG_F_TOMB, id, ls->head, 0, NULL); ls->seg_fill = fill; return r;
+    }
+    return -1;
+}
+
+const logstore_entry_t *logstore_find(const logstore_t *ls, uint32_t id) {
+    for(int i = 0; i < ls->count; i++) if(ls->entries[i].id == id) return &ls->entries[i];
+    return NULL;
+}
+
+/* ==================== 5.0 Reader & WAV Export ==================== */
+int logstore_read(logstore_t *ls, const logstore_entry_t *e, uint32_t offset, void *buf, uint32_t len) {
+    uint8_t *out = buf; uint32_t done = 0;
+    if(offset >= e->bytes) return 0;
+    if(len > e->bytes - offset) len = e->bytes - offset;
+    while(done < len) {
+        uint32_t pos = offset + done, slot = (e->first_slot + pos / LOG_SEG_PAYLOAD) % ls->nslots, in_seg = pos % LOG_SEG_PAYLOAD;
+        uint32_t sec = 1 + in_seg / BLOCKDEV_SECTOR_SIZE, in_sec = in_seg % BLOCKDEV_SECTOR_SIZE, n = BLOCKDEV_SECTOR_SIZE - in_sec;
+        if(n > len - done) n = len - done;
+        if(in_sec == 0 && n == BLOCKDEV_SECTOR_SIZE) { if(ls->dev->read(ls->dev->ctx, SLOT_LBA(ls, slot) + sec, out + done, 1)) return -1; }
+        else { if(ls->dev->read(ls->dev->ctx, SLOT_LBA(ls, slot) + sec, ls->sector_buf, 1)) return -1; memcpy(out + done, ls->sector_buf + in_sec, n); }
+        done += n;
+    }
+    return done;
+}
+
+// Presents an entry as a plain PCM WAV file: a synthesized 44-byte header followed by the payload
+int logstore_export_read(logstore_t *ls, const logstore_entry_t *e, uint32_t offset, void *buf, uint32_t len) {
+    uint8_t hdr[LOG_WAV_HDR_LEN], *out = buf; uint32_t done = 0;
+    if(offset < LOG_WAV_HDR_LEN) {
+        uint32_t riff = 36 + e->bytes, rate = e->meta.sample_rate, byterate = rate * e->meta.channels * e->meta.bits / 8; uint16_t fmt = 1, align = e->meta.channels * e->meta.bits / 8, fmt_len[2] = {16, 0};
+        memcpy(hdr, "RIFF", 4); memcpy(hdr + 4, &riff, 4); memcpy(hdr + 8, "WAVEfmt ", 8); memcpy(hdr + 16, fmt_len, 4); memcpy(hdr + 20, &fmt, 2); memcpy(hdr + 22, &e->meta.channels, 2);
+        memcpy(hdr + 24, &rate, 4); memcpy(hdr + 28, &byterate, 4); memcpy(hdr + 32, &align, 2); memcpy(hdr + 34, &e->meta.bits, 2); memcpy(hdr + 36, "data", 4); memcpy(hdr + 40, &e->bytes, 4);
+        done = LOG_WAV_HDR_LEN - offset; if(done > len) done = len; memcpy(out, hdr + offset, done);
+    }
+    if(done == len) return done;
+    int r = logstore_read(ls, e, offset + done - LOG_WAV_HDR_LEN, out + done, len - done);
+    return (r < 0) ? r : (int)(done + r);
+}
@@ -0,0 +1,81 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Log-Structured Recording Store Header */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Definitions
+   2.0 Structs
+   3.0 Prototypes
+========================================*/
+
+/* ==================== 1.0 Includes & Definitions ==================== */
+#ifndef LOGSTORE_H
+#define LOGSTORE_H
+#include <stdint.h>
+#include <stdbool.h>
+#include "blockdev.h"
+
+#define LOG_SEG_SECTORS 64                                            // Fixed slot: 1 header sector + 63 payload sectors
+#define LOG_SEG_PAYLOAD ((LOG_SEG_SECTORS - 1) * BLOCKDEV_SECTOR_SIZE) // 32256 bytes, about 1 s of 16 kHz mono
+#define LOG_MAGIC 0x474C5345                                          // "ESLG"
+#define LOG_WAV_HDR_LEN 44
+
+#define LOG_F_LAST   0x0001 // Entry was closed cleanly in this segment
+#define LOG_F_TOMB   0x0002 // Tombstone: entry_id names a deleted entry
+#define LOG_F_HIDDEN 0x0004 // Scratch entry (benchmarks), never listed
+
+/* ==================== 2.0 Structs ==================== */
+typedef struct __attribute__((packed)) {
+    int64_t start_time;
+    uint32_t sample_rate;
+    uint16_t channels;
+    uint16_t bits;
+    uint16_t flags;
+    char name[48];
+} logstore_meta_t;
+
+typedef struct {
+    uint32_t id, first_slot, last_slot, bytes;
+    logstore_meta_t meta;
+    bool closed; // false when recovered after a power cut
+} logstore_entry_t;
+
+typedef struct {
+    blockdev_t *dev;
+    uint32_t base_lba, nslots, head, next_seq, next_id;
+    logstore_entry_t *entries; int count, cap; // Oldest first
+    bool writing; logstore_entry_t cur; uint8_t *seg_buf; uint32_t seg_fill;
+    uint8_t *sector_buf;
+} logstore_t;
+
+/* ==================== 3.0 Prototypes ==================== */
+int logstore_mount(logstore_t *ls, blockdev_t *dev, uint32_t base_lba, uint32_t sectors);
+void logstore_unmount(logstore_t *ls);
+int logstore_begin(logstore_t *ls, const logstore_meta_t *meta);
+int logstore_append(logstore_t *ls, const void *data, uint32_t len);
+int logstore_end(logstore_t *ls);
+int logstore_delete(logstore_t *ls, uint32_t id);
+const logstore_entry_t *logstore_find(const logstore_t *ls, uint32_t id);
+int logstore_read(logstore_t *ls, const logstore_entry_t *e, uint32_t offset, void *buf, uint32_t len);
+int logstore_export_read(logstore_t *ls, const logstore_entry_t *e, uint32_t offset, void *buf, uint32_t len);
+static inline uint32_t logstore_export_size(const logstore_entry_t *e) { return LOG_WAV_HDR_LEN + e->bytes; }
+
+#endif
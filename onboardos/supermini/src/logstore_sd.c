@@ -0,0 +1,67 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Log Store Binding to the SD Card's Raw Partition */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Variables
+   2.0 Sector Callbacks
+   3.0 Mount & Naming
+========================================*/
+
+/* ==================== 1.0 Includes & Variables ==================== */
+#include <stdio.h>
+#include <string.h>
+#include "esp_log.h"
+#include "logstore_sd.h"
+#include "sd_clock.h"
+
+static const char *TAG = "LOGSTORE";
+static blockdev_t sd_dev;
+static logstore_t sd_log;
+static bool sd_log_mounted = false;
+
+/* ==================== 2.0 Sector Callbacks ==================== */
+static int sd_read(void *ctx, uint32_t lba, void *buf, uint32_t count) { return sd_clock_read((sdmmc_card_t*)ctx, buf, lba, count) != ESP_OK; }
+static int sd_write(void *ctx, uint32_t lba, const void *buf, uint32_t count) { return sd_clock_write((sdmmc_card_t*)ctx, buf, lba, count) != ESP_OK; }
+
+/* ==================== 3.0 Mount & Naming ==================== */
+// FAT is mounted from partition 1 as before; the log only exists on cards partitioned with a type 0xDA entry
+bool logstore_sd_mount(sdmmc_card_t *card) {
+    if(sd_log_mounted) return true;
+    uint8_t mbr[BLOCKDEV_SECTOR_SIZE]; uint32_t base = 0, sectors = 0;
+    if(sdmmc_read_sectors(card, mbr, 0, 1) != ESP_OK || mbr[510] != 0x55 || mbr[511] != 0xAA) return false;
+    for(int i = 0; i < 4; i++) {
+        const uint8_t *p = mbr + 446 + i * 16;
+        if(p[4] == LOGSTORE_PART_TYPE) { memcpy(&base, p + 8, 4); memcpy(&sectors, p + 12, 4); break; }
+    }
+    if(!sectors) return false;
+    sd_dev = (blockdev_t){ .ctx = card, .sector_count = base + sectors, .read = sd_read, .write = sd_write };
+    if(logstore_mount(&sd_log, &sd_dev, base, sectors)) { ESP_LOGE(TAG, "Mount failed"); return false; }
+    ESP_LOGI(TAG, "%d entries, head slot %lu of %lu", sd_log.count, (unsigned long)sd_log.head, (unsigned long)sd_log.nslots);
+    sd_log_mounted = true; return true;
+}
+
+logstore_t *logstore_sd_get(void) { return sd_log_mounted ? &sd_log : NULL; }
+
+void logstore_sd_unmount(void) { if(sd_log_mounted) { logstore_unmount(&sd_log); sd_log_mounted = false; } }
+
+// "@log/<id>_<name>.wav" is what the app lists and requests; only the id is parsed back
+int logstore_sd_entry_name(const logstore_entry_t *e, char *out, size_t len) { return snprintf(out, len, LOGSTORE_PREFIX "%lu_%.48s.wav", (unsigned long)e->id, e->meta.name); }
@@ -0,0 +1,44 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Log Store Binding to the SD Card's Raw Partition */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Definitions
+   2.0 Prototypes
+========================================*/
+
+/* ==================== 1.0 Includes & Definitions ==================== */
+#ifndef LOGSTORE_SD_H
+#define LOGSTORE_SD_H
+#include <stdbool.h>
+#include "sdmmc_cmd.h"
+#include "logstore.h"
+
+#define LOGSTORE_PART_TYPE 0xDA // MBR "non-FS data": the log lives in a second partition next to the FAT volume
+#define LOGSTORE_PREFIX "@log/" // Name prefix that routes ls/get/del to the log instead of FAT
+
+/* ==================== 2.0 Prototypes ==================== */
+bool logstore_sd_mount(sdmmc_card_t *card);
+logstore_t *logstore_sd_get(void); // NULL when the card has no log partition
+void logstore_sd_unmount(void);
+int logstore_sd_entry_name(const logstore_entry_t *e, char *out, size_t len);
+
+#endif
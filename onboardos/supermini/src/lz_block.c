@@ -0,0 +1,87 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* LZ Block Codec for Compressed Downloads */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Variables
+   2.0 Compressor
+   3.0 Decompressor
+========================================*/
+
+/* ==================== 1.0 Includes & Variables ==================== */
+#include <string.h>
+#include "lz_block.h"
+
+#define LZ_TAIL 5 // Matches stop this far from the end of the input, as in LZ4, so the block ends on literals
+
+static uint16_t lz_table[1 << LZ_HASH_BITS]; // Last position each 4-byte hash was seen at
+
+static uint32_t rd32(const uint8_t *p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+static uint32_t lz_hash(uint32_t v) { return (v * 2654435761u) >> (32 - LZ_HASH_BITS); }
+static int ext_len(int n) { return n >= 15 ? 1 + (n - 15) / 255 : 0; } // Extra length bytes after a 4-bit field
+
+static uint8_t *put_ext(uint8_t *op, int n) { for(n -= 15; n >= 255; n -= 255) *op++ = 255; *op++ = n; return op; }
+
+/* ==================== 2.0 Compressor ==================== */
+// Greedy single-probe matching, one hash table slot per position. The output bound is checked before each
+// sequence; once the next one would not fit, the block closes with as many literals as the remaining room takes,
+// so incompressible input costs a scan of about out_max bytes rather than of all of it.
+int lz_compress(const uint8_t *in, int in_len, uint8_t *out, int out_max, int *used) {
+    if(in_len > LZ_MAX_OFFSET) in_len = LZ_MAX_OFFSET; // Positions are kept 16-bit; callers stay far below this
+    int ip = 0, anchor = 0, limit = in_len - LZ_TAIL - LZ_MIN_MATCH; uint8_t *op = out, *end = out + out_max;
+    memset(lz_table, 0, sizeof(lz_table));
+    while(ip < limit && ip - anchor < end - op) { // Stop scanning once the pending literals alone would fill the block
+        uint32_t v = rd32(in + ip), h = lz_hash(v); int ref = lz_table[h]; lz_table[h] = ip;
+        if(ref >= ip || rd32(in + ref) != v) { ip++; continue; }
+        int ml = LZ_MIN_MATCH, lit = ip - anchor;
+        while(ip + ml < in_len - LZ_TAIL && in[ref + ml] == in[ip + ml]) ml++;
+        if(op + 1 + ext_len(lit) + lit + 2 + ext_len(ml - LZ_MIN_MATCH) + 1 > end) break; // Keep a byte for the closing token
+        uint8_t *tok = op++; *tok = (lit < 15 ? lit : 15) << 4 | (ml - LZ_MIN_MATCH < 15 ? ml - LZ_MIN_MATCH : 15);
+        if(lit >= 15) op = put_ext(op, lit);
+        memcpy(op, in + anchor, lit); op += lit; *op++ = ip - ref; *op++ = (ip - ref) >> 8;
+        if(ml - LZ_MIN_MATCH >= 15) op = put_ext(op, ml - LZ_MIN_MATCH);
+        ip += ml; anchor = ip;
+    }
+    int lit = in_len - anchor, room = end - op;
+    if(room < 1) { *used = 0; return 0; }
+    if(lit > room - 1 - ext_len(room - 1)) lit = room - 1 - ext_len(room - 1);
+    *op++ = (lit < 15 ? lit : 15) << 4; if(lit >= 15) op = put_ext(op, lit);
+    memcpy(op, in + anchor, lit); op += lit; *used = anchor + lit;
+    return op - out;
+}
+
+/* ==================== 3.0 Decompressor ==================== */
+int lz_decompress(const uint8_t *in, int in_len, uint8_t *out, int out_max) {
+    const uint8_t *ip = in, *iend = in + in_len; uint8_t *op = out, *oend = out + out_max;
+    while(ip < iend) {
+        int tok = *ip++, n = tok >> 4;
+        if(n == 15) { int b; do { if(ip >= iend) return -1; b = *ip++; n += b; } while(b == 255); }
+        if(n > iend - ip || n > oend - op) return -1;
+        memcpy(op, ip, n); op += n; ip += n;
+        if(ip == iend) break; // Literals-only sequence: end of block
+        if(iend - ip < 2) return -1;
+        int off = ip[0] | (ip[1] << 8); ip += 2; n = (tok & 15) + LZ_MIN_MATCH;
+        if((tok & 15) == 15) { int b; do { if(ip >= iend) return -1; b = *ip++; n += b; } while(b == 255); }
+        if(!off || off > op - out || n > oend - op) return -1;
+        for(const uint8_t *m = op - off; n--; ) *op++ = *m++; // Byte by byte: the match may overlap what it writes
+    }
+    return op - out;
+}
@@ -0,0 +1,48 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* LZ Block Codec Header */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Format
+   2.0 Prototypes
+========================================*/
+
+/* ==================== 1.0 Includes & Format ==================== */
+#ifndef LZ_BLOCK_H
+#define LZ_BLOCK_H
+#include <stdint.h>
+
+/* LZ4-style block: a run of sequences, each a token (literal count << 4 | match length - 4), the extra literal count
+   bytes if it was 15 (255 means another byte follows), the literals, then a little-endian 16-bit back offset and the
+   extra match length bytes the same way. The last sequence is literals only and ends the block. There is no
+   dictionary or state between blocks, so every block decodes on its own. */
+#define LZ_MIN_MATCH 4
+#define LZ_MAX_OFFSET 65535
+#define LZ_HASH_BITS 10 // 2 KB match table, cleared per block
+
+/* ==================== 2.0 Prototypes ==================== */
+// Compresses as much of in[0..in_len) as fits in out_max bytes. Returns the block length (0 if out_max cannot hold
+// even a token) and sets *used to the input bytes the block decodes to. Not reentrant: one table, one caller.
+int lz_compress(const uint8_t *in, int in_len, uint8_t *out, int out_max, int *used);
+// Returns the decoded length, or -1 for a corrupt block or one that needs more than out_max bytes
+int lz_decompress(const uint8_t *in, int in_len, uint8_t *out, int out_max);
+
+#endif
@@ -38,6 +38,7 @@
 #include "bluetooth_mode.h"
 #include "recording_mode.h"
 #include "gps_module.h"
+#include "usb_msc.h"
 
 /* ==================== 2.0 Variables & State Logic ==================== */
 led_strip_handle_t led_strip;
@@ -67,6 +68,7 @@ void persistent_led_task(void *pvParameters) {
             case LED_REC_ERROR: led_strip_set_pixel(led_strip, 0, 50, 50, 50); led_strip_refresh(led_strip); vTaskDelay(pdMS_TO_TICKS(1500)); sys_led_state = LED_REC_IDLE; break;
             case LED_SYS_FLOATING: led_strip_set_pixel(led_strip, 0, 50, 50, 50); led_strip_refresh(led_strip); vTaskDelay(pdMS_TO_TICKS(150)); led_strip_clear(led_strip); led_strip_refresh(led_strip); vTaskDelay(pdMS_TO_TICKS(150)); break;
             case LED_SELF_TEST: led_strip_set_pixel(led_strip, 0, 50, 0, 50); led_strip_refresh(led_strip); vTaskDelay(pdMS_TO_TICKS(250)); break;
+            case LED_USB_DISK: led_strip_set_pixel(led_strip, 0, 0, 50, 50); led_strip_refresh(led_strip); vTaskDelay(pdMS_TO_TICKS(250)); break;
         }
     }
 }
@@ -90,7 +92,8 @@ void app_main(void) {
 
     while(1) {
         system_mode_t mode = get_system_mode();
-        if (mode == MODE_BLUETOOTH) { sys_led_state = LED_BT_UNPAIRED; bluetooth_mode_main(); } 
+        if (mode == MODE_BLUETOOTH && usb_msc_pending()) { sys_led_state = LED_USB_DISK; usb_msc_mode_main(); } // One boot only, requested over BLE
+        else if (mode == MODE_BLUETOOTH) { sys_led_state = LED_BT_UNPAIRED; bluetooth_mode_main(); } 
         else if (mode == MODE_RECORDING) { sys_led_state = LED_REC_IDLE; recording_mode_main(); }
         else if (mode == MODE_FLOATING) { sys_led_state = LED_SYS_FLOATING; vTaskDelay(pdMS_TO_TICKS(250)); continue; }
         else if (mode == MODE_SLEEP) { sys_led_state = LED_IDLE; vTaskDelay(pdMS_TO_TICKS(100)); gps_force_sleep(); esp_sleep_enable_timer_wakeup(500000); esp_deep_sleep_start(); }
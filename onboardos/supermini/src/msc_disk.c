@@ -0,0 +1,89 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* USB Mass Storage Block Shim */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes
+   2.0 State & Geometry
+   3.0 Sector Transfers
+========================================*/
+
+/* ==================== 1.0 Includes ==================== */
+#include <string.h>
+#include "msc_disk.h"
+
+/* ==================== 2.0 State & Geometry ==================== */
+void msc_disk_init(msc_disk_t *d, blockdev_t *dev, bool read_only) {
+    memset(d, 0, sizeof(*d)); d->dev = dev; d->read_only = read_only; d->present = dev && dev->sector_count;
+}
+
+bool msc_disk_ready(const msc_disk_t *d) { return d->present; }
+
+void msc_disk_capacity(const msc_disk_t *d, uint32_t *sectors, uint16_t *sector_size) { *sectors = d->present ? d->dev->sector_count : 0; *sector_size = BLOCKDEV_SECTOR_SIZE; }
+
+// START STOP UNIT with LoEj set: Start clear is the host's eject, Start set loads the medium again
+void msc_disk_start_stop(msc_disk_t *d, bool start, bool load_eject) { if(load_eject) d->present = start && d->dev && d->dev->sector_count; }
+
+/* ==================== 3.0 Sector Transfers ==================== */
+// A transfer is len bytes from byte offset within sector lba. TinyUSB hands over whole sectors whenever its endpoint
+// buffer is a multiple of 512, so the middle goes to the device as one multi-sector call and the bounce is rarely used.
+static int32_t check(const msc_disk_t *d, uint32_t lba, uint32_t offset, uint32_t len) {
+    if(!d->present) return MSC_DISK_ERR_NOTREADY;
+    uint64_t end = (uint64_t)lba * BLOCKDEV_SECTOR_SIZE + offset + len;
+    return end > (uint64_t)d->dev->sector_count * BLOCKDEV_SECTOR_SIZE ? MSC_DISK_ERR_RANGE : 0;
+}
+
+// One step of a transfer: every whole sector left in a single device call, or one partial sector through the bounce
+static int32_t read_step(msc_disk_t *d, uint32_t lba, uint32_t offset, uint8_t *out, uint32_t left) {
+    uint32_t whole = offset ? 0 : left / BLOCKDEV_SECTOR_SIZE, n = BLOCKDEV_SECTOR_SIZE - offset;
+    if(whole) { if(d->dev->read(d->dev->ctx, lba, out, whole)) return MSC_DISK_ERR_IO; d->rd_sectors += whole; return whole * BLOCKDEV_SECTOR_SIZE; }
+    if(d->dev->read(d->dev->ctx, lba, d->bounce, 1)) return MSC_DISK_ERR_IO;
+    if(n > left) n = left;
+    memcpy(out, d->bounce + offset, n); d->rd_sectors++; return n;
+}
+
+// Partial sectors are read, patched and written back, so a misaligned host write never clobbers its neighbours
+static int32_t write_step(msc_disk_t *d, uint32_t lba, uint32_t offset, const uint8_t *in, uint32_t left) {
+    uint32_t whole = offset ? 0 : left / BLOCKDEV_SECTOR_SIZE, n = BLOCKDEV_SECTOR_SIZE - offset;
+    if(whole) { if(d->dev->write(d->dev->ctx, lba, in, whole)) return MSC_DISK_ERR_IO; d->wr_sectors += whole; return whole * BLOCKDEV_SECTOR_SIZE; }
+    if(n > left) n = left;
+    if(d->dev->read(d->dev->ctx, lba, d->bounce, 1)) return MSC_DISK_ERR_IO;
+    memcpy(d->bounce + offset, in, n);
+    if(d->dev->write(d->dev->ctx, lba, d->bounce, 1)) return MSC_DISK_ERR_IO;
+    d->wr_sectors++; return n;
+}
+
+// Returns len, or a negative MSC_DISK_ERR_* the caller turns into SCSI sense data
+static int32_t transfer(msc_disk_t *d, bool write, uint32_t lba, uint32_t offset, uint8_t *buf, uint32_t len) {
+    int32_t err = check(d, lba, offset, len), n; uint32_t done = 0;
+    if(!err && write && d->read_only) err = MSC_DISK_ERR_RO;
+    if(err) return err;
+    lba += offset / BLOCKDEV_SECTOR_SIZE; offset %= BLOCKDEV_SECTOR_SIZE;
+    while(done < len) {
+        n = write ? write_step(d, lba, offset, buf + done, len - done) : read_step(d, lba, offset, buf + done, len - done);
+        if(n < 0) { d->errors++; return n; }
+        done += n; lba += (offset + n) / BLOCKDEV_SECTOR_SIZE; offset = (offset + n) % BLOCKDEV_SECTOR_SIZE;
+    }
+    return len;
+}
+
+int32_t msc_disk_read(msc_disk_t *d, uint32_t lba, uint32_t offset, void *buf, uint32_t len) { return transfer(d, false, lba, offset, buf, len); }
+int32_t msc_disk_write(msc_disk_t *d, uint32_t lba, uint32_t offset, const void *buf, uint32_t len) { return transfer(d, true, lba, offset, (uint8_t*)buf, len); }
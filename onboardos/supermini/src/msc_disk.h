@@ -0,0 +1,59 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* USB Mass Storage Block Shim Header */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Definitions
+   2.0 Structs
+   3.0 Prototypes
+========================================*/
+
+/* ==================== 1.0 Includes & Definitions ==================== */
+#ifndef MSC_DISK_H
+#define MSC_DISK_H
+#include <stdint.h>
+#include <stdbool.h>
+#include "blockdev.h"
+
+#define MSC_DISK_ERR_IO       -1 // The card failed the transfer
+#define MSC_DISK_ERR_RANGE    -2 // Past the last sector
+#define MSC_DISK_ERR_NOTREADY -3 // Ejected by the host
+#define MSC_DISK_ERR_RO       -4 // Write to a read-only disk
+
+/* ==================== 2.0 Structs ==================== */
+// The sector-level half of USB mass storage: what the SCSI READ(10)/WRITE(10) callbacks do, minus TinyUSB.
+// Built on blockdev_t like the log store, so it runs on a host against a file-backed image.
+typedef struct {
+    blockdev_t *dev;
+    bool present, read_only;                // present drops once the host ejects the medium
+    uint32_t rd_sectors, wr_sectors, errors;
+    uint8_t bounce[BLOCKDEV_SECTOR_SIZE];   // For the head and tail of a transfer that is not sector aligned
+} msc_disk_t;
+
+/* ==================== 3.0 Prototypes ==================== */
+void msc_disk_init(msc_disk_t *d, blockdev_t *dev, bool read_only);
+bool msc_disk_ready(const msc_disk_t *d);
+void msc_disk_capacity(const msc_disk_t *d, uint32_t *sectors, uint16_t *sector_size);
+void msc_disk_start_stop(msc_disk_t *d, bool start, bool load_eject);
+int32_t msc_disk_read(msc_disk_t *d, uint32_t lba, uint32_t offset, void *buf, uint32_t len);
+int32_t msc_disk_write(msc_disk_t *d, uint32_t lba, uint32_t offset, const void *buf, uint32_t len);
+
+#endif
@@ -24,56 +24,81 @@
    1.0 Includes & Definitions
    2.0 Variables & Structs
    3.0 Hardware Setup & Control
-   4.0 Recording Mode Main
+   4.0 Storage Jobs
+   5.0 Recording Mode Main
 ========================================*/
 
 /* ==================== 1.0 Includes & Definitions ==================== */
 #include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
 #include <sys/unistd.h>
 #include <sys/stat.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "esp_timer.h" 
 #include "esp_log.h"
 #include "driver/i2s_std.h"
 #include "driver/spi_master.h"
-#include "driver/sdspi_host.h"
-#include "esp_vfs_fat.h"
-#include "sdmmc_cmd.h"
 #include "globals.h"
 #include "rtc_module.h"
 #include "config_manager.h"
 #include "gps_module.h"
+#include "audio_convert.h"
+#include "bluetooth_mode.h"
+#include "live_stream.h"
+#include "timebase.h"
+#include "logstore_sd.h"
+#include "retention.h"
+#include "catalog.h"
+#include "storage_service.h"
+#include "stage.h"
+#include "spool.h"
+#include "wav_meta.h"
+#include "elc_writer.h"
+#include "telemetry.h"
+#include "sd_bench.h"
 
-#define MOUNT_POINT "/sdcard"
+#define MOUNT_POINT STORAGE_MOUNT_POINT
+#define REC_DIR MOUNT_POINT "/rec"
 #define SAMPLE_RATE 16000
 #define SAMPLES_PER_READ 1024
 #define WAKEUP_HOLD_TIME_US 500000 
 #define STARTUP_DELAY_SEC 5
+#define SIDE_PERIOD_MS 60      // ADXL sampling for the .elc motion stream, roughly one reading per I2S block
+#define SIDE_ACCEL_BATCH 32    // Accel readings per chunk (~2 s), keeping the 16-byte chunk header small beside them
+#define SIDE_GPS_PERIOD_US 1000000
+
+enum { ELC_S_AUDIO, ELC_S_ACCEL, ELC_S_GPS, ELC_S_EVENT }; // Stream ids in every .elc file this firmware writes
 
 /* ==================== 2.0 Variables & Structs ==================== */
 static spi_device_handle_t adxl_spi_handle = NULL;
-static sdmmc_card_t *card = NULL;
 static i2s_chan_handle_t g_rx_handle = NULL;
+static char day_dir[32] = {0}; // Last rec/YYYY/MM/DD known to exist, so mkdir only runs when the date changes
+static uint8_t tbas_buf[TIMEBASE_CHUNK_MAX];
+static uint8_t hdr_buf[WAV_META_HDR_SIZE]; // Header for the clip being written: placeholder at open, final sizes at close
+static volatile bool side_on = false, side_quit = false; static int64_t side_t0 = 0; static SemaphoreHandle_t side_done = NULL; static TaskHandle_t side_h = NULL; // .elc sensor task handshake
 
+// One clip's state as handed to the storage task; the open and close jobs each run as a single queued request
 typedef struct {
-    char riff[4]; uint32_t overall_size; char wave[4]; char fmt_chunk_marker[4];
-    uint32_t length_of_fmt; uint16_t format_type; uint16_t channels;
-    uint32_t sample_rate; uint32_t byterate; uint16_t block_align;
-    uint16_t bits_per_sample; char data_chunk_header[4]; uint32_t data_size;
-} wav_header_t;
+    const device_config_t *cfg; struct tm ti; time_t now; uint16_t channels; bool log, rollover;
+    uint64_t clip_bytes, min_clip_bytes; uint32_t data_bytes, extra, bytes_per_sec;
+    char stem[64], filename[128]; int fd; wav_meta_t meta;
+    bool elc; uint64_t elc_audio; int64_t end_us; // .elc backend: audio bytes written so far, clip length
+} clip_t;
+typedef struct { const void *buf; size_t len; } clip_block_t;
 
 /* ==================== 3.0 Hardware Setup & Control ==================== */
-static void park_cs_pins() { gpio_set_direction(SD_PIN_NUM_CS, GPIO_MODE_OUTPUT); gpio_set_level(SD_PIN_NUM_CS, 1); gpio_set_direction(ADXL_PIN_NUM_CS, GPIO_MODE_OUTPUT); gpio_set_level(ADXL_PIN_NUM_CS, 1); }
 static void adxl_write_reg(uint8_t reg, uint8_t value) { if(!adxl_spi_handle) return; spi_transaction_t t; memset(&t, 0, sizeof(t)); t.length = 8 * 3; t.flags = SPI_TRANS_USE_TXDATA; t.tx_data[0] = 0x0A; t.tx_data[1] = reg; t.tx_data[2] = value; spi_device_polling_transmit(adxl_spi_handle, &t); }
+// XDATA_L..ZDATA_H in one burst: 12-bit readings arrive sign-extended, 1 mg/LSB at the default +-2 g range
+static bool adxl_read_xyz(int16_t *xyz) { if(!adxl_spi_handle) return false; uint8_t tx[8] = { 0x0B, 0x0E }, rx[8]; spi_transaction_t t; memset(&t, 0, sizeof(t)); t.length = 8 * 8; t.tx_buffer = tx; t.rx_buffer = rx; if(spi_device_polling_transmit(adxl_spi_handle, &t) != ESP_OK) return false; memcpy(xyz, rx + 2, 6); return true; }
 static uint8_t adxl_read_reg(uint8_t reg) { if(!adxl_spi_handle) return 0; spi_transaction_t t; memset(&t, 0, sizeof(t)); t.length = 8 * 3; t.flags = SPI_TRANS_USE_TXDATA | SPI_TRANS_USE_RXDATA; t.tx_data[0] = 0x0B; t.tx_data[1] = reg; t.tx_data[2] = 0; spi_device_polling_transmit(adxl_spi_handle, &t); return t.rx_data[2]; }
 
+// SPI2 is brought up by the storage service, which shares it with the SD card and frees it once neither is attached
 void init_adxl(device_config_t *cfg) {
-    park_cs_pins();
-    spi_bus_config_t buscfg = {.miso_io_num = SPI_PIN_NUM_MISO, .mosi_io_num = SPI_PIN_NUM_MOSI, .sclk_io_num = SPI_PIN_NUM_CLK, .quadwp_io_num = -1, .quadhd_io_num = -1, .max_transfer_sz = 32};
     spi_device_interface_config_t devcfg = {.clock_speed_hz = 1 * 1000 * 1000, .mode = 0, .spics_io_num = ADXL_PIN_NUM_CS, .queue_size = 1};
-    spi_bus_initialize(SPI2_HOST, &buscfg, SPI_DMA_CH_AUTO); spi_bus_add_device(SPI2_HOST, &devcfg, &adxl_spi_handle);
+    storage_bus_acquire(); spi_bus_add_device(SPI2_HOST, &devcfg, &adxl_spi_handle);
     gpio_config_t int_conf = {.intr_type = GPIO_INTR_DISABLE, .mode = GPIO_MODE_INPUT, .pin_bit_mask = (1ULL << ADXL_PIN_NUM_INT1), .pull_down_en = 0, .pull_up_en = 0}; gpio_config(&int_conf);
 
     adxl_write_reg(0x1F, 0x52); vTaskDelay(pdMS_TO_TICKS(50)); 
@@ -84,76 +109,231 @@ void init_adxl(device_config_t *cfg) {
     vTaskDelay(pdMS_TO_TICKS(100)); adxl_read_reg(0x0B);
 }
 
-void deinit_adxl() { if(adxl_spi_handle) { spi_bus_remove_device(adxl_spi_handle); adxl_spi_handle = NULL; } spi_bus_free(SPI2_HOST); }
-
-bool init_sd_card() {
-    park_cs_pins();
-    esp_vfs_fat_sdmmc_mount_config_t mount_config = {.format_if_mount_failed=false, .max_files=5, .allocation_unit_size=16*1024};
-    gpio_set_pull_mode(SPI_PIN_NUM_MISO, GPIO_PULLUP_ONLY); gpio_set_pull_mode(SPI_PIN_NUM_MOSI, GPIO_PULLUP_ONLY); gpio_set_pull_mode(SPI_PIN_NUM_CLK, GPIO_PULLUP_ONLY); 
-    sdmmc_host_t host = SDSPI_HOST_DEFAULT(); host.slot = SPI2_HOST; host.max_freq_khz = 20000;
-    spi_bus_config_t bus_cfg = {.mosi_io_num=SPI_PIN_NUM_MOSI, .miso_io_num=SPI_PIN_NUM_MISO, .sclk_io_num=SPI_PIN_NUM_CLK, .quadwp_io_num=-1, .quadhd_io_num=-1, .max_transfer_sz=4096+8};
-    spi_bus_initialize(host.slot, &bus_cfg, SPI_DMA_CH_AUTO);
-    sdspi_device_config_t slot_config = SDSPI_DEVICE_CONFIG_DEFAULT(); slot_config.gpio_cs=SD_PIN_NUM_CS; slot_config.host_id=host.slot;
-    esp_err_t ret = esp_vfs_fat_sdspi_mount(MOUNT_POINT, &host, &slot_config, &mount_config, &card);
-    if (ret != ESP_OK) { spi_bus_free(host.slot); return false; }
-    return true;
+void deinit_adxl() { if(adxl_spi_handle) { spi_bus_remove_device(adxl_spi_handle); adxl_spi_handle = NULL; storage_bus_release(); } }
+
+// Recordings are sharded into rec/YYYY/MM/DD so no FAT directory grows past a day's worth of LFN entries
+static bool ensure_day_dir(const struct tm *ti, char *out, size_t len) {
+    snprintf(out, len, "%s/%04d/%02d/%02d", REC_DIR, ti->tm_year+1900, ti->tm_mon+1, ti->tm_mday);
+    if(!strcmp(out, day_dir)) return true;
+    char p[32]; size_t cut[] = { strlen(REC_DIR), strlen(REC_DIR) + 5, strlen(REC_DIR) + 8, strlen(out) };
+    for(int i = 0; i < 4; i++) { memcpy(p, out, cut[i]); p[cut[i]] = 0; mkdir(p, 0775); } // EEXIST is the common case
+    struct stat st; if(stat(out, &st) || !S_ISDIR(st.st_mode)) return false;
+    snprintf(day_dir, sizeof(day_dir), "%s", out); return true;
 }
 
-void deinit_sd_card() { if(card) { esp_vfs_fat_sdcard_unmount(MOUNT_POINT, card); card = NULL; } spi_bus_free(SPI2_HOST); }
+// Only the plain left-mic mode keeps the bus in mono; the others read both slots (second SPH0645 with SEL high on the right)
+void init_mic(uint8_t mic_mode) {
+    bool both = (mic_mode != MIC_MODE_LEFT);
+    i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(I2S_NUM_0, I2S_ROLE_MASTER); i2s_new_channel(&chan_cfg, NULL, &g_rx_handle);
+    i2s_std_config_t std_cfg = { .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(SAMPLE_RATE), .slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_32BIT, both ? I2S_SLOT_MODE_STEREO : I2S_SLOT_MODE_MONO), .gpio_cfg = { .mclk=I2S_GPIO_UNUSED, .bclk=I2S_BCK_PIN, .ws=I2S_WS_PIN, .dout=I2S_GPIO_UNUSED, .din=I2S_DATA_PIN, .invert_flags={0} } };
+    std_cfg.slot_cfg.slot_mask = both ? I2S_STD_SLOT_BOTH : I2S_STD_SLOT_LEFT; i2s_channel_init_std_mode(g_rx_handle, &std_cfg); i2s_channel_enable(g_rx_handle);
+}
 
-void write_wav_header(FILE *f, uint32_t data_size) {
-    wav_header_t header; memcpy(header.riff, "RIFF", 4); header.overall_size = data_size + 36; memcpy(header.wave, "WAVE", 4); memcpy(header.fmt_chunk_marker, "fmt ", 4);
-    header.length_of_fmt = 16; header.format_type = 1; header.channels = 1; header.sample_rate = SAMPLE_RATE; header.bits_per_sample = 16;
-    header.byterate = SAMPLE_RATE * 1 * 16 / 8; header.block_align = 1 * 16 / 8; memcpy(header.data_chunk_header, "data", 4); header.data_size = data_size;
-    fseek(f, 0, SEEK_SET); fwrite(&header, sizeof(wav_header_t), 1, f);
+// Converts one I2S read into PCM16 for the WAV file and returns the number of int16 samples written
+static int convert_block(uint8_t mic_mode, const int32_t *in, size_t words, int16_t *out) {
+    switch(mic_mode) {
+        case MIC_MODE_RIGHT:  audio_select_channel(in, out, words / 2, 1); return words / 2;
+        case MIC_MODE_SUM:    audio_sum_channels(in, out, words / 2); return words / 2;
+        case MIC_MODE_STEREO: audio_convert_stereo(in, out, words / 2); return (words / 2) * 2;
+        default:              audio_convert_mono(in, out, words); return words;
+    }
 }
 
-void init_mic() {
-    i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(I2S_NUM_0, I2S_ROLE_MASTER); i2s_new_channel(&chan_cfg, NULL, &g_rx_handle);
-    i2s_std_config_t std_cfg = { .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(SAMPLE_RATE), .slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_32BIT, I2S_SLOT_MODE_MONO), .gpio_cfg = { .mclk=I2S_GPIO_UNUSED, .bclk=I2S_BCK_PIN, .ws=I2S_WS_PIN, .dout=I2S_GPIO_UNUSED, .din=I2S_DATA_PIN, .invert_flags={0} } };
-    std_cfg.slot_cfg.slot_mask = I2S_STD_SLOT_LEFT; i2s_channel_init_std_mode(g_rx_handle, &std_cfg); i2s_channel_enable(g_rx_handle);
+// .elc motion and position streams. Runs beside the recording loop so the SPI reads (which wait whenever the SD card
+// holds the shared bus) never delay an I2S read; chunks are only posted, and go out with the next audio burst.
+static void side_task(void *arg) {
+    elc_accel_t acc[SIDE_ACCEL_BATCH]; int n = 0; int64_t batch_t = 0, next_gps = 0; bool was_on = false;
+    while(!side_quit) {
+        if(side_on) {
+            int64_t t = esp_timer_get_time() - side_t0; int16_t xyz[3]; gps_fix_t fix;
+            if(!was_on) { n = 0; next_gps = 0; was_on = true; }
+            if(adxl_read_xyz(xyz)) { if(!n) batch_t = t; acc[n++] = (elc_accel_t){ .dt_us = t - batch_t, .x = xyz[0], .y = xyz[1], .z = xyz[2] }; }
+            if(n == SIDE_ACCEL_BATCH) { elc_post(ELC_S_ACCEL, batch_t, acc, sizeof(acc)); n = 0; }
+            if(t >= next_gps) { if(gps_get_fix(&fix)) { elc_gps_t g = { .lat_e7 = fix.lat * 1e7, .lon_e7 = fix.lon * 1e7, .quality = fix.quality, .sats = fix.sats, .hdop_x10 = fix.hdop_x10 }; elc_post(ELC_S_GPS, t, &g, sizeof(g)); } next_gps = t + SIDE_GPS_PERIOD_US; }
+        }
+        else if(was_on) { if(n) elc_post(ELC_S_ACCEL, batch_t, acc, n * sizeof(acc[0])); n = 0; was_on = false; xSemaphoreGive(side_done); }
+        vTaskDelay(pdMS_TO_TICKS(SIDE_PERIOD_MS));
+    }
+    side_h = NULL; vTaskDelete(NULL);
 }
 
-/* ==================== 4.0 Recording Mode Main ==================== */
+// Stops the sensor streams for the closing clip, waiting for the last partial accel batch to be posted
+static void side_stop(void) { if(!side_on) return; side_on = false; xSemaphoreTake(side_done, pdMS_TO_TICKS(500)); }
+
+/* ==================== 4.0 Storage Jobs ==================== */
+// Everything below runs on the storage task via storage_call; the file requests inside a job execute inline
+// Warms the day-directory cache and runs retention (including the one-time free-space scan) before the first trigger
+static int warm_job(void *arg) {
+    clip_t *c = arg; char dir[32]; ensure_day_dir(&c->ti, dir, sizeof(dir));
+    retention_enforce(c->clip_bytes, c->cfg->reserve_mb, c->cfg->quota_mb); return 0;
+}
+
+// .elc backend: audio, ADXL motion, GPS fixes and clip events as timestamped streams in one file. The "elog" block
+// opens the file so the meta command finds it in the first few hundred bytes, as with a WAV.
+static int elc_open(clip_t *c) {
+    const elc_stream_decl_t decls[] = {
+        { .id = ELC_S_AUDIO, .kind = ELC_KIND_AUDIO, .channels = c->channels, .rate_hz = SAMPLE_RATE, .bits = 16, .record_size = c->channels * 2, .name = "audio" },
+        { .id = ELC_S_ACCEL, .kind = ELC_KIND_ACCEL, .channels = 3, .rate_hz = 1000 / SIDE_PERIOD_MS, .bits = 16, .record_size = sizeof(elc_accel_t), .name = "adxl362" },
+        { .id = ELC_S_GPS, .kind = ELC_KIND_GPS, .rate_hz = 0, .record_size = sizeof(elc_gps_t), .name = "pa1010d" },
+        { .id = ELC_S_EVENT, .kind = ELC_KIND_EVENT, .rate_hz = 0, .record_size = 0, .name = "events" } };
+    if(!elc_begin(c->fd, (int64_t)c->now * 1000000, decls, sizeof(decls) / sizeof(decls[0])) || elc_write_meta("elog", &c->meta, sizeof(c->meta))) {
+        storage_close(c->fd, STORAGE_PRIO_RECORD); storage_delete(c->filename, STORAGE_PRIO_RECORD); c->fd = -1; return -1;
+    }
+    return 0;
+}
+
+// Returns 1 when the card is full of locked files, so the caller blinks the error LED instead of looping on empty clips
+static int clip_open_job(void *arg) {
+    clip_t *c = arg; logstore_t *log = (c->cfg->storage_backend == STORAGE_LOG) ? logstore_sd_get() : NULL; c->fd = -1; c->log = false; c->elc = false;
+    // Log backend: one append-only entry per clip, no FAT metadata updates while recording
+    if(log) { logstore_meta_t meta = { .start_time = c->now, .sample_rate = SAMPLE_RATE, .channels = c->channels, .bits = 16 }; strncpy(meta.name, c->stem, sizeof(meta.name) - 1); if(!logstore_begin(log, &meta)) { c->log = true; return 0; } }
+    char dir[32]; if(!ensure_day_dir(&c->ti, dir, sizeof(dir))) strcpy(dir, MOUNT_POINT); // Root as a last resort
+    c->elc = (c->cfg->storage_backend == STORAGE_ELC); c->elc_audio = 0;
+    snprintf(c->filename, sizeof(c->filename), "%s/%s.%s", dir, c->stem, c->elc ? "elc" : "wav");
+    retention_enforce(c->clip_bytes, c->cfg->reserve_mb, c->cfg->quota_mb); // Normally a no-op: the previous clip already made room
+    if(!retention_can_write(c->min_clip_bytes)) return 1;
+    catalog_begin(c->filename + strlen(MOUNT_POINT) + 1);
+    if((c->fd = storage_open(c->filename, "wb", STORAGE_PRIO_RECORD)) < 0) return -1;
+    if(c->elc) return elc_open(c);
+    wav_meta_build(hdr_buf, &c->meta, c->stem, 0, 0); storage_append(c->fd, hdr_buf, sizeof(hdr_buf), STORAGE_PRIO_RECORD);
+    return 0;
+}
+
+static int log_append_job(void *arg) { clip_block_t *b = arg; logstore_t *log = logstore_sd_get(); return log ? logstore_append(log, b->buf, b->len) : -1; }
+
+// Staging sinks, called from the flush task with one burst at a time; len 0 ends the burst
+static int fat_sink(const void *buf, size_t len, void *ctx) { clip_t *c = ctx; return len ? storage_append(c->fd, buf, len, STORAGE_PRIO_RECORD) : storage_sync(c->fd, STORAGE_PRIO_RECORD); }
+static int elc_sink(const void *buf, size_t len, void *ctx) {
+    clip_t *c = ctx; if(!len) return storage_sync(c->fd, STORAGE_PRIO_RECORD);
+    int64_t t_us = (int64_t)(c->elc_audio * 1000000 / c->bytes_per_sec); // Sample clock, so audio chunk times never drift from the data
+    if(elc_write(ELC_S_AUDIO, t_us, buf, len)) return -1;
+    c->elc_audio += len; return len;
+}
+static int log_sink(const void *buf, size_t len, void *ctx) { clip_block_t b = { buf, len }; return (!len || !storage_call(log_append_job, &b, STORAGE_VOL_LOG, STORAGE_PRIO_RECORD)) ? (int)len : -1; }
+
+// Clips spooled to flash while the card was missing become ordinary date-sharded, catalogued recordings
+static int spool_replay_job(void *arg) {
+    clip_t *c = arg; uint8_t *buf = malloc(4096); const spool_entry_t *e;
+    while(buf && (e = spool_entry(0))) {
+        struct tm ti; time_t t = e->start_time; localtime_r(&t, &ti); char dir[32], path[128]; bool ok;
+        if(!ensure_day_dir(&ti, dir, sizeof(dir))) strcpy(dir, MOUNT_POINT);
+        snprintf(path, sizeof(path), "%s/%s.wav", dir, e->stem);
+        retention_enforce(e->len + WAV_META_HDR_SIZE, c->cfg->reserve_mb, c->cfg->quota_mb);
+        if(!retention_can_write(e->len + WAV_META_HDR_SIZE)) break;
+        catalog_rec_t cr = { .format = CAT_FMT_WAV_PCM16, .channels = e->channels, .size = WAV_META_HDR_SIZE + e->len, .duration_ms = (uint64_t)e->len * 1000 / (e->sample_rate * 2 * e->channels), .sample_rate = e->sample_rate };
+        strncpy(cr.path, path + strlen(MOUNT_POINT) + 1, sizeof(cr.path) - 1); catalog_fill_from_name(&cr, cr.path); cr.start_time = e->start_time;
+        // The spool keeps no fix or settings, so only what the name carries goes into the metadata
+        wav_meta_t m; wav_meta_capture(&m, NULL, WAV_TRIG_SPOOL, e->start_time, e->sample_rate, e->channels);
+        m.fix_quality = m.sats = m.time_source = WAV_META_UNKNOWN; m.hdop_x10 = 0; m.lat_e7 = cr.lat_e7; m.lon_e7 = cr.lon_e7;
+        catalog_begin(cr.path); int fd = storage_open(path, "wb", STORAGE_PRIO_RECORD); if(fd < 0) break;
+        wav_meta_build(buf, &m, e->stem, e->len, 0); ok = storage_append(fd, buf, WAV_META_HDR_SIZE, STORAGE_PRIO_RECORD) == WAV_META_HDR_SIZE;
+        for(uint32_t off = 0, n; ok && off < e->len; off += n) { n = (e->len - off < 4096) ? e->len - off : 4096; ok = !spool_read(e, off, buf, n) && storage_append(fd, buf, n, STORAGE_PRIO_RECORD) == (int)n; }
+        if(storage_close(fd, STORAGE_PRIO_RECORD) || !ok) break;
+        catalog_add(&cr); retention_note_write(cr.size, true); spool_mark_replayed(e);
+    }
+    free(buf); return spool_count();
+}
+
+static int clip_close_job(void *arg) {
+    clip_t *c = arg;
+    if(c->log) { logstore_t *log = logstore_sd_get(); if(log) logstore_end(log); return 0; } // The WAV header is synthesized on export; log entries carry no tbas chunk
+    if(c->elc) {
+        if(c->extra) elc_write_meta("tbas", tbas_buf, c->extra); // The same RIFF chunk a WAV clip ends with
+        int size = elc_finish(c->end_us); storage_close(c->fd, STORAGE_PRIO_RECORD); c->fd = -1; if(size < 0) return catalog_add_file(c->filename + strlen(MOUNT_POINT) + 1, CAT_FLAG_PARTIAL);
+        catalog_rec_t cr = { .format = CAT_FMT_ELC, .channels = c->channels, .size = size, .duration_ms = c->end_us / 1000, .sample_rate = SAMPLE_RATE };
+        strncpy(cr.path, c->filename + strlen(MOUNT_POINT) + 1, sizeof(cr.path) - 1); catalog_fill_from_name(&cr, cr.path); cr.start_time = c->now; catalog_add(&cr);
+        retention_note_write(cr.size, true); if(!c->rollover) retention_enforce(c->clip_bytes, c->cfg->reserve_mb, c->cfg->quota_mb);
+        return 0;
+    }
+    c->meta.effective_rate_mhz = timebase_effective_rate_mhz(); wav_meta_build(hdr_buf, &c->meta, c->stem, c->data_bytes, c->extra);
+    if(c->extra) storage_append(c->fd, tbas_buf, c->extra, STORAGE_PRIO_RECORD);
+    storage_write_at(c->fd, 0, hdr_buf, sizeof(hdr_buf), STORAGE_PRIO_RECORD); storage_close(c->fd, STORAGE_PRIO_RECORD); c->fd = -1;
+    catalog_rec_t cr = { .format = CAT_FMT_WAV_PCM16, .channels = c->channels, .size = WAV_META_HDR_SIZE + c->data_bytes + c->extra, .duration_ms = (uint64_t)c->data_bytes * 1000 / c->bytes_per_sec, .sample_rate = SAMPLE_RATE };
+    strncpy(cr.path, c->filename + strlen(MOUNT_POINT) + 1, sizeof(cr.path) - 1); catalog_fill_from_name(&cr, cr.path); cr.start_time = c->now; catalog_add(&cr);
+    retention_note_write(cr.size, true); if(!c->rollover) retention_enforce(c->clip_bytes, c->cfg->reserve_mb, c->cfg->quota_mb); // Make room for the next clip now
+    return 0;
+}
+
+/* ==================== 5.0 Recording Mode Main ==================== */
+// The ADXL stays armed for the whole mode: INT1 is mapped to AWAKE, so it reads high while motion continues and
+// drops once the configured inactivity (accel_inact_thresh / accel_inact_time) has elapsed
 void recording_mode_main(void) {
-    rtc_init_and_sync(); init_mic(); gps_init(); device_config_t cfg; load_config(&cfg);
+    device_config_t cfg; load_config(&cfg); rtc_init_and_sync(); init_mic(cfg.mic_mode); gps_init();
+    uint16_t channels = (cfg.mic_mode == MIC_MODE_STEREO) ? 2 : 1; size_t slot_words = SAMPLES_PER_READ * ((cfg.mic_mode == MIC_MODE_LEFT) ? 1 : 2);
+    int64_t min_us = (int64_t)cfg.record_length_sec * 1000000, max_us = (int64_t)((cfg.record_max_sec > cfg.record_length_sec) ? cfg.record_max_sec : cfg.record_length_sec) * 1000000;
+    uint64_t bytes_per_sec = (uint64_t)SAMPLE_RATE * 2 * channels, clip_bytes = bytes_per_sec * (max_us / 1000000), min_clip_bytes = bytes_per_sec * (min_us / 1000000);
+    clip_t clip = { .cfg = &cfg, .channels = channels, .clip_bytes = clip_bytes, .min_clip_bytes = min_clip_bytes, .bytes_per_sec = bytes_per_sec, .fd = -1 };
+    bool rollover = false;
+    // The card stays mounted for the whole mode; the storage task owns it and the clip loop only queues requests.
+    // Audio is staged in RAM and written in bursts of stage_flush_sec, with the flash spool behind it when the card is gone
+    // A card that has been through sdbench sets the append size and stall slack from its own measured profile
+    storage_start(); bool mounted = storage_mount(); sd_profile_t prof;
+    if(mounted && sd_bench_load_profile(storage_card(), &prof)) stage_tune(prof.block, (prof.max_us + 999) / 1000);
+    stage_begin(bytes_per_sec, cfg.stage_flush_sec);
+    if(mounted) {
+        if(cfg.storage_backend != STORAGE_LOG) { time(&clip.now); localtime_r(&clip.now, &clip.ti); storage_call(warm_job, &clip, STORAGE_VOL_FAT, STORAGE_PRIO_RECORD); }
+        if(spool_count()) storage_call(spool_replay_job, &clip, STORAGE_VOL_FAT, STORAGE_PRIO_RECORD);
+    }
+    init_adxl(&cfg); telemetry_start(); // Temperature, motion level and GPS history, whether or not anything triggers
+    if(cfg.storage_backend == STORAGE_ELC) { if(!side_done) side_done = xSemaphoreCreateBinary(); side_quit = false; xTaskCreate(side_task, "elc_side", 4096, NULL, 3, &side_h); }
+    if(cfg.live_stream) { ble_server_start(false); live_stream_start(); }
     while(get_system_mode() == MODE_RECORDING) {
-        sys_led_state = LED_REC_IDLE; init_adxl(&cfg); bool triggered = false;
-        while(get_system_mode() == MODE_RECORDING) {
-            if(gpio_get_level(ADXL_PIN_NUM_INT1) == 1) {
-                int64_t start = esp_timer_get_time(); bool holds = true;
-                while((esp_timer_get_time() - start) < WAKEUP_HOLD_TIME_US) { if(gpio_get_level(ADXL_PIN_NUM_INT1) == 0) { holds = false; break; } vTaskDelay(pdMS_TO_TICKS(10)); }
-                if(holds) { triggered = true; adxl_read_reg(0x0B); break; }
+        bool triggered = rollover;
+        if(!rollover) {
+            sys_led_state = LED_REC_IDLE;
+            while(get_system_mode() == MODE_RECORDING) {
+                if(gpio_get_level(ADXL_PIN_NUM_INT1) == 1) {
+                    int64_t start = esp_timer_get_time(); bool holds = true;
+                    while((esp_timer_get_time() - start) < WAKEUP_HOLD_TIME_US) { if(gpio_get_level(ADXL_PIN_NUM_INT1) == 0) { holds = false; break; } vTaskDelay(pdMS_TO_TICKS(10)); }
+                    if(holds) { triggered = true; adxl_read_reg(0x0B); break; }
+                }
+                vTaskDelay(pdMS_TO_TICKS(50));
             }
-            vTaskDelay(pdMS_TO_TICKS(50));
         }
-        deinit_adxl();
         if(triggered && get_system_mode() == MODE_RECORDING) {
-            sys_led_state = LED_REC_STARTUP;
-            for(int i = 0; i < STARTUP_DELAY_SEC * 10; i++) { if(get_system_mode() != MODE_RECORDING) break; vTaskDelay(pdMS_TO_TICKS(100)); }
-            if(get_system_mode() != MODE_RECORDING) continue;
+            if(!rollover) {
+                sys_led_state = LED_REC_STARTUP;
+                for(int i = 0; i < STARTUP_DELAY_SEC * 10; i++) { if(get_system_mode() != MODE_RECORDING) break; vTaskDelay(pdMS_TO_TICKS(100)); }
+                if(get_system_mode() != MODE_RECORDING) continue;
+            }
+            uint8_t trigger = rollover ? WAV_TRIG_ROLLOVER : WAV_TRIG_MOTION; rollover = false;
             
-            if(!init_sd_card()) { sys_led_state = LED_REC_ERROR; vTaskDelay(pdMS_TO_TICKS(1500)); continue; }
+            time(&clip.now); localtime_r(&clip.now, &clip.ti);
+            char gps_str[32]; gps_get_coords_str(gps_str); struct tm *ti = &clip.ti;
+            snprintf(clip.stem, sizeof(clip.stem), "%04d%02d%02d_%02d%02d%02d_%s", ti->tm_year+1900, ti->tm_mon+1, ti->tm_mday, ti->tm_hour, ti->tm_min, ti->tm_sec, gps_str);
+            wav_meta_capture(&clip.meta, &cfg, trigger, clip.now, SAMPLE_RATE, channels);
+            int opened = storage_mount() ? storage_call(clip_open_job, &clip, (cfg.storage_backend == STORAGE_LOG) ? STORAGE_VOL_LOG : STORAGE_VOL_FAT, STORAGE_PRIO_RECORD) : -1;
+            bool spool_only = opened < 0; // No card, or it would not take the file: the clip goes to the flash spool instead
+            // Full of locked files, or no card and no spool room: error blink, and no rollover loop of empty clips
+            if(opened > 0 || (spool_only && !spool_free_bytes())) { rollover = false; sys_led_state = LED_REC_ERROR; vTaskDelay(pdMS_TO_TICKS(1500)); continue; }
             sys_led_state = LED_REC_ACTIVE;
-            
-            char filename[128]; time_t now; struct tm ti; time(&now); localtime_r(&now, &ti);            
-            char gps_str[32]; gps_get_coords_str(gps_str);
-            snprintf(filename, sizeof(filename), "%s/%04d%02d%02d_%02d%02d%02d_%s.wav", MOUNT_POINT, ti.tm_year+1900, ti.tm_mon+1, ti.tm_mday, ti.tm_hour, ti.tm_min, ti.tm_sec, gps_str);            
-            FILE *f = fopen(filename, "wb");
-            if(f) {
-                write_wav_header(f, 0); int32_t *i2s_buf = calloc(SAMPLES_PER_READ, 4); int16_t *wav_buf = calloc(SAMPLES_PER_READ, 2); size_t br = 0; uint32_t tot_bytes = 0;
-                int64_t end_t = esp_timer_get_time() + ((int64_t)cfg.record_length_sec * 1000000);
-                while(esp_timer_get_time() < end_t && get_system_mode() == MODE_RECORDING) {
-                    if(i2s_channel_read(g_rx_handle, i2s_buf, SAMPLES_PER_READ * 4, &br, 100) == ESP_OK) {
-                        int smp = br / 4; for(int i=0; i<smp; i++) wav_buf[i] = (int16_t)(i2s_buf[i] >> 14);
-                        fwrite(wav_buf, 2, smp, f); tot_bytes += smp * 2;
-                    }
+            stage_open(spool_only ? NULL : clip.log ? log_sink : clip.elc ? elc_sink : fat_sink, &clip, clip.stem, clip.now, SAMPLE_RATE, channels);
+            int32_t *i2s_buf = calloc(slot_words, 4); int16_t *wav_buf = calloc(slot_words, 2); size_t br = 0; uint32_t tot_bytes = 0;
+            timebase_start_clip(SAMPLE_RATE); size_t words_per_frame = (cfg.mic_mode == MIC_MODE_LEFT) ? 1 : 2;
+            int64_t start_t = esp_timer_get_time(), min_t = start_t + min_us, max_t = start_t + max_us; const char *why = "mode";
+            bool elc = clip.elc && !spool_only; if(elc) { side_t0 = start_t; side_on = true; elc_post_event(ELC_S_EVENT, 0, ELC_EV_START, trigger == WAV_TRIG_ROLLOVER ? "rollover" : "motion"); }
+            while(get_system_mode() == MODE_RECORDING) {
+                int64_t t = esp_timer_get_time(); bool active = gpio_get_level(ADXL_PIN_NUM_INT1) == 1;
+                if(t >= max_t) { rollover = active; why = "cap"; break; } // Cap reached mid-event: start the next file straight away
+                if(!spool_only && !clip.log && !retention_can_write(tot_bytes + slot_words * 2)) { rollover = active; why = "card_full"; break; } // Close before the card fills; the next clip starts after eviction
+                if(t >= min_t && !active) { why = "inactive"; break; } // ADXL has seen accel_inact_time of quiet
+                if(i2s_channel_read(g_rx_handle, i2s_buf, slot_words * 4, &br, 100) == ESP_OK) {
+                    timebase_on_samples(br / 4 / words_per_frame);
+                    int smp = convert_block(cfg.mic_mode, i2s_buf, br / 4, wav_buf);
+                    stage_write(wav_buf, smp * 2); tot_bytes += smp * 2;
+                    live_stream_push(wav_buf, smp, channels); // After staging, and never blocks
                 }
-                write_wav_header(f, tot_bytes); fclose(f); free(i2s_buf); free(wav_buf);
             }
-            deinit_sd_card();
+            clip.end_us = esp_timer_get_time() - start_t;
+            if(elc) { side_stop(); elc_post_event(ELC_S_EVENT, clip.end_us, !strcmp(why, "card_full") ? ELC_EV_CARD_FULL : rollover ? ELC_EV_ROLLOVER : ELC_EV_STOP, why); }
+            clip.data_bytes = stage_close(); clip.rollover = rollover; // Bytes that reached the card; the rest, if any, was spooled
+            if(!spool_only) { clip.extra = clip.log ? 0 : timebase_build_chunk(tbas_buf, sizeof(tbas_buf)); storage_call(clip_close_job, &clip, clip.log ? STORAGE_VOL_LOG : STORAGE_VOL_FAT, STORAGE_PRIO_RECORD); }
+            if(!rollover && spool_count() && storage_mount()) storage_call(spool_replay_job, &clip, STORAGE_VOL_FAT, STORAGE_PRIO_RECORD);
+            free(i2s_buf); free(wav_buf);
         }
     }
+    side_quit = true; for(int i = 0; side_h && i < 50; i++) vTaskDelay(pdMS_TO_TICKS(10)); // Off the SPI bus before the ADXL is removed
+    telemetry_stop(); deinit_adxl(); stage_end(); storage_stop(); if(cfg.live_stream) live_stream_stop();
     i2s_channel_disable(g_rx_handle); i2s_del_channel(g_rx_handle);
     gps_deinit(); 
     return;
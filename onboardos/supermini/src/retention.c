@@ -0,0 +1,136 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Storage Quota and Oldest-First Retention */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Variables
+   2.0 Space Accounting
+   3.0 Oldest-First Eviction
+   4.0 Locks & Stats
+========================================*/
+
+/* ==================== 1.0 Includes & Variables ==================== */
+#include <stdio.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "ff.h"
+#include "diskio_impl.h"
+#include "diskio_sdmmc.h"
+#include "retention.h"
+#include "catalog.h"
+
+#define RET_DIR "/rec"              // Same tree recording_mode.c shards into (REC_DIR, relative to the volume)
+#define RET_FLOOR_BYTES (1 << 20)   // Headroom a running clip never writes into, even with a zero reserve
+
+static const char *TAG = "RETENTION";
+static char drv[4] = "0:";
+static bool scanned = false;
+static uint64_t total_bytes = 0, free_bytes = 0, rec_bytes = 0, evicted_bytes = 0;
+static uint32_t cluster = 0, rec_files = 0, evicted_files = 0, scan_ms = 0;
+
+/* ==================== 2.0 Space Accounting ==================== */
+// Free space is read once per boot and then kept up to date from the writes and deletes this firmware makes,
+// so nothing after the first scan ever needs f_getfree (a full FAT walk on volumes without a valid FSInfo)
+static uint64_t on_disk(uint64_t size) { return cluster ? (size + cluster - 1) / cluster * cluster : size; }
+
+static void walk_sum(char *path, size_t len, int depth) {
+    FF_DIR d; FILINFO fi; size_t base = strlen(path);
+    if(f_opendir(&d, path) != FR_OK) return;
+    while(f_readdir(&d, &fi) == FR_OK && fi.fname[0]) {
+        if(fi.fattrib & AM_DIR) { if(depth < 3 && snprintf(path + base, len - base, "/%s", fi.fname) < (int)(len - base)) walk_sum(path, len, depth + 1); path[base] = 0; }
+        else { rec_bytes += on_disk(fi.fsize); rec_files++; }
+    }
+    f_closedir(&d);
+}
+
+static bool ensure_scanned(void) {
+    if(scanned) return true;
+    DWORD nclst; FATFS *fs; int64_t t0 = esp_timer_get_time(); char path[96];
+    if(f_getfree(drv, &nclst, &fs) != FR_OK) return false;
+    cluster = fs->csize * fs->ssize; free_bytes = (uint64_t)nclst * cluster; total_bytes = (uint64_t)(fs->n_fatent - 2) * cluster;
+    rec_bytes = 0; rec_files = 0; snprintf(path, sizeof(path), "%s%s", drv, RET_DIR); walk_sum(path, sizeof(path), 0);
+    scan_ms = (esp_timer_get_time() - t0) / 1000; scanned = true;
+    ESP_LOGI(TAG, "%llu MB free, %lu recordings using %llu MB (%lu ms)", (unsigned long long)free_bytes >> 20, (unsigned long)rec_files, (unsigned long long)rec_bytes >> 20, (unsigned long)scan_ms);
+    return true;
+}
+
+void retention_attach(sdmmc_card_t *card) { if(card) snprintf(drv, sizeof(drv), "%u:", ff_diskio_get_pdrv_card(card)); }
+
+bool retention_can_write(uint64_t bytes) { return !scanned || free_bytes >= on_disk(bytes) + RET_FLOOR_BYTES; }
+
+void retention_note_write(uint64_t bytes, bool recording) { uint64_t b = on_disk(bytes); free_bytes -= (b < free_bytes) ? b : free_bytes; if(recording) { rec_bytes += b; rec_files++; } }
+
+void retention_note_delete(uint64_t bytes, bool recording) {
+    uint64_t b = on_disk(bytes); free_bytes += b;
+    if(recording) { rec_bytes -= (b < rec_bytes) ? b : rec_bytes; if(rec_files) rec_files--; }
+}
+
+/* ==================== 3.0 Oldest-First Eviction ==================== */
+// Names sort chronologically at every level (YYYY, MM, DD, YYYYMMDD_HHMMSS_...), so the oldest file is found by
+// taking the smallest name at each level. Read-only (locked) files are skipped and emptied directories removed.
+static bool find_oldest(char *path, size_t len, int depth, FSIZE_t *size) {
+    size_t base = strlen(path); char after[64] = "";
+    while(1) {
+        FF_DIR d; FILINFO fi; char best[64] = ""; FSIZE_t best_size = 0; bool best_dir = false;
+        if(f_opendir(&d, path) != FR_OK) return false;
+        while(f_readdir(&d, &fi) == FR_OK && fi.fname[0]) {
+            bool dir = (fi.fattrib & AM_DIR) != 0;
+            if(strcmp(fi.fname, after) <= 0 || (best[0] && strcmp(fi.fname, best) >= 0) || strlen(fi.fname) >= sizeof(best)) continue;
+            if((dir && depth >= 3) || (!dir && (fi.fattrib & AM_RDO))) continue;
+            snprintf(best, sizeof(best), "%s", fi.fname); best_size = fi.fsize; best_dir = dir;
+        }
+        f_closedir(&d);
+        if(!best[0]) return false;
+        snprintf(path + base, len - base, "/%s", best);
+        if(!best_dir) { *size = best_size; return true; }
+        if(find_oldest(path, len, depth + 1, size)) return true;
+        f_unlink(path); // Only succeeds once the directory is empty
+        path[base] = 0; snprintf(after, sizeof(after), "%s", best);
+    }
+}
+
+// Deletes the oldest unlocked recordings until the next clip fits above the reserve and inside the quota.
+// Called between clips, so it never runs while audio is being written. Returns the number of files evicted.
+int retention_enforce(uint64_t next_clip_bytes, uint32_t reserve_mb, uint32_t quota_mb) {
+    if(!ensure_scanned()) return 0;
+    uint64_t need = on_disk(next_clip_bytes), reserve = (uint64_t)reserve_mb << 20, quota = (uint64_t)quota_mb << 20; int evicted = 0;
+    while(free_bytes < reserve + need + RET_FLOOR_BYTES || (quota && rec_bytes + need > quota)) {
+        char path[96]; FSIZE_t size; snprintf(path, sizeof(path), "%s%s", drv, RET_DIR);
+        if(!find_oldest(path, sizeof(path), 0, &size) || f_unlink(path) != FR_OK) { ESP_LOGW(TAG, "Nothing left to evict"); break; }
+        catalog_remove(path + strlen(drv) + 1); retention_note_delete(size, true); evicted_files++; evicted_bytes += size; evicted++;
+        ESP_LOGI(TAG, "Evicted %s (%llu KB)", path, (unsigned long long)size >> 10);
+    }
+    return evicted;
+}
+
+/* ==================== 4.0 Locks & Stats ==================== */
+// A lock is the FAT read-only attribute: eviction skips it and unlink (including BLE del) refuses it
+int retention_set_lock(const char *rel_path, bool lock) {
+    char path[300]; while(*rel_path == '/') rel_path++;
+    snprintf(path, sizeof(path), "%s/%s", drv, rel_path);
+    return f_chmod(path, lock ? AM_RDO : 0, AM_RDO) == FR_OK ? 0 : -1;
+}
+
+int retention_stats(char *out, size_t len) {
+    ensure_scanned();
+    return snprintf(out, len, "DF|%llu|%llu|%llu|%lu|%lu|%llu|%lu", (unsigned long long)total_bytes >> 10, (unsigned long long)free_bytes >> 10, (unsigned long long)rec_bytes >> 10, (unsigned long)rec_files, (unsigned long)evicted_files, (unsigned long long)evicted_bytes >> 10, (unsigned long)scan_ms);
+}
@@ -0,0 +1,45 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Storage Quota and Oldest-First Retention Header */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes
+   2.0 Prototypes
+========================================*/
+
+/* ==================== 1.0 Includes ==================== */
+#ifndef RETENTION_H
+#define RETENTION_H
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sdmmc_cmd.h"
+
+/* ==================== 2.0 Prototypes ==================== */
+void retention_attach(sdmmc_card_t *card);
+int retention_enforce(uint64_t next_clip_bytes, uint32_t reserve_mb, uint32_t quota_mb);
+bool retention_can_write(uint64_t bytes);
+void retention_note_write(uint64_t bytes, bool recording);
+void retention_note_delete(uint64_t bytes, bool recording);
+int retention_set_lock(const char *rel_path, bool lock);
+int retention_stats(char *out, size_t len);
+
+#endif
@@ -31,10 +31,12 @@
 #include "driver/i2c.h"
 #include "sys/time.h"
 #include "globals.h"
+#include "esp_timer.h"
 
 #define I2C_MASTER_NUM     I2C_NUM_0
 #define I2C_MASTER_FREQ_HZ 100000
 #define RTC_ADDR           0x68
+#define RTC_EDGE_TIMEOUT_US 1100000 // Seconds register must tick within this window
 
 /* ==================== 2.0 Helper Functions ==================== */
 static uint8_t dec2bcd(uint8_t val) { return ((val / 10 * 16) + (val % 10)); }
@@ -45,12 +47,22 @@ static void i2c_init_once(void) {
     i2c_param_config(I2C_MASTER_NUM, &conf); i2c_driver_install(I2C_MASTER_NUM, conf.mode, 0, 0, 0); initialized = true;
 }
 
-/* ==================== 3.0 RTC Control ==================== */
-void rtc_init_and_sync(void) {
-    i2c_init_once(); uint8_t data[7]; i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+static esp_err_t rtc_read_regs(uint8_t *data) {
+    i2c_cmd_handle_t cmd = i2c_cmd_link_create();
     i2c_master_start(cmd); i2c_master_write_byte(cmd, (RTC_ADDR << 1) | I2C_MASTER_WRITE, true); i2c_master_write_byte(cmd, 0x00, true); 
     i2c_master_start(cmd); i2c_master_write_byte(cmd, (RTC_ADDR << 1) | I2C_MASTER_READ, true); i2c_master_read(cmd, data, 6, I2C_MASTER_ACK); i2c_master_read_byte(cmd, &data[6], I2C_MASTER_LAST_NACK); i2c_master_stop(cmd);
-    esp_err_t ret = i2c_master_cmd_begin(I2C_MASTER_NUM, cmd, 1000 / portTICK_PERIOD_MS); i2c_cmd_link_delete(cmd);
+    esp_err_t ret = i2c_master_cmd_begin(I2C_MASTER_NUM, cmd, 1000 / portTICK_PERIOD_MS); i2c_cmd_link_delete(cmd); return ret;
+}
+
+/* ==================== 3.0 RTC Control ==================== */
+// Busy-polls the DS3231 until its seconds register ticks and sets the system clock on that edge, so system time
+// is good to about one I2C transaction (~0.5 ms) instead of up to a full second behind
+void rtc_init_and_sync(void) {
+    i2c_init_once(); uint8_t data[7]; esp_err_t ret = rtc_read_regs(data);
+    if(ret == ESP_OK) {
+        uint8_t sec = data[0]; int64_t t0 = esp_timer_get_time();
+        while(esp_timer_get_time() - t0 < RTC_EDGE_TIMEOUT_US) { if(rtc_read_regs(data) != ESP_OK || data[0] != sec) break; }
+    }
 
     if(ret == ESP_OK) {
         struct tm tm_info = {0};
@@ -59,6 +71,13 @@ void rtc_init_and_sync(void) {
     }
 }
 
+// DS3231 die temperature: 10-bit two's complement in quarter degrees across 0x11/0x12, converted by the chip every 64 s
+bool rtc_read_temp_c100(int16_t *c100) {
+    uint8_t reg = 0x11, data[2]; i2c_init_once();
+    if(i2c_master_write_read_device(I2C_MASTER_NUM, RTC_ADDR, &reg, 1, data, 2, pdMS_TO_TICKS(50)) != ESP_OK) return false;
+    *c100 = (int16_t)((data[0] << 8) | data[1]) / 64 * 25; return true;
+}
+
 void rtc_set_time_manual(int year, int month, int day, int hour, int min, int sec) {
     i2c_init_once(); int year_short = (year > 2000) ? year - 2000 : year; i2c_cmd_handle_t cmd = i2c_cmd_link_create();
     i2c_master_start(cmd); i2c_master_write_byte(cmd, (RTC_ADDR << 1) | I2C_MASTER_WRITE, true); i2c_master_write_byte(cmd, 0x00, true); 
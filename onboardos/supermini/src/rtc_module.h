@@ -29,9 +29,12 @@
 #ifndef RTC_MODULE_H
 #define RTC_MODULE_H
 #include <time.h>
+#include <stdint.h>
+#include <stdbool.h>
 
 /* ==================== 2.0 Prototypes ==================== */
 void rtc_init_and_sync(void);
 void rtc_set_time_manual(int year, int month, int day, int hour, int min, int sec);
+bool rtc_read_temp_c100(int16_t *c100);
 
 #endif
\ No newline at end of file
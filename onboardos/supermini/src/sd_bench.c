@@ -0,0 +1,292 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* SD Write Throughput Benchmarks */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Definitions
+   2.0 Helpers
+   3.0 Log vs FAT Benchmark
+   4.0 Directory Layout Benchmark
+   5.0 Card Profile (sdbench)
+   6.0 Bench Steps
+========================================*/
+
+/* ==================== 1.0 Includes & Definitions ==================== */
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/unistd.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "nvs.h"
+#include "crc32.h"
+#include "globals.h"
+#include "retention.h"
+#include "logstore_sd.h"
+#include "sd_bench.h"
+
+#define BENCH_BYTES (2 * 1024 * 1024) // About a minute of 16 kHz mono
+#define BENCH_BLOCK 2048              // Same write size as one recording-mode I2S read
+#define FSB_PER_DIR 100               // Files per shard directory, roughly a busy day of clips
+#define FSB_OPEN_SAMPLES 20
+#define SDB_SEQ_BYTES (1024 * 1024)  // Per block size, each way
+#define SDB_LAT_BYTES (4 * 1024 * 1024) // Sustained run, a few minutes of stereo at the profile block size
+#define SDB_MIN_BLOCK 2048           // The latency run never goes below one I2S read
+#define NVS_NAMESPACE "echolog_sdb"
+
+static const char *TAG = "SD_BENCH";
+static const uint32_t sdb_blocks[SD_PROFILE_SIZES] = { 512, 2048, 8192, 32768 };
+
+/* ==================== 2.0 Helpers ==================== */
+// Queues a reply line on the bench; the caller sends it once the step returns
+static void emit(sd_bench_t *b, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+static void emit(sd_bench_t *b, const char *fmt, ...) {
+    if(b->lines >= SD_BENCH_LINES) return;
+    va_list ap; va_start(ap, fmt); vsnprintf(b->line[b->lines], SD_BENCH_LINE_LEN, fmt, ap); va_end(ap);
+    ESP_LOGI(TAG, "%s", b->line[b->lines++]);
+}
+
+static void send_bench_result(sd_bench_t *b, const char *backend, int64_t total_us, int64_t worst_us) {
+    if(total_us <= 0) emit(b, "BENCH|%s|FAIL", backend);
+    else emit(b, "BENCH|%s|%lld|%lld", backend, (long long)BENCH_BYTES * 1000000 / 1024 / total_us, (long long)worst_us / 1000);
+}
+
+static bool step_left(int64_t t0) { return esp_timer_get_time() - t0 < SD_BENCH_STEP_US; }
+
+static int bench_end(sd_bench_t *b) { free(b->blk); free(b->lat); b->blk = NULL; b->lat = NULL; sys_led_state = LED_BT_PAIRED; return 0; }
+
+/* ==================== 3.0 Log vs FAT Benchmark ==================== */
+// Sustained writes in recording-sized blocks to both backends. Replies BENCH|<backend>|<KB/s>|<worst write ms>.
+// The log run is a hidden entry, so like any recording it advances the ring over the oldest data. Time spent
+// between steps (other storage requests) is not counted.
+enum { LVF_FAT_OPEN, LVF_FAT_WRITE, LVF_LOG_OPEN, LVF_LOG_WRITE };
+
+static int lvf_step(sd_bench_t *b) {
+    int64_t t0 = esp_timer_get_time(); bool fail = false;
+    switch(b->phase) {
+    case LVF_FAT_OPEN:
+        if(!(b->blk = malloc(BENCH_BLOCK))) return bench_end(b);
+        for(int i = 0; i < BENCH_BLOCK; i++) b->blk[i] = (uint8_t)(i * 7);
+        sys_led_state = LED_SELF_TEST;
+        snprintf(b->path, sizeof(b->path), "%s/bench.tmp", b->mount); b->f = fopen(b->path, "wb"); b->done = 0; b->worst_us = 0;
+        b->busy_us = esp_timer_get_time() - t0;
+        if(b->f) b->phase = LVF_FAT_WRITE; else { send_bench_result(b, "FAT", -1, 0); b->phase = LVF_LOG_OPEN; }
+        return 1;
+    case LVF_FAT_WRITE:
+        while(b->done < BENCH_BYTES && step_left(t0)) {
+            int64_t t = esp_timer_get_time(); if(fwrite(b->blk, 1, BENCH_BLOCK, b->f) != BENCH_BLOCK) { fail = true; break; }
+            t = esp_timer_get_time() - t; if(t > b->worst_us) b->worst_us = t; b->done += BENCH_BLOCK;
+        }
+        if(!fail && b->done < BENCH_BYTES) { b->busy_us += esp_timer_get_time() - t0; return 1; }
+        fclose(b->f); b->f = NULL; b->busy_us += esp_timer_get_time() - t0; remove(b->path);
+        send_bench_result(b, "FAT", fail ? -1 : b->busy_us, b->worst_us); b->phase = LVF_LOG_OPEN;
+        return 1;
+    case LVF_LOG_OPEN: {
+        logstore_t *log = logstore_sd_mount(b->card) ? logstore_sd_get() : NULL; logstore_meta_t meta = { .sample_rate = 16000, .channels = 1, .bits = 16, .flags = LOG_F_HIDDEN }; strcpy(meta.name, "bench");
+        if(!log) { emit(b, "BENCH|LOG|NONE"); return bench_end(b); }
+        if(logstore_begin(log, &meta)) { send_bench_result(b, "LOG", -1, 0); return bench_end(b); }
+        b->done = 0; b->worst_us = 0; b->busy_us = 0; b->phase = LVF_LOG_WRITE;
+        return 1;
+    }
+    default: {
+        logstore_t *log = logstore_sd_get(); fail = !log;
+        while(!fail && b->done < BENCH_BYTES && step_left(t0)) {
+            int64_t t = esp_timer_get_time(); if(logstore_append(log, b->blk, BENCH_BLOCK)) { fail = true; break; }
+            t = esp_timer_get_time() - t; if(t > b->worst_us) b->worst_us = t; b->done += BENCH_BLOCK;
+        }
+        if(!fail && b->done < BENCH_BYTES) { b->busy_us += esp_timer_get_time() - t0; return 1; }
+        if(log && logstore_end(log)) fail = true;
+        b->busy_us += esp_timer_get_time() - t0; send_bench_result(b, "LOG", fail ? -1 : b->busy_us, b->worst_us);
+        return bench_end(b);
+    }
+    }
+}
+
+/* ==================== 4.0 Directory Layout Benchmark ==================== */
+// Creates 100, 1,000 and (if asked) 10,000 recording-style files in a flat directory and in 100-file shards.
+// Replies FSB|<layout>|<files>|<avg create us>|<avg fopen us>|<full ls ms> at each step. Large runs take minutes,
+// so creating, listing and removing all go a step at a time and only the time inside steps is counted.
+enum { FSB_START, FSB_CREATE, FSB_SAMPLE, FSB_WALK, FSB_CLEAN };
+static const char *fsb_layouts[2] = { "FLAT", "SHARD" };
+
+static void fsb_path(char *out, size_t len, const char *root, bool sharded, int i) {
+    if(sharded) snprintf(out, len, "%s/%03d/20261018_%06d_45.42150_-75.69720.wav", root, i / FSB_PER_DIR, i);
+    else snprintf(out, len, "%s/20261018_%06d_45.42150_-75.69720.wav", root, i);
+}
+
+// Same readdir + stat walk the BLE ls command does, without sending anything. The open DIR handles (root and
+// at most one shard) are kept in the bench between steps; nothing else touches the fsb_ directories meanwhile.
+static bool fsb_walk_step(sd_bench_t *b, int64_t t0) {
+    struct dirent *entry; struct stat st;
+    while(b->depth >= 0 && step_left(t0)) {
+        if(!(entry = readdir(b->dir[b->depth]))) { closedir(b->dir[b->depth--]); if(b->depth >= 0) b->path[b->base[b->depth]] = 0; continue; }
+        if(entry->d_name[0] == '.') continue;
+        size_t base = b->base[b->depth]; snprintf(b->path + base, sizeof(b->path) - base, "/%s", entry->d_name);
+        if(entry->d_type == DT_DIR && b->depth < 1) {
+            DIR *d = opendir(b->path); if(d) { b->dir[++b->depth] = d; b->base[b->depth] = strlen(b->path); continue; }
+        } else if(!stat(b->path, &st)) b->listed++;
+        b->path[base] = 0;
+    }
+    return b->depth < 0;
+}
+
+static int fsb_step(sd_bench_t *b) {
+    int64_t t0 = esp_timer_get_time(); bool sharded = b->layout == 1; const char *layout = fsb_layouts[b->layout];
+    switch(b->phase) {
+    case FSB_START:
+        sys_led_state = LED_SELF_TEST;
+        snprintf(b->root, sizeof(b->root), "%s/fsb_%s", b->mount, layout); mkdir(b->root, 0775);
+        b->created = b->batch = 0; b->target = 100; b->busy_us = 0; b->phase = FSB_CREATE;
+        return 1;
+    case FSB_CREATE: {
+        bool fail = false;
+        for(; b->created < b->target && step_left(t0); b->created++) {
+            if(sharded && b->created % FSB_PER_DIR == 0) { snprintf(b->path, sizeof(b->path), "%s/%03d", b->root, b->created / FSB_PER_DIR); mkdir(b->path, 0775); }
+            fsb_path(b->path, sizeof(b->path), b->root, sharded, b->created); FILE *f = fopen(b->path, "wb"); if(!f) { fail = true; break; } fclose(f);
+        }
+        b->busy_us += esp_timer_get_time() - t0;
+        if(fail) { emit(b, "FSB|%s|%d|FAIL", layout, b->created); b->done = 0; b->phase = FSB_CLEAN; }
+        else if(b->created >= b->target) b->phase = FSB_SAMPLE;
+        return 1;
+    }
+    case FSB_SAMPLE:
+        b->open_us = 0;
+        for(int k = 0; k < FSB_OPEN_SAMPLES; k++) { fsb_path(b->path, sizeof(b->path), b->root, sharded, (k * 7919) % b->created); int64_t t = esp_timer_get_time(); FILE *f = fopen(b->path, "rb"); if(f) fclose(f); b->open_us += esp_timer_get_time() - t; }
+        t0 = esp_timer_get_time(); strcpy(b->path, b->root); b->listed = 0;
+        if((b->dir[0] = opendir(b->path))) { b->depth = 0; b->base[0] = strlen(b->path); } else b->depth = -1;
+        b->walk_us = esp_timer_get_time() - t0; b->phase = FSB_WALK;
+        return 1;
+    case FSB_WALK: {
+        bool done = fsb_walk_step(b, t0); b->walk_us += esp_timer_get_time() - t0;
+        if(!done) return 1;
+        emit(b, "FSB|%s|%d|%lld|%lld|%lld", layout, b->listed, (long long)(b->busy_us / (b->created - b->batch)), (long long)(b->open_us / FSB_OPEN_SAMPLES), (long long)(b->walk_us / 1000));
+        b->batch = b->created; b->target *= 10; b->busy_us = 0;
+        if(b->target > b->max_files) { b->done = 0; b->phase = FSB_CLEAN; } else b->phase = FSB_CREATE;
+        return 1;
+    }
+    default:
+        for(; b->done < (uint32_t)b->created && step_left(t0); b->done++) {
+            int i = b->done; fsb_path(b->path, sizeof(b->path), b->root, sharded, i); remove(b->path);
+            if(sharded && (i % FSB_PER_DIR == FSB_PER_DIR - 1 || i == b->created - 1)) { snprintf(b->path, sizeof(b->path), "%s/%03d", b->root, i / FSB_PER_DIR); rmdir(b->path); }
+        }
+        if(b->done < (uint32_t)b->created) return 1;
+        rmdir(b->root);
+        if(b->layout++ == 1) return bench_end(b);
+        b->phase = FSB_START;
+        return 1;
+    }
+}
+
+/* ==================== 5.0 Card Profile (sdbench) ==================== */
+static void make_key(const sdmmc_card_t *card, char *key) {
+    uint32_t crc = crc32_update(0, &card->cid, sizeof(card->cid)); snprintf(key, 16, "c%08lx", (unsigned long)crc);
+}
+
+static uint32_t kbs(uint64_t bytes, int64_t us) { return us > 0 ? (uint32_t)(bytes * 1000000 / 1024 / us) : 0; }
+
+static int cmp_u32(const void *a, const void *b) { uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b; return (x > y) - (x < y); }
+
+// Sequential write then read of a scratch file at each size, then a sustained-write latency profile at the fastest
+// write size, timing every block; the sorted times give p50/p99/max. Plain write()/read() rather than stdio, so the
+// block size reaching FATFS is the one being measured, and write figures include the closing fsync, i.e. the card
+// has actually programmed the data. Nothing but sdbench.tmp is touched, and only if the retention floor leaves room.
+// Replies SDB|W|<block>|<KB/s>, SDB|R|<block>|<KB/s>, SDB|LAT|<block>|<p50 us>|<p99 us>|<max us>|<KB/s>, SDB|CARD|<key>.
+enum { SDB_START, SDB_WRITE, SDB_READ, SDB_LAT };
+
+static void sdb_open(sd_bench_t *b, int flags) { b->fd = open(b->path, flags, 0664); b->done = 0; b->busy_us = 0; }
+
+static int sdb_step(sd_bench_t *b) {
+    int64_t t0 = esp_timer_get_time(); sd_profile_t *p = &b->prof; uint32_t bs = sdb_blocks[b->k]; bool fail = b->fd < 0; ssize_t n;
+    switch(b->phase) {
+    case SDB_START:
+        snprintf(b->path, sizeof(b->path), "%s/sdbench.tmp", b->mount); remove(b->path);
+        if(!b->card || !retention_can_write(SDB_LAT_BYTES)) { emit(b, "SDB|FAIL|%s", b->card ? "SPACE" : "NOCARD"); return 0; }
+        if(!(b->blk = heap_caps_malloc(sdb_blocks[SD_PROFILE_SIZES - 1], MALLOC_CAP_DMA))) { emit(b, "SDB|FAIL|MEM"); return 0; }
+        for(int i = 0; i < sdb_blocks[SD_PROFILE_SIZES - 1]; i++) b->blk[i] = (uint8_t)(i * 7);
+        sys_led_state = LED_SELF_TEST;
+        p->version = SD_PROFILE_VERSION; p->block = SDB_MIN_BLOCK;
+        sdb_open(b, O_WRONLY | O_CREAT | O_TRUNC); b->phase = SDB_WRITE;
+        return 1;
+    case SDB_WRITE:
+        while(!fail && b->done < SDB_SEQ_BYTES && step_left(t0)) { if(write(b->fd, b->blk, bs) != (ssize_t)bs) fail = true; else b->done += bs; }
+        if(!fail && b->done < SDB_SEQ_BYTES) { b->busy_us += esp_timer_get_time() - t0; return 1; }
+        fail = fail || fsync(b->fd); b->busy_us += esp_timer_get_time() - t0; if(b->fd >= 0) close(b->fd);
+        p->write_kbs[b->k] = fail ? 0 : kbs(SDB_SEQ_BYTES, b->busy_us);
+        sdb_open(b, O_RDONLY); b->phase = SDB_READ;
+        return 1;
+    case SDB_READ:
+        while(!fail && b->done < SDB_SEQ_BYTES && step_left(t0)) { if((n = read(b->fd, b->blk, bs)) <= 0) fail = true; else b->done += n; }
+        if(!fail && b->done < SDB_SEQ_BYTES) { b->busy_us += esp_timer_get_time() - t0; return 1; }
+        b->busy_us += esp_timer_get_time() - t0; if(b->fd >= 0) close(b->fd);
+        p->read_kbs[b->k] = b->done >= SDB_SEQ_BYTES ? kbs(SDB_SEQ_BYTES, b->busy_us) : 0; remove(b->path);
+        emit(b, "SDB|W|%lu|%lu", (unsigned long)bs, (unsigned long)p->write_kbs[b->k]); emit(b, "SDB|R|%lu|%lu", (unsigned long)bs, (unsigned long)p->read_kbs[b->k]);
+        if(bs >= SDB_MIN_BLOCK && p->write_kbs[b->k] > b->best) { b->best = p->write_kbs[b->k]; p->block = bs; }
+        if(++b->k < SD_PROFILE_SIZES) { sdb_open(b, O_WRONLY | O_CREAT | O_TRUNC); b->phase = SDB_WRITE; return 1; }
+        b->k = 0; b->n = SDB_LAT_BYTES / p->block;
+        if(!b->best || !(b->lat = malloc(b->n * sizeof(uint32_t)))) { emit(b, "SDB|FAIL|WRITE"); return bench_end(b); }
+        sdb_open(b, O_WRONLY | O_CREAT | O_TRUNC); b->phase = SDB_LAT;
+        return 1;
+    default:
+        for(; !fail && b->done < b->n && step_left(t0); b->done++) {
+            int64_t t = esp_timer_get_time(); if(write(b->fd, b->blk, p->block) != (ssize_t)p->block) { fail = true; break; }
+            b->lat[b->done] = esp_timer_get_time() - t;
+        }
+        if(!fail && b->done < b->n) { b->busy_us += esp_timer_get_time() - t0; return 1; }
+        fail = fail || fsync(b->fd); b->busy_us += esp_timer_get_time() - t0; if(b->fd >= 0) close(b->fd); remove(b->path);
+        if(!fail) {
+            char key[16]; nvs_handle_t h; make_key(b->card, key); uint32_t cnt = b->n;
+            p->sustained_kbs = kbs(SDB_LAT_BYTES, b->busy_us); qsort(b->lat, cnt, sizeof(uint32_t), cmp_u32);
+            p->p50_us = b->lat[cnt / 2]; p->p99_us = b->lat[cnt - 1 - cnt / 100]; p->max_us = b->lat[cnt - 1];
+            emit(b, "SDB|LAT|%lu|%lu|%lu|%lu|%lu", (unsigned long)p->block, (unsigned long)p->p50_us, (unsigned long)p->p99_us, (unsigned long)p->max_us, (unsigned long)p->sustained_kbs);
+            if(nvs_open(NVS_NAMESPACE, NVS_READWRITE, &h) == ESP_OK) { nvs_set_blob(h, key, p, sizeof(*p)); nvs_commit(h); nvs_close(h); }
+            emit(b, "SDB|CARD|%s", key);
+        } else emit(b, "SDB|FAIL|WRITE");
+        return bench_end(b);
+    }
+}
+
+// The record saved by the last sdbench on this card (matched by CID), for sizing the recording buffers
+bool sd_bench_load_profile(const sdmmc_card_t *card, sd_profile_t *p) {
+    char key[16]; nvs_handle_t h; size_t sz = sizeof(*p); esp_err_t err;
+    if(!card || nvs_open(NVS_NAMESPACE, NVS_READONLY, &h) != ESP_OK) return false;
+    make_key(card, key); err = nvs_get_blob(h, key, p, &sz); nvs_close(h);
+    return err == ESP_OK && sz == sizeof(*p) && p->version == SD_PROFILE_VERSION;
+}
+
+/* ==================== 6.0 Bench Steps ==================== */
+void sd_bench_begin(sd_bench_t *b, sd_bench_kind_t kind, sdmmc_card_t *card, const char *mount_point, int max_files) {
+    memset(b, 0, sizeof(*b)); b->kind = kind; b->card = card; b->mount = mount_point; b->depth = -1; b->fd = -1;
+    b->max_files = (max_files < 100) ? 100 : (max_files > 10000) ? 10000 : max_files;
+}
+
+// Storage job: runs the next bounded piece of the bench. Returns 1 while there is more to do, 0 once finished
+int sd_bench_step(void *arg) {
+    sd_bench_t *b = arg;
+    if(b->kind == SD_BENCH_LOG_VS_FAT) return lvf_step(b);
+    if(b->kind == SD_BENCH_FS) return fsb_step(b);
+    return sdb_step(b);
+}
@@ -0,0 +1,64 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* SD Write Throughput Benchmarks Header */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+#ifndef SD_BENCH_H
+#define SD_BENCH_H
+#include <stdio.h>
+#include <stdbool.h>
+#include <dirent.h>
+#include "sdmmc_cmd.h"
+
+#define SD_PROFILE_SIZES 4   // Sequential block sizes: 512, 2K, 8K and 32K
+#define SD_PROFILE_VERSION 1
+
+// Per-card sdbench record, kept in NVS under the same CID key sd_clock.c uses
+typedef struct {
+    uint16_t version; uint16_t reserved;
+    uint32_t write_kbs[SD_PROFILE_SIZES], read_kbs[SD_PROFILE_SIZES];
+    uint32_t block;                        // Fastest sequential write size of 2K and up, used for the latency run
+    uint32_t p50_us, p99_us, max_us;       // Per-block write latency at that size
+    uint32_t sustained_kbs;
+} sd_profile_t;
+
+#define SD_BENCH_STEP_US 100000  // Card work per storage job; a bench is many of these, so other requests run in between
+#define SD_BENCH_LINES 4
+#define SD_BENCH_LINE_LEN 64
+
+typedef enum { SD_BENCH_LOG_VS_FAT, SD_BENCH_FS, SD_BENCH_PROFILE } sd_bench_kind_t;
+
+// One running bench. The caller owns it and passes it to sd_bench_step() as a storage job until that returns 0;
+// after every step it sends and clears the result lines, so nothing is sent from the storage task.
+typedef struct {
+    sd_bench_kind_t kind; sdmmc_card_t *card; const char *mount; int max_files;
+    int phase, layout, created, batch, target, listed, depth; uint32_t done;
+    int64_t busy_us, worst_us, open_us, walk_us;
+    uint8_t *blk; FILE *f; DIR *dir[2]; size_t base[2];
+    int fd, k; uint32_t n, best, *lat; sd_profile_t prof;
+    char root[48], path[128];
+    char line[SD_BENCH_LINES][SD_BENCH_LINE_LEN]; int lines;
+} sd_bench_t;
+
+void sd_bench_begin(sd_bench_t *b, sd_bench_kind_t kind, sdmmc_card_t *card, const char *mount_point, int max_files);
+int sd_bench_step(void *b);
+bool sd_bench_load_profile(const sdmmc_card_t *card, sd_profile_t *p);
+
+#endif
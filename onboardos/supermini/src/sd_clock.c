@@ -0,0 +1,162 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Per-Card SD Clock Training and CRC-Error Step-Down */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Definitions
+   2.0 NVS Rate Cache
+   3.0 Training
+   4.0 Step-Down I/O & FATFS Hook
+   5.0 Apply & Status
+========================================*/
+
+/* ==================== 1.0 Includes & Definitions ==================== */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "nvs.h"
+#include "driver/sdspi_host.h"
+#include "diskio_impl.h"
+#include "diskio_sdmmc.h"
+#include "crc32.h"
+#include "sd_clock.h"
+
+#define NVS_NAMESPACE "echolog_sd"
+#define TRAIN_PASSES 3
+#define TRAIN_READ_SECTORS 8
+
+static const char *TAG = "SD_CLK";
+static const uint32_t ladder_khz[] = { 1000, 4000, 10000, 16000, 20000, 26000, 40000 }; // Index 0 is the step-down floor
+#define LADDER_LEN (sizeof(ladder_khz) / sizeof(ladder_khz[0]))
+
+static sdmmc_card_t *clk_card = NULL;   // Card the FATFS hook and step-down apply to
+static char clk_key[16] = {0};          // NVS key of the current card, "c" + CRC32 of its CID
+static int clk_level = 1, clk_steps = 0;
+static bool clk_trained = false;         // Rate came from training this boot rather than the cache
+
+/* ==================== 2.0 NVS Rate Cache ==================== */
+static void make_key(const sdmmc_card_t *card, char *key) {
+    uint32_t crc = crc32_update(0, &card->cid, sizeof(card->cid)); snprintf(key, 16, "c%08lx", (unsigned long)crc);
+}
+
+static int load_level(const char *key) {
+    nvs_handle_t h; uint32_t khz = 0;
+    if(nvs_open(NVS_NAMESPACE, NVS_READONLY, &h) != ESP_OK) return -1;
+    esp_err_t err = nvs_get_u32(h, key, &khz); nvs_close(h);
+    if(err != ESP_OK) return -1;
+    for(int i = LADDER_LEN - 1; i >= 0; i--) if(ladder_khz[i] <= khz) return i;
+    return 0;
+}
+
+static void save_level(const char *key, int level) {
+    nvs_handle_t h;
+    if(nvs_open(NVS_NAMESPACE, NVS_READWRITE, &h) == ESP_OK) { nvs_set_u32(h, key, ladder_khz[level]); nvs_commit(h); nvs_close(h); }
+}
+
+/* ==================== 3.0 Training ==================== */
+static esp_err_t set_level(sdmmc_card_t *card, int level) {
+    esp_err_t err = sdspi_host_set_card_clk(card->host.slot, ladder_khz[level]);
+    if(err == ESP_OK) { card->real_freq_khz = ladder_khz[level]; clk_level = level; }
+    return err;
+}
+
+// The scratch sector sits in the gap between the MBR and the first partition, which SD-formatted cards always leave
+static uint32_t find_scratch(const uint8_t *mbr) {
+    if(mbr[510] != 0x55 || mbr[511] != 0xAA) return 0;
+    uint32_t first = UINT32_MAX;
+    for(int i = 0; i < 4; i++) { uint32_t start; memcpy(&start, mbr + 446 + i * 16 + 8, 4); if(mbr[446 + i * 16 + 4] && start && start < first) first = start; }
+    return (first != UINT32_MAX && first > TRAIN_READ_SECTORS + 1) ? first - 1 : 0;
+}
+
+// One pass: a multi-sector read compared against the copy taken at the mount clock, then a pattern written to
+// the scratch sector and read back. The card's own CRC checks surface as errors; the compares catch the rest.
+static bool verify_pass(sdmmc_card_t *card, const uint8_t *ref, uint8_t *buf, uint32_t scratch, uint32_t seed) {
+    if(sdmmc_read_sectors(card, buf, 0, TRAIN_READ_SECTORS) != ESP_OK || memcmp(buf, ref, TRAIN_READ_SECTORS * 512)) return false;
+    if(!scratch) return true;
+    for(int i = 0; i < 512; i++) buf[i] = (uint8_t)(i * 13 + seed);
+    uint32_t crc = crc32_update(0, buf, 512);
+    if(sdmmc_write_sectors(card, buf, scratch, 1) != ESP_OK) return false;
+    memset(buf, 0, 512);
+    return sdmmc_read_sectors(card, buf, scratch, 1) == ESP_OK && crc32_update(0, buf, 512) == crc;
+}
+
+// Climbs the ladder from the mount clock and keeps the last rate that passed every round
+static int train(sdmmc_card_t *card) {
+    uint8_t *ref = heap_caps_malloc(TRAIN_READ_SECTORS * 512, MALLOC_CAP_DMA), *buf = heap_caps_malloc(TRAIN_READ_SECTORS * 512, MALLOC_CAP_DMA); int best = 1;
+    if(ref && buf && set_level(card, 1) == ESP_OK && sdmmc_read_sectors(card, ref, 0, TRAIN_READ_SECTORS) == ESP_OK) {
+        uint32_t scratch = find_scratch(ref);
+        for(int level = 2; level < LADDER_LEN; level++) {
+            bool ok = set_level(card, level) == ESP_OK;
+            for(int p = 0; p < TRAIN_PASSES && ok; p++) ok = verify_pass(card, ref, buf, scratch, level * 16 + p);
+            ESP_LOGI(TAG, "%lu kHz: %s", (unsigned long)ladder_khz[level], ok ? "pass" : "fail");
+            if(!ok) break;
+            best = level;
+        }
+    }
+    free(ref); free(buf); return best;
+}
+
+/* ==================== 4.0 Step-Down I/O & FATFS Hook ==================== */
+// Drops one rung and remembers it for this card, so a marginal card settles instead of failing every boot
+static bool step_down(sdmmc_card_t *card) {
+    if(clk_level == 0 || set_level(card, clk_level - 1) != ESP_OK) return false;
+    clk_steps++; save_level(clk_key, clk_level); ESP_LOGW(TAG, "I/O error, stepping down to %lu kHz", (unsigned long)ladder_khz[clk_level]);
+    return true;
+}
+
+esp_err_t sd_clock_read(sdmmc_card_t *card, void *buf, size_t lba, size_t count) {
+    esp_err_t err;
+    while((err = sdmmc_read_sectors(card, buf, lba, count)) != ESP_OK && (err == ESP_ERR_INVALID_CRC || err == ESP_ERR_TIMEOUT) && card == clk_card && step_down(card)) {}
+    return err;
+}
+
+esp_err_t sd_clock_write(sdmmc_card_t *card, const void *buf, size_t lba, size_t count) {
+    esp_err_t err;
+    while((err = sdmmc_write_sectors(card, buf, lba, count)) != ESP_OK && (err == ESP_ERR_INVALID_CRC || err == ESP_ERR_TIMEOUT) && card == clk_card && step_down(card)) {}
+    return err;
+}
+
+static DRESULT hook_read(BYTE pdrv, BYTE *buf, LBA_t sector, UINT count) { return sd_clock_read(clk_card, buf, sector, count) == ESP_OK ? RES_OK : RES_ERROR; }
+static DRESULT hook_write(BYTE pdrv, const BYTE *buf, LBA_t sector, UINT count) { return sd_clock_write(clk_card, buf, sector, count) == ESP_OK ? RES_OK : RES_ERROR; }
+
+/* ==================== 5.0 Apply & Status ==================== */
+// Call right after esp_vfs_fat_sdspi_mount (at SD_CLOCK_MOUNT_KHZ). Uses the rate cached for this CID or trains one,
+// then re-registers the FATFS sector I/O through the step-down wrappers. The unmount unregisters it again.
+esp_err_t sd_clock_apply(sdmmc_card_t *card, bool retrain) {
+    if(!card) return ESP_ERR_INVALID_ARG;
+    char key[16]; make_key(card, key);
+    int level = retrain ? -1 : load_level(key); clk_trained = (level < 0);
+    if(level < 0) { level = train(card); save_level(key, level); }
+    esp_err_t err = set_level(card, level);
+    if(err != ESP_OK) { ESP_LOGE(TAG, "Clock change failed"); return err; }
+    if(card != clk_card || strcmp(key, clk_key)) clk_steps = 0;
+    clk_card = card; strcpy(clk_key, key);
+    static const ff_diskio_impl_t impl = { .init = ff_sdmmc_initialize, .status = ff_sdmmc_status, .read = hook_read, .write = hook_write, .ioctl = ff_sdmmc_ioctl };
+    ff_diskio_register(ff_diskio_get_pdrv_card(card), &impl);
+    ESP_LOGI(TAG, "Card %s at %lu kHz (%s)", key, (unsigned long)ladder_khz[level], clk_trained ? "trained" : "cached");
+    return ESP_OK;
+}
+
+int sd_clock_status(char *out, size_t len) {
+    return snprintf(out, len, "SDCLK|%lu|%s|%d|%s", clk_card ? (unsigned long)ladder_khz[clk_level] : 0UL, clk_trained ? "TRAINED" : "CACHED", clk_steps, clk_key);
+}
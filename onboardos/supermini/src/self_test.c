@@ -36,6 +36,7 @@
 #include "globals.h"
 #include "esp_log.h"
 #include "self_test.h"
+#include "storage_service.h"
 
 extern esp_err_t send_notification(uint8_t *data, size_t len);
 
@@ -57,24 +58,25 @@ void run_self_test(void) {
             bool pass = true;
 
             if (c == 0) {
-                // MicroSD: Write and read back to verify data lines
-                FILE* f = fopen("/sdcard/test.txt", "w+");
-                if (f) { 
-                    fprintf(f, "Echo"); fflush(f); fseek(f, 0, SEEK_SET);
-                    char r[5] = {0}; fread(r, 1, 4, f); fclose(f); remove("/sdcard/test.txt");
+                // MicroSD: Write and read back through the storage service to verify data lines
+                char r[5] = {0}; int fd = storage_open(STORAGE_MOUNT_POINT "/test.txt", "w+b", STORAGE_PRIO_TRANSFER);
+                if (fd >= 0) { 
+                    if(storage_append(fd, "Echo", 4, STORAGE_PRIO_TRANSFER) != 4 || storage_read_at(fd, 0, r, 4, STORAGE_PRIO_TRANSFER) != 4) pass = false;
+                    storage_close(fd, STORAGE_PRIO_TRANSFER); storage_delete(STORAGE_MOUNT_POINT "/test.txt", STORAGE_PRIO_TRANSFER);
                     if(strcmp(r, "Echo") != 0) pass = false;
                 } else pass = false;
             } 
             else if (c == 1) {
                 // ADXL: Read DEVID_AD register (0x00), should return 0xAD
                 spi_device_interface_config_t devcfg = {.clock_speed_hz = 1*1000*1000, .mode = 0, .spics_io_num = ADXL_PIN_NUM_CS, .queue_size = 1};
-                spi_device_handle_t adxl;
+                spi_device_handle_t adxl; storage_bus_acquire(); // Shares SPI2 with the card, which may not be mounted
                 if(spi_bus_add_device(SPI2_HOST, &devcfg, &adxl) == ESP_OK) {
                     spi_transaction_t t; memset(&t, 0, sizeof(t)); t.length = 24; t.flags = SPI_TRANS_USE_TXDATA | SPI_TRANS_USE_RXDATA; 
                     t.tx_data[0] = 0x0B; t.tx_data[1] = 0x00; t.tx_data[2] = 0x00;
                     if(spi_device_polling_transmit(adxl, &t) == ESP_OK) { if(t.rx_data[2] != 0xAD) pass = false; } else pass = false;
                     spi_bus_remove_device(adxl);
                 } else pass = false;
+                storage_bus_release();
             } 
             else if (c == 2) {
                 // I2S Mic: Read block, check for non-zero/non-FF (floating/dead) data
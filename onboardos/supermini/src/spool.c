@@ -0,0 +1,172 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Flash Fallback Spool for Recordings Without a Card */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Variables
+   2.0 Mount Scan
+   3.0 Writer
+   4.0 Replay Access
+========================================*/
+
+/* ==================== 1.0 Includes & Variables ==================== */
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "crc32.h"
+#include "spool.h"
+
+#define SPOOL_MAGIC 0x4C4F4F53 // "SOOL"
+#define SPOOL_SECTOR 4096
+#define SPOOL_MAX_ENTRIES 16
+#define SPOOL_LEN_OPEN 0xFFFFFFFF   // Still erased: the clip never closed, its length is recovered at the next scan
+#define SPOOL_F_PENDING 0xFFFF      // Flags only ever lose bits, so they can be programmed in place without an erase
+#define SPOOL_F_REPLAYED 0xFFFE
+
+// Header sector of each entry. len and flags sit outside the CRC and start erased so they can be programmed later.
+typedef struct __attribute__((packed)) {
+    uint32_t magic, seq;
+    int64_t start_time;
+    uint32_t sample_rate;
+    uint16_t channels, bits;
+    char stem[SPOOL_STEM_LEN];
+    uint32_t hdr_crc;
+    uint32_t len;
+    uint16_t flags;
+} spool_hdr_t;
+
+static const char *TAG = "SPOOL";
+static const esp_partition_t *part = NULL;
+static spool_entry_t entries[SPOOL_MAX_ENTRIES];
+static int count = 0;
+static uint32_t wr = 0, seq_next = 1;      // Next header offset and sequence number
+static uint32_t data_off = 0, data_len = 0; // Open entry
+static bool open = false, scanned = false;
+static uint8_t sec_buf[SPOOL_SECTOR]; static uint32_t sec_fill = 0;
+
+/* ==================== 2.0 Mount Scan ==================== */
+static uint32_t align_up(uint32_t v) { return (v + SPOOL_SECTOR - 1) / SPOOL_SECTOR * SPOOL_SECTOR; }
+
+static bool sector_erased(uint32_t off) {
+    uint32_t w[64];
+    for(uint32_t i = 0; i < SPOOL_SECTOR; i += sizeof(w)) {
+        if(esp_partition_read(part, off + i, w, sizeof(w)) != ESP_OK) return false;
+        for(int j = 0; j < 64; j++) if(w[j] != 0xFFFFFFFF) return false;
+    }
+    return true;
+}
+
+// A torn clip ends at the first erased sector: the writer always keeps the sector after the one it fills erased
+static uint32_t recover_len(uint32_t data) {
+    uint32_t end = data;
+    while(end < part->size && !sector_erased(end)) end += SPOOL_SECTOR;
+    return end - data;
+}
+
+// Walks the entries in sequence order from the start of the partition; the first header that is missing, corrupt or
+// out of sequence ends the log, which is how leftovers from before the last restart are told apart
+bool spool_init(void) {
+    if(scanned) return part != NULL;
+    scanned = true; part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, SPOOL_PART_LABEL);
+    if(!part) { ESP_LOGW(TAG, "No spool partition"); return false; }
+    uint32_t off = 0, pending_bytes = 0; spool_hdr_t h; bool first = true;
+    while(off + 2 * SPOOL_SECTOR <= part->size && esp_partition_read(part, off, &h, sizeof(h)) == ESP_OK) {
+        if(h.magic != SPOOL_MAGIC || h.hdr_crc != crc32_update(0, &h, offsetof(spool_hdr_t, hdr_crc)) || (!first && h.seq != seq_next)) break;
+        if(h.len == SPOOL_LEN_OPEN) { h.len = recover_len(off + SPOOL_SECTOR); esp_partition_write(part, off + offsetof(spool_hdr_t, len), &h.len, sizeof(h.len)); }
+        if(h.flags == SPOOL_F_PENDING && count < SPOOL_MAX_ENTRIES) {
+            spool_entry_t *e = &entries[count++]; e->offset = off; e->len = h.len; e->seq = h.seq; e->start_time = h.start_time; e->sample_rate = h.sample_rate; e->channels = h.channels;
+            memcpy(e->stem, h.stem, sizeof(e->stem)); e->stem[sizeof(e->stem) - 1] = 0; pending_bytes += h.len;
+        }
+        seq_next = h.seq + 1; first = false; off = align_up(off + SPOOL_SECTOR + h.len);
+    }
+    wr = off;
+    ESP_LOGI(TAG, "%d clips (%lu KB) waiting for a card", count, (unsigned long)(pending_bytes >> 10));
+    return true;
+}
+
+/* ==================== 3.0 Writer ==================== */
+// Erase-ahead: the sector after the one being written is always erased, which is what recover_len relies on
+static bool write_sector(uint32_t off, const void *data) {
+    if(off + SPOOL_SECTOR < part->size && esp_partition_erase_range(part, off + SPOOL_SECTOR, SPOOL_SECTOR) != ESP_OK) return false;
+    return esp_partition_write(part, off, data, SPOOL_SECTOR) == ESP_OK;
+}
+
+uint32_t spool_free_bytes(void) {
+    if(!spool_init()) return 0;
+    uint32_t from = count ? wr : 0; // Everything already replayed: the next clip starts over at the top
+    return (from + 2 * SPOOL_SECTOR <= part->size) ? part->size - from - SPOOL_SECTOR : 0;
+}
+
+bool spool_begin(const char *stem, int64_t start_time, uint32_t sample_rate, uint16_t channels) {
+    if(open || count >= SPOOL_MAX_ENTRIES || spool_free_bytes() < SPOOL_SECTOR) return false;
+    if(!count) wr = 0;
+    spool_hdr_t h; memset(&h, 0xFF, sizeof(h));
+    h.magic = SPOOL_MAGIC; h.seq = seq_next; h.start_time = start_time; h.sample_rate = sample_rate; h.channels = channels; h.bits = 16;
+    memset(h.stem, 0, sizeof(h.stem)); strncpy(h.stem, stem, sizeof(h.stem) - 1); h.hdr_crc = crc32_update(0, &h, offsetof(spool_hdr_t, hdr_crc));
+    if(esp_partition_erase_range(part, wr, SPOOL_SECTOR) != ESP_OK) return false;
+    memset(sec_buf, 0xFF, sizeof(sec_buf)); memcpy(sec_buf, &h, sizeof(h));
+    if(!write_sector(wr, sec_buf)) return false;
+    data_off = wr + SPOOL_SECTOR; data_len = 0; sec_fill = 0; open = true; seq_next++;
+    return true;
+}
+
+// Returns the bytes taken; short once the partition is full, and the rest of the clip is lost
+size_t spool_append(const void *buf, size_t len) {
+    const uint8_t *p = buf; size_t done = 0;
+    while(open && done < len) {
+        uint32_t at = data_off + data_len / SPOOL_SECTOR * SPOOL_SECTOR; // Sector the next byte lands in
+        if(at + SPOOL_SECTOR > part->size) break;
+        size_t n = SPOOL_SECTOR - sec_fill; if(n > len - done) n = len - done;
+        memcpy(sec_buf + sec_fill, p + done, n); sec_fill += n; data_len += n; done += n;
+        if(sec_fill == SPOOL_SECTOR) { if(!write_sector(at, sec_buf)) { data_len -= SPOOL_SECTOR; open = false; break; } sec_fill = 0; }
+    }
+    return done;
+}
+
+void spool_end(void) {
+    if(!part || (!open && !data_off)) return;
+    if(open && sec_fill) { memset(sec_buf + sec_fill, 0xFF, SPOOL_SECTOR - sec_fill); write_sector(data_off + data_len - sec_fill, sec_buf); }
+    uint32_t hdr = data_off - SPOOL_SECTOR; esp_partition_write(part, hdr + offsetof(spool_hdr_t, len), &data_len, sizeof(data_len));
+    spool_hdr_t h;
+    if(count < SPOOL_MAX_ENTRIES && esp_partition_read(part, hdr, &h, sizeof(h)) == ESP_OK) {
+        spool_entry_t *e = &entries[count++]; e->offset = hdr; e->len = data_len; e->seq = h.seq; e->start_time = h.start_time; e->sample_rate = h.sample_rate; e->channels = h.channels;
+        memcpy(e->stem, h.stem, sizeof(e->stem)); e->stem[sizeof(e->stem) - 1] = 0;
+    }
+    ESP_LOGI(TAG, "Spooled %lu KB", (unsigned long)(data_len >> 10));
+    wr = align_up(data_off + data_len); open = false; data_off = 0; data_len = 0; sec_fill = 0;
+}
+
+/* ==================== 4.0 Replay Access ==================== */
+int spool_count(void) { return spool_init() ? count : 0; }
+const spool_entry_t *spool_entry(int i) { return (i >= 0 && i < count) ? &entries[i] : NULL; }
+
+int spool_read(const spool_entry_t *e, uint32_t off, void *buf, size_t len) {
+    if(!part || off + len > e->len) return -1;
+    return esp_partition_read(part, e->offset + SPOOL_SECTOR + off, buf, len) == ESP_OK ? 0 : -1;
+}
+
+// Once the last pending clip is replayed the writer starts over at the top of the partition
+void spool_mark_replayed(const spool_entry_t *e) {
+    uint16_t f = SPOOL_F_REPLAYED; esp_partition_write(part, e->offset + offsetof(spool_hdr_t, flags), &f, sizeof(f));
+    int i = e - entries; memmove(&entries[i], &entries[i + 1], (count - i - 1) * sizeof(spool_entry_t)); count--;
+}
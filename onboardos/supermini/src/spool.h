@@ -0,0 +1,58 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Flash Fallback Spool Header */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Definitions
+   2.0 Prototypes
+========================================*/
+
+/* ==================== 1.0 Includes & Definitions ==================== */
+#ifndef SPOOL_H
+#define SPOOL_H
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define SPOOL_PART_LABEL "spool"
+#define SPOOL_STEM_LEN 64
+
+// One spooled clip: raw PCM16 after a header sector, replayed to the card as a WAV file once one is back
+typedef struct {
+    uint32_t offset, len, seq;
+    int64_t start_time;
+    uint32_t sample_rate;
+    uint16_t channels;
+    char stem[SPOOL_STEM_LEN];
+} spool_entry_t;
+
+/* ==================== 2.0 Prototypes ==================== */
+bool spool_init(void);
+bool spool_begin(const char *stem, int64_t start_time, uint32_t sample_rate, uint16_t channels);
+size_t spool_append(const void *buf, size_t len);
+void spool_end(void);
+int spool_count(void);
+const spool_entry_t *spool_entry(int i);
+int spool_read(const spool_entry_t *e, uint32_t off, void *buf, size_t len);
+void spool_mark_replayed(const spool_entry_t *e);
+uint32_t spool_free_bytes(void);
+
+#endif
@@ -0,0 +1,171 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Audio Staging Ring with Burst Flushes to the SD Card */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Variables
+   2.0 Flush Task
+   3.0 Producer (Recording Task)
+   4.0 Lifecycle & Stats
+========================================*/
+
+/* ==================== 1.0 Includes & Variables ==================== */
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/ringbuf.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include "spool.h"
+#include "stage.h"
+
+#define STAGE_CHUNK (16 * 1024)        // Largest single append handed to the storage service, unless tuned from the card profile
+#define STAGE_INTERNAL_MAX (64 * 1024) // Ring cap without PSRAM: ~2 s of mono per half, still far fewer wakeups than per-block writes
+#define STAGE_TASK_PRIO 2              // Above app_main so a burst starts as soon as it is due
+#define STAGE_WRITE_WAIT_MS 20         // Well inside the I2S DMA slack before a block counts as an overrun
+#define NVS_NAMESPACE "echolog_stage"
+
+// Last session's figures, kept in NVS so Bluetooth mode can report them: busy_ms / rec_ms is the SD duty cycle
+typedef struct { uint16_t flush_sec; uint8_t psram, spooling; uint32_t ring_kb, bursts, staged_kb, busy_ms, rec_ms, overrun_kb, spooled_kb; } stage_stats_t;
+
+static const char *TAG = "STAGE";
+static RingbufHandle_t ring = NULL; static StaticRingbuffer_t ring_ctl; static uint8_t *ring_mem = NULL;
+static size_t ring_size = 0, burst_bytes = 0, chunk = STAGE_CHUNK; static uint32_t stall_ms = 0;
+static TaskHandle_t flush_task = NULL; static SemaphoreHandle_t drained = NULL;
+static volatile bool running = false, closing = false, draining = false; static portMUX_TYPE flag_mux = portMUX_INITIALIZER_UNLOCKED;
+static stage_sink_t sink = NULL; static void *sink_ctx = NULL; static uint32_t sink_bytes = 0;
+static bool spooling = false; static char stem[SPOOL_STEM_LEN]; static int64_t clip_start = 0; static uint32_t clip_rate = 0; static uint16_t clip_channels = 1;
+static stage_stats_t st; static int64_t begin_us = 0, busy_us = 0; static uint64_t staged = 0, overrun = 0, spooled = 0;
+
+/* ==================== 2.0 Flush Task ==================== */
+// The card failed mid-clip (or was never there): the rest of the clip goes to the flash spool under its own name
+static void start_spool(const char *suffix) {
+    char s[SPOOL_STEM_LEN]; snprintf(s, sizeof(s), "%s%s", stem, suffix);
+    spooling = true; if(!spool_begin(s, clip_start, clip_rate, clip_channels)) ESP_LOGW(TAG, "Spool unavailable, dropping %s", s);
+}
+
+static void deliver(const uint8_t *p, size_t n) {
+    if(!spooling && sink) {
+        int w = sink(p, n, sink_ctx); if(w > 0) { sink_bytes += w; p += w; n -= w; }
+        if(!n) return;
+        start_spool("_cont");
+    }
+    if(spooling) spooled += spool_append(p, n);
+}
+
+// One burst: everything staged so far in chunk-sized appends, then a sync so the card finishes programming while
+// we are still on the bus and can drop to standby with CS released until the next burst
+static void drain(void) {
+    size_t n; uint8_t *p; int64_t t0 = esp_timer_get_time(); bool any = false;
+    while((p = xRingbufferReceiveUpTo(ring, &n, 0, chunk))) { deliver(p, n); vRingbufferReturnItem(ring, p); any = true; }
+    if(!any) return;
+    if(!spooling && sink && st.flush_sec) sink(NULL, 0, sink_ctx);
+    st.bursts++; busy_us += esp_timer_get_time() - t0;
+}
+
+static void flush_task_fn(void *arg) {
+    TickType_t period = st.flush_sec ? pdMS_TO_TICKS(st.flush_sec * 1000) : portMAX_DELAY;
+    while(running) {
+        if(!closing) ulTaskNotifyTake(pdTRUE, period); // Woken early when half the ring is full or the clip closes
+        portENTER_CRITICAL(&flag_mux); draining = true; bool c = closing; portEXIT_CRITICAL(&flag_mux); // Read before draining: every block of a closing clip is already in the ring
+        drain();
+        portENTER_CRITICAL(&flag_mux); draining = false; portEXIT_CRITICAL(&flag_mux); // A close or end that skipped its kick is seen by the loop
+        if(c) { closing = false; xSemaphoreGive(drained); }
+    }
+    xSemaphoreGive(drained); vTaskDelete(NULL);
+}
+
+/* ==================== 3.0 Producer (Recording Task) ==================== */
+// No notification while a drain runs: the task rechecks closing and running before it sleeps again, and a burst
+// that filled meanwhile is kicked by the next write
+static void kick(void) { portENTER_CRITICAL(&flag_mux); bool busy = draining; portEXIT_CRITICAL(&flag_mux); if(!busy) xTaskNotifyGive(flush_task); }
+
+// sink NULL means there is no card: the whole clip is spooled to flash and replayed once a card is back
+void stage_open(stage_sink_t s, void *ctx, const char *clip_stem, int64_t start_time, uint32_t sample_rate, uint16_t channels) {
+    sink = s; sink_ctx = ctx; sink_bytes = 0; spooling = false;
+    snprintf(stem, sizeof(stem), "%s", clip_stem); clip_start = start_time; clip_rate = sample_rate; clip_channels = channels;
+    if(!sink) start_spool("");
+}
+
+// Never blocks longer than STAGE_WRITE_WAIT_MS; a full ring means the card has stalled for a whole burst
+bool stage_write(const void *buf, size_t len) {
+    if(!ring) { deliver(buf, len); return true; } // No memory for a ring: straight through, as before staging
+    if(xRingbufferSend(ring, buf, len, pdMS_TO_TICKS(STAGE_WRITE_WAIT_MS)) != pdTRUE) { overrun += len; return false; }
+    staged += len;
+    if(ring_size - xRingbufferGetCurFreeSize(ring) >= burst_bytes) kick();
+    return true;
+}
+
+// Drains the ring and returns the bytes that reached the card, which is what the WAV header has to describe
+uint32_t stage_close(void) {
+    if(ring) { closing = true; kick(); xSemaphoreTake(drained, portMAX_DELAY); }
+    if(spooling) { spool_end(); st.spooling = 1; }
+    sink = NULL; spooling = false; return sink_bytes;
+}
+
+/* ==================== 4.0 Lifecycle & Stats ==================== */
+// From the card's sdbench profile, before stage_begin: appends of its fastest write size, and ring slack to ride out
+// twice its worst observed write stall on top of the two bursts
+void stage_tune(size_t chunk_bytes, uint32_t max_stall_ms) { chunk = chunk_bytes ? chunk_bytes : STAGE_CHUNK; stall_ms = max_stall_ms; }
+
+// Two bursts' worth of ring, so recording carries on into one half while the other is written out. PSRAM when the
+// module has it, otherwise a smaller internal ring; flush_sec 0 keeps the old write-every-block behaviour.
+bool stage_begin(uint32_t bytes_per_sec, uint16_t flush_sec) {
+    if(ring) return true;
+    memset(&st, 0, sizeof(st)); st.flush_sec = flush_sec; staged = overrun = spooled = 0; busy_us = 0;
+    size_t slack = (uint64_t)bytes_per_sec * stall_ms * 2 / 1000, want = (bytes_per_sec * (flush_sec ? flush_sec : 1) * 2 + slack + 3) & ~3u;
+    if((ring_mem = heap_caps_malloc(want, MALLOC_CAP_SPIRAM))) { ring_size = want; st.psram = 1; }
+    else { ring_size = (want < STAGE_INTERNAL_MAX) ? want : STAGE_INTERNAL_MAX; ring_mem = heap_caps_malloc(ring_size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT); }
+    if(!ring_mem) return false;
+    ring = xRingbufferCreateStatic(ring_size, RINGBUF_TYPE_BYTEBUF, ring_mem, &ring_ctl);
+    if(slack > ring_size / 2) slack = ring_size / 2; // A capped internal ring gives up slack before burst size
+    burst_bytes = flush_sec ? (ring_size - slack) / 2 : 1; st.ring_kb = ring_size >> 10;
+    if(!drained) drained = xSemaphoreCreateBinary();
+    spool_init(); running = true; begin_us = esp_timer_get_time();
+    xTaskCreate(flush_task_fn, "stage_flush", 4096, NULL, STAGE_TASK_PRIO, &flush_task);
+    ESP_LOGI(TAG, "%u KB ring in %s, bursts of %u KB in %u KB appends, %u KB stall slack", (unsigned)(ring_size >> 10), st.psram ? "PSRAM" : "internal RAM", (unsigned)(burst_bytes >> 10), (unsigned)(chunk >> 10), (unsigned)(slack >> 10));
+    return true;
+}
+
+static void snapshot(void) {
+    st.staged_kb = staged >> 10; st.busy_ms = busy_us / 1000; st.rec_ms = (esp_timer_get_time() - begin_us) / 1000; st.overrun_kb = overrun >> 10; st.spooled_kb = spooled >> 10;
+}
+
+void stage_end(void) {
+    if(!ring) return;
+    running = false; kick(); xSemaphoreTake(drained, portMAX_DELAY); flush_task = NULL;
+    snapshot(); nvs_handle_t h;
+    if(nvs_open(NVS_NAMESPACE, NVS_READWRITE, &h) == ESP_OK) { nvs_set_blob(h, "last", &st, sizeof(st)); nvs_commit(h); nvs_close(h); }
+    vRingbufferDelete(ring); ring = NULL; heap_caps_free(ring_mem); ring_mem = NULL;
+}
+
+// Live figures while recording, otherwise the last recording session's
+int stage_stats(char *out, size_t len) {
+    stage_stats_t s; nvs_handle_t h; size_t sz = sizeof(s); memset(&s, 0, sizeof(s));
+    if(ring) { snapshot(); s = st; }
+    else if(nvs_open(NVS_NAMESPACE, NVS_READONLY, &h) == ESP_OK) { nvs_get_blob(h, "last", &s, &sz); nvs_close(h); }
+    return snprintf(out, len, "STAGE|%u|%u|%lu|%lu|%lu|%lu|%lu|%lu|%lu|%d", s.flush_sec, s.psram, (unsigned long)s.ring_kb, (unsigned long)s.bursts, (unsigned long)s.staged_kb,
+                    (unsigned long)s.busy_ms, (unsigned long)s.rec_ms, (unsigned long)s.overrun_kb, (unsigned long)s.spooled_kb, spool_count());
+}
@@ -0,0 +1,214 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Storage Service Task Owning the SD Card */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Variables
+   2.0 Bus & Mount
+   3.0 Service Task
+   4.0 Request API
+========================================*/
+
+/* ==================== 1.0 Includes & Variables ==================== */
+#include <stdio.h>
+#include <string.h>
+#include <sys/unistd.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "driver/spi_master.h"
+#include "driver/sdspi_host.h"
+#include "esp_vfs_fat.h"
+#include "diskio_impl.h"
+#include "diskio_sdmmc.h"
+#include "globals.h"
+#include "sd_clock.h"
+#include "logstore_sd.h"
+#include "retention.h"
+#include "catalog.h"
+#include "usb_msc.h"
+#include "storage_service.h"
+
+#define STORAGE_TASK_PRIO 6     // Above the BLE command task (5) so a queued request is picked up as soon as it lands
+#define STORAGE_TASK_STACK 8192 // FatFs, catalog rebuild and the benches all run on this stack
+#define STORAGE_QUEUE_DEPTH 8
+#define STORAGE_MAX_FILES 4     // One below the VFS max_files, which the catalog reader also draws from
+
+typedef enum { SOP_OPEN, SOP_CLOSE, SOP_SYNC, SOP_APPEND, SOP_READ_AT, SOP_WRITE_AT, SOP_DELETE, SOP_CALL } storage_op_t;
+
+// Lives on the caller's stack: every request is synchronous, so it outlasts its trip through the queue. Completion is
+// signalled on the request's own semaphore, never on the caller's task notification, which other code uses to wake
+// the same tasks (BLE writes, stage flushes) and would otherwise end the wait while the service still holds r.
+typedef struct {
+    storage_op_t op; storage_prio_t prio; storage_vol_t vol;
+    int fd; const char *path, *mode; const void *src; void *dst; size_t len; uint32_t off;
+    storage_fn_t fn; void *arg;
+    int result; int64_t enq_us; SemaphoreHandle_t done; StaticSemaphore_t done_buf;
+} storage_req_t;
+
+// pos/end track the stream so sequential appends and reads never fseek (which would flush the stdio buffer)
+typedef struct { FILE *f; long pos, end; } storage_file_t;
+typedef struct { uint32_t n, max_us; uint64_t sum_us; } storage_lat_t;
+
+static const char *TAG = "STORAGE";
+static TaskHandle_t svc_task = NULL;
+static QueueHandle_t queues[STORAGE_PRIO_COUNT];
+static SemaphoreHandle_t pending = NULL, vol_lock[STORAGE_VOL_COUNT];
+static storage_file_t files[STORAGE_MAX_FILES];
+static storage_lat_t lat[STORAGE_PRIO_COUNT];
+static sdmmc_card_t *card = NULL;
+static int bus_users = 0;
+
+/* ==================== 2.0 Bus & Mount ==================== */
+// SPI2 is shared by the SD card and the ADXL; the bus is sized for SD transfers and freed once neither is attached.
+// Users take it from the recording or command task while the service is idle, or from the service during a mount.
+void storage_bus_acquire(void) {
+    if(bus_users++) return;
+    gpio_set_direction(SD_PIN_NUM_CS, GPIO_MODE_OUTPUT); gpio_set_level(SD_PIN_NUM_CS, 1); gpio_set_direction(ADXL_PIN_NUM_CS, GPIO_MODE_OUTPUT); gpio_set_level(ADXL_PIN_NUM_CS, 1);
+    gpio_set_pull_mode(SPI_PIN_NUM_MISO, GPIO_PULLUP_ONLY); gpio_set_pull_mode(SPI_PIN_NUM_MOSI, GPIO_PULLUP_ONLY); gpio_set_pull_mode(SPI_PIN_NUM_CLK, GPIO_PULLUP_ONLY);
+    spi_bus_config_t buscfg = {.mosi_io_num=SPI_PIN_NUM_MOSI, .miso_io_num=SPI_PIN_NUM_MISO, .sclk_io_num=SPI_PIN_NUM_CLK, .quadwp_io_num=-1, .quadhd_io_num=-1, .max_transfer_sz=4096+8};
+    spi_bus_initialize(SPI2_HOST, &buscfg, SPI_DMA_CH_AUTO);
+}
+
+void storage_bus_release(void) { if(bus_users > 0 && !--bus_users) spi_bus_free(SPI2_HOST); }
+
+sdmmc_card_t *storage_card(void) { return card; }
+
+// Everything that needs the raw card (clock training, the log partition, retention's drive number) is set up here
+static int mount_job(void *arg) {
+    if(card) return 0;
+    esp_vfs_fat_sdmmc_mount_config_t mount_config = {.format_if_mount_failed=false, .max_files=STORAGE_MAX_FILES+1, .allocation_unit_size=16*1024};
+    sdmmc_host_t host = SDSPI_HOST_DEFAULT(); host.slot = SPI2_HOST; host.max_freq_khz = SD_CLOCK_MOUNT_KHZ;
+    sdspi_device_config_t slot_config = SDSPI_DEVICE_CONFIG_DEFAULT(); slot_config.gpio_cs=SD_PIN_NUM_CS; slot_config.host_id=host.slot;
+    storage_bus_acquire();
+    if(esp_vfs_fat_sdspi_mount(STORAGE_MOUNT_POINT, &host, &slot_config, &mount_config, &card) != ESP_OK) { card = NULL; storage_bus_release(); return -1; }
+    sd_clock_apply(card, false); logstore_sd_mount(card); retention_attach(card);
+    if(usb_msc_take_dirty()) { ESP_LOGI(TAG, "Card was written over USB, catalog will be rebuilt"); catalog_invalidate(); }
+    return 0;
+}
+
+static int unmount_job(void *arg) {
+    for(int i = 0; i < STORAGE_MAX_FILES; i++) if(files[i].f) { fclose(files[i].f); files[i].f = NULL; }
+    catalog_unload(); logstore_sd_unmount();
+    if(card) { esp_vfs_fat_sdcard_unmount(STORAGE_MOUNT_POINT, card); card = NULL; storage_bus_release(); }
+    return 0;
+}
+
+// USB disk mode: everything above the sectors is closed and the FATFS object unregistered, so nothing cached on this
+// side can go stale while a host owns the card. The caller then holds both volume locks until it restarts.
+static int export_job(void *arg) {
+    if(!card) return -1;
+    for(int i = 0; i < STORAGE_MAX_FILES; i++) if(files[i].f) { fclose(files[i].f); files[i].f = NULL; }
+    catalog_unload(); logstore_sd_unmount();
+    char drv[4]; snprintf(drv, sizeof(drv), "%u:", ff_diskio_get_pdrv_card(card));
+    return f_mount(NULL, drv, 0) == FR_OK ? 0 : -1;
+}
+
+/* ==================== 3.0 Service Task ==================== */
+static int execute(storage_req_t *r) {
+    storage_file_t *of = (r->fd >= 0 && r->fd < STORAGE_MAX_FILES && files[r->fd].f) ? &files[r->fd] : NULL; size_t n;
+    switch(r->op) {
+        case SOP_OPEN:
+            for(int i = 0; i < STORAGE_MAX_FILES; i++) if(!files[i].f) {
+                if(!(files[i].f = fopen(r->path, r->mode))) return -1;
+                files[i].pos = 0; files[i].end = (r->mode[0] == 'w') ? 0 : -1; return i;
+            }
+            return -1;
+        case SOP_CLOSE: if(!of) return -1; n = fclose(of->f); of->f = NULL; return n ? -1 : 0;
+        case SOP_SYNC: return (of && !fflush(of->f) && !fsync(fileno(of->f))) ? 0 : -1;
+        case SOP_APPEND:
+            if(!of) return -1;
+            if(of->end < 0 || of->pos != of->end) { if(fseek(of->f, 0, SEEK_END)) return -1; of->end = ftell(of->f); }
+            n = fwrite(r->src, 1, r->len, of->f); of->end += n; of->pos = of->end; return n;
+        case SOP_READ_AT:
+            if(!of || (of->pos != r->off && fseek(of->f, r->off, SEEK_SET))) return -1;
+            n = fread(r->dst, 1, r->len, of->f); of->pos = r->off + n; return n;
+        case SOP_WRITE_AT:
+            if(!of || (of->pos != r->off && fseek(of->f, r->off, SEEK_SET))) return -1;
+            n = fwrite(r->src, 1, r->len, of->f); of->pos = r->off + n; if(of->end >= 0 && of->pos > of->end) of->end = of->pos; return n;
+        case SOP_DELETE: return remove(r->path);
+        case SOP_CALL: return r->fn(r->arg);
+    }
+    return -1;
+}
+
+// One request at a time, recording queue first; the wait from enqueue to dequeue is the queueing latency reported by "stor"
+static void storage_task(void *arg) {
+    storage_req_t *r;
+    while(1) {
+        xSemaphoreTake(pending, portMAX_DELAY);
+        if(!xQueueReceive(queues[STORAGE_PRIO_RECORD], &r, 0) && !xQueueReceive(queues[STORAGE_PRIO_TRANSFER], &r, 0)) continue;
+        uint32_t wait = esp_timer_get_time() - r->enq_us; storage_lat_t *l = &lat[r->prio];
+        l->n++; l->sum_us += wait; if(wait > l->max_us) l->max_us = wait;
+        xSemaphoreTake(vol_lock[r->vol], portMAX_DELAY); r->result = execute(r); xSemaphoreGive(vol_lock[r->vol]);
+        xSemaphoreGive(r->done); // Last touch of r: the caller's frame may be gone right after
+    }
+}
+
+// The task is created once per boot and never torn down; both modes end in esp_restart()
+void storage_start(void) {
+    if(svc_task) return;
+    for(int i = 0; i < STORAGE_PRIO_COUNT; i++) queues[i] = xQueueCreate(STORAGE_QUEUE_DEPTH, sizeof(storage_req_t *));
+    for(int i = 0; i < STORAGE_VOL_COUNT; i++) vol_lock[i] = xSemaphoreCreateMutex();
+    pending = xSemaphoreCreateCounting(STORAGE_QUEUE_DEPTH * STORAGE_PRIO_COUNT, 0);
+    xTaskCreate(storage_task, "storage", STORAGE_TASK_STACK, NULL, STORAGE_TASK_PRIO, &svc_task);
+}
+
+/* ==================== 4.0 Request API ==================== */
+// Blocks the caller until the service has run the request. Jobs already on the service (a storage_call body)
+// run nested requests inline, under the volume lock their job already holds.
+static int submit(storage_req_t *r) {
+    if(!svc_task) return -1;
+    if(xTaskGetCurrentTaskHandle() == svc_task) return execute(r);
+    r->done = xSemaphoreCreateBinaryStatic(&r->done_buf); r->enq_us = esp_timer_get_time();
+    xQueueSend(queues[r->prio], &r, portMAX_DELAY); xSemaphoreGive(pending);
+    xSemaphoreTake(r->done, portMAX_DELAY); vSemaphoreDelete(r->done);
+    return r->result;
+}
+
+int storage_open(const char *path, const char *mode, storage_prio_t prio) { storage_req_t r = { .op = SOP_OPEN, .prio = prio, .path = path, .mode = mode }; return submit(&r); }
+int storage_close(int fd, storage_prio_t prio) { storage_req_t r = { .op = SOP_CLOSE, .prio = prio, .fd = fd }; return submit(&r); }
+int storage_sync(int fd, storage_prio_t prio) { storage_req_t r = { .op = SOP_SYNC, .prio = prio, .fd = fd }; return submit(&r); }
+int storage_append(int fd, const void *buf, size_t len, storage_prio_t prio) { storage_req_t r = { .op = SOP_APPEND, .prio = prio, .fd = fd, .src = buf, .len = len }; return submit(&r); }
+int storage_read_at(int fd, uint32_t off, void *buf, size_t len, storage_prio_t prio) { storage_req_t r = { .op = SOP_READ_AT, .prio = prio, .fd = fd, .dst = buf, .len = len, .off = off }; return submit(&r); }
+int storage_write_at(int fd, uint32_t off, const void *buf, size_t len, storage_prio_t prio) { storage_req_t r = { .op = SOP_WRITE_AT, .prio = prio, .fd = fd, .src = buf, .len = len, .off = off }; return submit(&r); }
+int storage_delete(const char *path, storage_prio_t prio) { storage_req_t r = { .op = SOP_DELETE, .prio = prio, .path = path }; return submit(&r); }
+
+// Composite work (catalog, retention, logstore, directory walks) runs as one job so it sees a consistent volume
+int storage_call(storage_fn_t fn, void *arg, storage_vol_t vol, storage_prio_t prio) { storage_req_t r = { .op = SOP_CALL, .prio = prio, .vol = vol, .fd = -1, .fn = fn, .arg = arg }; return submit(&r); }
+
+bool storage_mount(void) { return storage_call(mount_job, NULL, STORAGE_VOL_FAT, STORAGE_PRIO_RECORD) == 0; }
+void storage_stop(void) { storage_call(unmount_job, NULL, STORAGE_VOL_FAT, STORAGE_PRIO_RECORD); }
+sdmmc_card_t *storage_export(void) { return storage_call(export_job, NULL, STORAGE_VOL_FAT, STORAGE_PRIO_RECORD) ? NULL : card; }
+
+// For work that reaches the card outside the service (raw block access); the service waits on the same lock
+bool storage_lock_volume(storage_vol_t vol, uint32_t timeout_ms) { return vol_lock[vol] && xSemaphoreTake(vol_lock[vol], pdMS_TO_TICKS(timeout_ms)) == pdTRUE; }
+void storage_unlock_volume(storage_vol_t vol) { if(vol_lock[vol]) xSemaphoreGive(vol_lock[vol]); }
+
+int storage_stats(char *out, size_t len) {
+    storage_lat_t a = lat[STORAGE_PRIO_RECORD], b = lat[STORAGE_PRIO_TRANSFER];
+    ESP_LOGI(TAG, "rec %lu req max %lu us, xfer %lu req max %lu us", (unsigned long)a.n, (unsigned long)a.max_us, (unsigned long)b.n, (unsigned long)b.max_us);
+    return snprintf(out, len, "STOR|%lu|%lu|%lu|%lu|%lu|%lu", (unsigned long)a.n, (unsigned long)(a.n ? a.sum_us / a.n : 0), (unsigned long)a.max_us,
+                    (unsigned long)b.n, (unsigned long)(b.n ? b.sum_us / b.n : 0), (unsigned long)b.max_us);
+}
@@ -0,0 +1,64 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Storage Service Task Header */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Definitions
+   2.0 Prototypes
+========================================*/
+
+/* ==================== 1.0 Includes & Definitions ==================== */
+#ifndef STORAGE_SERVICE_H
+#define STORAGE_SERVICE_H
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sdmmc_cmd.h"
+
+#define STORAGE_MOUNT_POINT "/sdcard"
+
+// Recording writes always leave the queue before transfer reads, whatever order they arrived in
+typedef enum { STORAGE_PRIO_RECORD, STORAGE_PRIO_TRANSFER, STORAGE_PRIO_COUNT } storage_prio_t;
+typedef enum { STORAGE_VOL_FAT, STORAGE_VOL_LOG, STORAGE_VOL_COUNT } storage_vol_t;
+typedef int (*storage_fn_t)(void *arg);
+
+/* ==================== 2.0 Prototypes ==================== */
+void storage_start(void);
+bool storage_mount(void);
+void storage_stop(void);
+sdmmc_card_t *storage_export(void);
+sdmmc_card_t *storage_card(void);
+void storage_bus_acquire(void);
+void storage_bus_release(void);
+bool storage_lock_volume(storage_vol_t vol, uint32_t timeout_ms);
+void storage_unlock_volume(storage_vol_t vol);
+
+int storage_open(const char *path, const char *mode, storage_prio_t prio);
+int storage_close(int fd, storage_prio_t prio);
+int storage_sync(int fd, storage_prio_t prio);
+int storage_append(int fd, const void *buf, size_t len, storage_prio_t prio);
+int storage_read_at(int fd, uint32_t off, void *buf, size_t len, storage_prio_t prio);
+int storage_write_at(int fd, uint32_t off, const void *buf, size_t len, storage_prio_t prio);
+int storage_delete(const char *path, storage_prio_t prio);
+int storage_call(storage_fn_t fn, void *arg, storage_vol_t vol, storage_prio_t prio);
+int storage_stats(char *out, size_t len);
+
+#endif
@@ -0,0 +1,162 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Long-Horizon Telemetry Sampler (Temperature, Motion, GPS) */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Variables
+   2.0 Storage Jobs
+   3.0 Sampler Task
+   4.0 Queries & Stats
+========================================*/
+
+/* ==================== 1.0 Includes & Variables ==================== */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "driver/gpio.h"
+#include "nvs.h"
+#include "globals.h"
+#include "gps_module.h"
+#include "rtc_module.h"
+#include "retention.h"
+#include "storage_service.h"
+#include "telemetry.h"
+
+#define TS_DIR STORAGE_MOUNT_POINT "/ts"   // Outside rec/, so retention never evicts it; its size is fixed by the rings
+#define TS_PERIOD_SEC 10                   // One raw sample of every series
+#define TS_SYNC_SEC 60                     // Longest stretch of samples a power cut can lose
+#define TS_POLL_MS 100                     // AWAKE pin polling for the motion level
+#define TS_MIN_VALID_UTC 1704067200        // 2024-01-01: before this the RTC has not been set and samples are skipped
+#define NVS_NAMESPACE "echolog_ts"
+
+static const uint32_t ring_blocks[TSDB_LEVELS] = { 8192, 4096, 1024 }; // 4 MB raw (~5 weeks at 6 series), 2 MB minute (~6 weeks), 512 KB hour (years)
+
+// Last session's append/sync cost, kept in NVS so Bluetooth mode can report it like the SD burst stats
+typedef struct { uint32_t samples, appends, append_max_us, syncs, sync_max_us; uint64_t append_us, sync_us; } ts_cost_t;
+
+static const char *TAG = "TELEMETRY";
+static tsdb_t db; static bool db_open = false; static ts_cost_t cost;
+static volatile bool ts_quit = false; static TaskHandle_t ts_h = NULL;
+
+/* ==================== 2.0 Storage Jobs ==================== */
+// The store is only ever touched on the storage task, so the sampler and a BLE query never share it mid-block
+static bool ensure_open(void) {
+    if(db_open) return true;
+    mkdir(TS_DIR, 0775);
+    if(tsdb_open(&db, TS_DIR, ring_blocks)) { ESP_LOGW(TAG, "Store unavailable"); return false; }
+    db_open = true; return true;
+}
+
+typedef struct { uint8_t series; int32_t value; } ts_value_t;
+typedef struct { uint32_t t; int n; ts_value_t v[TS_SERIES_COUNT]; } ts_sample_t;
+
+// Times each append on the storage task itself, so the figures are the store's cost and not the queue wait
+static int append_job(void *arg) {
+    ts_sample_t *s = arg; int rc = 0;
+    if(!ensure_open()) return -1;
+    uint32_t disk = tsdb_disk_bytes(&db);
+    for(int i = 0; i < s->n; i++) {
+        int64_t t0 = esp_timer_get_time(); rc |= tsdb_append(&db, s->v[i].series, s->t, s->v[i].value); uint32_t us = esp_timer_get_time() - t0;
+        cost.appends++; cost.append_us += us; if(us > cost.append_max_us) cost.append_max_us = us;
+    }
+    if(tsdb_disk_bytes(&db) > disk) retention_note_write(tsdb_disk_bytes(&db) - disk, false); // The rings grow to full size once, then wrap
+    cost.samples++; return rc;
+}
+
+static int sync_job(void *arg) {
+    if(!db_open) return 0;
+    int64_t t0 = esp_timer_get_time(); int rc = tsdb_sync(&db); uint32_t us = esp_timer_get_time() - t0;
+    cost.syncs++; cost.sync_us += us; if(us > cost.sync_max_us) cost.sync_max_us = us; return rc;
+}
+
+static int close_job(void *arg) { if(db_open) { tsdb_close(&db); db_open = false; } return 0; }
+
+/* ==================== 3.0 Sampler Task ==================== */
+// Low-rate and at transfer priority: a sample queued behind an audio burst simply waits, it never delays one
+static void ts_task(void *arg) {
+    uint32_t polls = 0, awake = 0; int64_t next = esp_timer_get_time() + TS_PERIOD_SEC * 1000000LL, next_sync = next + TS_SYNC_SEC * 1000000LL;
+    while(!ts_quit) {
+        vTaskDelay(pdMS_TO_TICKS(TS_POLL_MS));
+        polls++; awake += gpio_get_level(ADXL_PIN_NUM_INT1) == 1;
+        int64_t now = esp_timer_get_time(); if(now < next) continue;
+        ts_sample_t s = { .t = (uint32_t)time(NULL) }; int16_t c100; gps_fix_t fix;
+        if(s.t >= TS_MIN_VALID_UTC) {
+            if(rtc_read_temp_c100(&c100)) s.v[s.n++] = (ts_value_t){ TS_TEMP_C100, c100 };
+            s.v[s.n++] = (ts_value_t){ TS_MOTION_PCT, polls ? (int32_t)(awake * 100 / polls) : 0 };
+            bool have = gps_get_fix(&fix); s.v[s.n++] = (ts_value_t){ TS_GPS_SATS, fix.sats };
+            if(have) { s.v[s.n++] = (ts_value_t){ TS_GPS_HDOP_X10, fix.hdop_x10 }; s.v[s.n++] = (ts_value_t){ TS_LAT_E7, (int32_t)(fix.lat * 1e7) }; s.v[s.n++] = (ts_value_t){ TS_LON_E7, (int32_t)(fix.lon * 1e7) }; }
+            storage_call(append_job, &s, STORAGE_VOL_FAT, STORAGE_PRIO_TRANSFER);
+        }
+        polls = awake = 0; next += TS_PERIOD_SEC * 1000000LL;
+        if(now >= next_sync) { storage_call(sync_job, NULL, STORAGE_VOL_FAT, STORAGE_PRIO_TRANSFER); next_sync = now + TS_SYNC_SEC * 1000000LL; }
+    }
+    ts_h = NULL; vTaskDelete(NULL);
+}
+
+// Recording mode: the card is mounted and the ADXL armed before this is called
+void telemetry_start(void) {
+    if(ts_h) return;
+    memset(&cost, 0, sizeof(cost)); ts_quit = false;
+    xTaskCreate(ts_task, "telemetry", 4096, NULL, 2, &ts_h);
+}
+
+// Stops the sampler, writes the open blocks out and keeps this session's cost figures for Bluetooth mode
+void telemetry_stop(void) {
+    nvs_handle_t h;
+    if(!ts_h) return;
+    ts_quit = true; for(int i = 0; ts_h && i < 50; i++) vTaskDelay(pdMS_TO_TICKS(TS_POLL_MS / 2));
+    storage_call(close_job, NULL, STORAGE_VOL_FAT, STORAGE_PRIO_TRANSFER);
+    if(nvs_open(NVS_NAMESPACE, NVS_READWRITE, &h) == ESP_OK) { nvs_set_blob(h, "last", &cost, sizeof(cost)); nvs_commit(h); nvs_close(h); }
+}
+
+void telemetry_close(void) { storage_call(close_job, NULL, STORAGE_VOL_FAT, STORAGE_PRIO_TRANSFER); }
+
+/* ==================== 4.0 Queries & Stats ==================== */
+typedef struct { tsdb_level_t level; uint32_t from, to, mask; tsdb_cursor_t *cur; tsdb_point_t *pts; int max; } ts_query_t;
+static int query_job(void *arg) { ts_query_t *q = arg; return ensure_open() ? tsdb_query(&db, q->level, q->from, q->to, q->mask, q->cur, q->pts, q->max) : -1; }
+
+// One page of a range query, packed as TELEMETRY_WIRE_POINT-byte records into out. Each page is its own storage
+// request, so a long query interleaves with anything else queued for the card.
+int telemetry_query(tsdb_level_t level, uint32_t from, uint32_t to, uint32_t mask, tsdb_cursor_t *cur, uint8_t *out, int max_points) {
+    tsdb_point_t pts[32]; ts_query_t q = { level, from, to, mask, cur, pts, max_points < 32 ? max_points : 32 };
+    int n = storage_call(query_job, &q, STORAGE_VOL_FAT, STORAGE_PRIO_TRANSFER);
+    for(int i = 0; i < n; i++) {
+        uint8_t *p = out + i * TELEMETRY_WIRE_POINT; uint16_t cnt = pts[i].count > 0xFFFF ? 0xFFFF : pts[i].count;
+        memcpy(p, &pts[i].t, 4); p[4] = pts[i].series; memcpy(p + 5, &cnt, 2); memcpy(p + 7, &pts[i].mean, 4); memcpy(p + 11, &pts[i].lo, 4); memcpy(p + 15, &pts[i].hi, 4);
+    }
+    return n;
+}
+
+static int disk_job(void *arg) { return ensure_open() ? (int)(tsdb_disk_bytes(&db) >> 10) : -1; }
+
+// TSS|samples|appends|avg us|max us|syncs|avg us|max us|disk KB: live while recording, otherwise the last session's
+int telemetry_stats(char *out, size_t len) {
+    ts_cost_t c = cost; nvs_handle_t h; size_t sz = sizeof(c);
+    if(!ts_h && nvs_open(NVS_NAMESPACE, NVS_READONLY, &h) == ESP_OK) { nvs_get_blob(h, "last", &c, &sz); nvs_close(h); }
+    int kb = storage_call(disk_job, NULL, STORAGE_VOL_FAT, STORAGE_PRIO_TRANSFER);
+    return snprintf(out, len, "TSS|%lu|%lu|%lu|%lu|%lu|%lu|%lu|%d", (unsigned long)c.samples, (unsigned long)c.appends, (unsigned long)(c.appends ? c.append_us / c.appends : 0), (unsigned long)c.append_max_us,
+                    (unsigned long)c.syncs, (unsigned long)(c.syncs ? c.sync_us / c.syncs : 0), (unsigned long)c.sync_max_us, kb);
+}
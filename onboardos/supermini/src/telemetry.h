@@ -0,0 +1,55 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Long-Horizon Telemetry Sampler Header */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Definitions
+   2.0 Prototypes
+========================================*/
+
+/* ==================== 1.0 Includes & Definitions ==================== */
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+#include <stdint.h>
+#include <stddef.h>
+#include "tsdb.h"
+
+#define TELEMETRY_WIRE_POINT 19 // u32 t, u8 series, u16 count, i32 mean, i32 lo, i32 hi (little-endian) in a TSD packet
+
+// Series ids as stored on the card; values are integers in the units given
+typedef enum {
+    TS_TEMP_C100,     // DS3231 die temperature, 0.01 degC
+    TS_MOTION_PCT,    // Share of the period the ADXL reported AWAKE, %
+    TS_GPS_SATS,      // Satellites in use (reported with or without a fix)
+    TS_GPS_HDOP_X10,  // Fix only
+    TS_LAT_E7,        // Fix only, degrees * 1e7
+    TS_LON_E7,        // Fix only, degrees * 1e7
+    TS_SERIES_COUNT
+} ts_series_t;
+
+/* ==================== 2.0 Prototypes ==================== */
+void telemetry_start(void);
+void telemetry_stop(void);
+void telemetry_close(void);
+int telemetry_query(tsdb_level_t level, uint32_t from, uint32_t to, uint32_t mask, tsdb_cursor_t *cur, uint8_t *out, int max_points);
+int telemetry_stats(char *out, size_t len);
+
+#endif
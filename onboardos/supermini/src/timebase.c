@@ -0,0 +1,90 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* I2S Sample Clock to esp_timer and RTC/GPS Time Correlation */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Variables
+   2.0 Anchor Capture
+   3.0 Rate Estimation & Chunk Output
+========================================*/
+
+/* ==================== 1.0 Includes & Variables ==================== */
+#include <string.h>
+#include <sys/time.h>
+#include "esp_timer.h"
+#include "timebase.h"
+#include "gps_module.h"
+
+#define GPS_FRESH_US 2000000LL // Only trust a GPS time that arrived within the last 2 s
+
+static tb_anchor_t anchors[TIMEBASE_MAX_ANCHORS];
+static int anchor_count = 0;
+static uint32_t sample_counter = 0, rate_nominal = 16000;
+static int64_t interval_us = TIMEBASE_INTERVAL_US, next_anchor_us = 0;
+
+/* ==================== 2.0 Anchor Capture ==================== */
+// Taken right after an I2S read returns, so timer_us trails the newest sample by the DMA pipeline depth.
+// That offset is the same on every unit running this firmware and cancels out when aligning devices.
+static void capture_anchor(void) {
+    if(anchor_count == TIMEBASE_MAX_ANCHORS) { // Keep the first and every other one after it, then space them further apart
+        for(int i = 1; i < TIMEBASE_MAX_ANCHORS / 2; i++) anchors[i] = anchors[i * 2];
+        anchor_count = TIMEBASE_MAX_ANCHORS / 2; interval_us *= 2;
+    }
+    tb_anchor_t *a = &anchors[anchor_count++]; int64_t gps_utc, gps_rx;
+    a->sample_index = sample_counter; a->timer_us = esp_timer_get_time();
+    if(gps_get_time(&gps_utc, &gps_rx) && (a->timer_us - gps_rx) < GPS_FRESH_US) { a->utc_us = gps_utc + (a->timer_us - gps_rx); a->source = TB_SRC_GPS; }
+    else { struct timeval tv; gettimeofday(&tv, NULL); a->utc_us = (int64_t)tv.tv_sec * 1000000 + tv.tv_usec; a->source = TB_SRC_RTC; }
+    next_anchor_us = a->timer_us + interval_us;
+}
+
+void timebase_start_clip(uint32_t nominal_rate) {
+    rate_nominal = nominal_rate; sample_counter = 0; anchor_count = 0; interval_us = TIMEBASE_INTERVAL_US; capture_anchor();
+}
+
+void timebase_on_samples(uint32_t frames) {
+    sample_counter += frames;
+    if(esp_timer_get_time() >= next_anchor_us) capture_anchor();
+}
+
+/* ==================== 3.0 Rate Estimation & Chunk Output ==================== */
+// Samples per second of real time, in mHz. Uses the GPS anchors when there are two, otherwise esp_timer (crystal) time.
+uint32_t timebase_effective_rate_mhz(void) {
+    int first = -1, last = -1;
+    for(int i = 0; i < anchor_count; i++) if(anchors[i].source == TB_SRC_GPS) { if(first < 0) first = i; last = i; }
+    if(first < 0 || first == last) { first = 0; last = anchor_count - 1; }
+    if(last <= first) return rate_nominal * 1000;
+    int64_t dt = (anchors[first].source == TB_SRC_GPS && anchors[last].source == TB_SRC_GPS) ? anchors[last].utc_us - anchors[first].utc_us : anchors[last].timer_us - anchors[first].timer_us;
+    if(dt <= 0) return rate_nominal * 1000;
+    return (uint32_t)(((uint64_t)(anchors[last].sample_index - anchors[first].sample_index) * 1000000000ULL) / (uint64_t)dt);
+}
+
+// Builds the RIFF "tbas" chunk that follows the data chunk into out and returns its size (0 if cap is too small).
+// Layout: version(u8) count(u8) reserved(u16) nominal_rate(u32) effective_rate_mhz(u32) then count x tb_anchor_t.
+uint32_t timebase_build_chunk(uint8_t *out, size_t cap) {
+    capture_anchor(); // Closing anchor so the effective rate spans the whole clip
+    uint32_t body = 12 + anchor_count * sizeof(tb_anchor_t), eff = timebase_effective_rate_mhz();
+    if(cap < 8 + body + 1) return 0;
+    memcpy(out, "tbas", 4); memcpy(&out[4], &body, 4); out[8] = 1; out[9] = anchor_count; out[10] = 0; out[11] = 0;
+    memcpy(&out[12], &rate_nominal, 4); memcpy(&out[16], &eff, 4);
+    memcpy(&out[20], anchors, anchor_count * sizeof(tb_anchor_t));
+    if(body & 1) out[8 + body++] = 0; // RIFF chunks are word aligned
+    return 8 + body;
+}
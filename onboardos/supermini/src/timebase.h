@@ -0,0 +1,54 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Sample-Accurate Timebase Service Header */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Structs
+   2.0 Prototypes
+========================================*/
+
+/* ==================== 1.0 Includes & Structs ==================== */
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+#include <stddef.h>
+#include <stdint.h>
+
+#define TIMEBASE_MAX_ANCHORS 64
+#define TIMEBASE_CHUNK_MAX (20 + TIMEBASE_MAX_ANCHORS * 21 + 1) // tbas header, full anchor table, pad byte
+#define TIMEBASE_INTERVAL_US 10000000LL // One anchor every 10 s, doubled whenever the table fills
+
+typedef enum { TB_SRC_RTC = 0, TB_SRC_GPS = 1 } tb_source_t;
+
+// One correlation point: I2S frame index <-> esp_timer <-> UTC. Written little-endian into the WAV "tbas" chunk.
+typedef struct __attribute__((packed)) {
+    uint32_t sample_index;
+    int64_t timer_us;
+    int64_t utc_us;
+    uint8_t source;
+} tb_anchor_t;
+
+/* ==================== 2.0 Prototypes ==================== */
+void timebase_start_clip(uint32_t nominal_rate);
+void timebase_on_samples(uint32_t frames);
+uint32_t timebase_effective_rate_mhz(void);
+uint32_t timebase_build_chunk(uint8_t *out, size_t cap);
+
+#endif
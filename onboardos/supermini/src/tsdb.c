@@ -0,0 +1,265 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Embedded Time-Series Store for Low-Rate Telemetry */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Definitions
+   2.0 Record Encoding
+   3.0 Block Rings
+   4.0 Append & Rollups
+   5.0 Open, Sync & Close
+   6.0 Range Queries
+========================================*/
+
+/* ==================== 1.0 Includes & Definitions ==================== */
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+#include "tsdb.h"
+#include "crc32.h"
+
+/* Each level (raw samples, minute rollups, hour rollups) is its own file holding a ring of fixed 512-byte blocks.
+   Block seq s always lives in slot s % nblocks and blocks are written strictly in order, so the head is found by a
+   binary search over slot headers and a time range by a second one. Records are delta/varint encoded against the
+   previous record in the same block, so every block decodes on its own. Only the C library is used, so the store
+   also builds and runs on a host. */
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic, seq, t0, t1;   // t0/t1: first and last record time in the block
+    uint16_t count, used;          // Records, and bytes including this header
+    uint8_t level, version; uint16_t reserved;
+    uint32_t crc;                  // Over the whole block with this field zero
+} ts_block_hdr_t;
+
+#define HDR_LEN sizeof(ts_block_hdr_t)
+#define REC_MAX 48                 // Series byte + 5 varints, worst case
+#define REC_ROLLUP 0x10
+#define REC_SAME_T 0x20        // Same time as the previous record (all series sampled together): no dt follows
+#define BUCKET(level) ((level) == TSDB_MIN ? 60u : 3600u)
+
+static const char *level_file[TSDB_LEVELS] = { "raw.tsd", "min.tsd", "hour.tsd" };
+
+/* ==================== 2.0 Record Encoding ==================== */
+// Unsigned LEB128, and zigzag so small negative deltas stay small
+static int put_varint(uint8_t *p, uint64_t v) { int n = 0; while(v >= 0x80) { p[n++] = (uint8_t)v | 0x80; v >>= 7; } p[n++] = (uint8_t)v; return n; }
+static int get_varint(const uint8_t *p, const uint8_t *end, uint64_t *v) {
+    int n = 0; *v = 0;
+    for(int sh = 0; p + n < end && sh < 64; sh += 7) { uint8_t b = p[n++]; *v |= (uint64_t)(b & 0x7F) << sh; if(!(b & 0x80)) return n; }
+    return 0;
+}
+static uint64_t zz(int64_t d) { return ((uint64_t)d << 1) ^ (uint64_t)(d >> 63); }
+static int64_t unzz(uint64_t u) { return (int64_t)(u >> 1) ^ -(int64_t)(u & 1); }
+
+// Raw: series, dt, value delta. Rollup: series|REC_ROLLUP, dt, count, mean delta, mean - lo, hi - mean.
+static int encode(const tsdb_ring_t *r, const tsdb_point_t *p, bool rollup, uint8_t *out) {
+    int n = 0; bool same = r->count && p->t == r->t_last; out[n++] = p->series | (rollup ? REC_ROLLUP : 0) | (same ? REC_SAME_T : 0);
+    if(!same) n += put_varint(out + n, p->t - r->t_last);
+    if(rollup) n += put_varint(out + n, p->count);
+    n += put_varint(out + n, zz((int64_t)p->mean - r->last[p->series]));
+    if(rollup) { n += put_varint(out + n, (uint64_t)((int64_t)p->mean - p->lo)); n += put_varint(out + n, (uint64_t)((int64_t)p->hi - p->mean)); }
+    return n;
+}
+
+typedef struct { const uint8_t *p, *end; uint32_t t; int32_t last[TSDB_MAX_SERIES]; } ts_decoder_t;
+
+static void dec_begin(ts_decoder_t *d, const uint8_t *blk) {
+    ts_block_hdr_t h; memcpy(&h, blk, HDR_LEN);
+    d->p = blk + HDR_LEN; d->end = blk + h.used; d->t = h.t0; memset(d->last, 0, sizeof(d->last));
+}
+
+static bool take(ts_decoder_t *d, uint64_t *v) { int n = get_varint(d->p, d->end, v); d->p += n; return n > 0; }
+
+static bool dec_next(ts_decoder_t *d, tsdb_point_t *pt) {
+    uint64_t dt = 0, cnt = 1, dv, lo = 0, hi = 0;
+    if(d->p >= d->end) return false;
+    uint8_t b = *d->p++; bool rollup = b & REC_ROLLUP; pt->series = b & (TSDB_MAX_SERIES - 1);
+    if((!(b & REC_SAME_T) && !take(d, &dt)) || (rollup && !take(d, &cnt)) || !take(d, &dv) || (rollup && (!take(d, &lo) || !take(d, &hi)))) return false;
+    d->t += (uint32_t)dt; d->last[pt->series] += (int32_t)unzz(dv);
+    pt->t = d->t; pt->count = (uint32_t)cnt; pt->mean = d->last[pt->series]; pt->lo = (int32_t)(pt->mean - (int64_t)lo); pt->hi = (int32_t)(pt->mean + (int64_t)hi);
+    return true;
+}
+
+/* ==================== 3.0 Block Rings ==================== */
+static bool slot_read(tsdb_ring_t *r, int level, uint32_t slot, uint8_t *buf, ts_block_hdr_t *h) {
+    uint32_t crc;
+    if(slot >= r->size || fseek(r->f, (long)slot * TSDB_BLOCK_SIZE, SEEK_SET) || fread(buf, 1, TSDB_BLOCK_SIZE, r->f) != TSDB_BLOCK_SIZE) return false;
+    memcpy(h, buf, HDR_LEN); crc = h->crc; memset(buf + offsetof(ts_block_hdr_t, crc), 0, 4);
+    bool ok = h->magic == TSDB_MAGIC && h->version == TSDB_VERSION && h->level == level && h->used >= HDR_LEN && h->used <= TSDB_BLOCK_SIZE && crc32_update(0, buf, TSDB_BLOCK_SIZE) == crc;
+    memcpy(buf + offsetof(ts_block_hdr_t, crc), &crc, 4); return ok;
+}
+
+// Writes the open block into its slot; called when it fills and, for durability, in place while it is still filling
+static int slot_write(tsdb_ring_t *r, int level) {
+    ts_block_hdr_t h = { .magic = TSDB_MAGIC, .seq = r->seq, .t0 = r->t0, .t1 = r->t_last, .count = r->count, .used = r->fill, .level = level, .version = TSDB_VERSION };
+    uint32_t slot = r->seq % r->nblocks;
+    memset(r->buf + r->fill, 0, TSDB_BLOCK_SIZE - r->fill); memcpy(r->buf, &h, HDR_LEN);
+    h.crc = crc32_update(0, r->buf, TSDB_BLOCK_SIZE); memcpy(r->buf + offsetof(ts_block_hdr_t, crc), &h.crc, 4);
+    if(fseek(r->f, (long)slot * TSDB_BLOCK_SIZE, SEEK_SET) || fwrite(r->buf, 1, TSDB_BLOCK_SIZE, r->f) != TSDB_BLOCK_SIZE || fflush(r->f)) return -1;
+    if(slot >= r->size) r->size = slot + 1;
+    r->dirty = false; return 0;
+}
+
+static void ring_reset(tsdb_ring_t *r, uint32_t seq) { r->seq = seq; r->fill = HDR_LEN; r->count = 0; r->dirty = false; memset(r->last, 0, sizeof(r->last)); }
+
+/* ==================== 4.0 Append & Rollups ==================== */
+// The record goes into the RAM block; a sector is only written when that block fills
+static int level_append(tsdb_t *db, int level, const tsdb_point_t *p) {
+    tsdb_ring_t *r = &db->ring[level]; uint8_t rec[REC_MAX]; int n;
+    if(!r->f) return -1;
+    if(!r->count) r->t0 = r->t_last = p->t;
+    n = encode(r, p, level != TSDB_RAW, rec);
+    if(r->fill + n > TSDB_BLOCK_SIZE) {
+        if(slot_write(r, level)) return -1;
+        db->stats.blocks[level]++; ring_reset(r, r->seq + 1); r->t0 = r->t_last = p->t;
+        n = encode(r, p, level != TSDB_RAW, rec);
+    }
+    memcpy(r->buf + r->fill, rec, n); r->fill += n; r->count++; r->t_last = p->t; r->last[p->series] = p->mean; r->dirty = true;
+    db->stats.points[level]++; db->stats.enc_bytes[level] += n; return 0;
+}
+
+static void acc_add(tsdb_acc_t *a, uint32_t bucket, uint32_t count, int64_t sum, int32_t lo, int32_t hi) {
+    if(!a->count) { a->bucket = bucket; a->sum = 0; a->lo = lo; a->hi = hi; }
+    a->count += count; a->sum += sum; if(lo < a->lo) a->lo = lo; if(hi > a->hi) a->hi = hi;
+}
+
+// Closes the bucket if t has moved past it, writes its rollup and feeds that into the next level up
+static int acc_roll(tsdb_t *db, int level, uint8_t series, uint32_t t) {
+    tsdb_acc_t *a = &db->acc[level - 1][series]; int rc = 0;
+    if(!a->count || t / BUCKET(level) == a->bucket) return 0;
+    int64_t mean = a->sum >= 0 ? (a->sum + a->count / 2) / a->count : (a->sum - (int64_t)(a->count / 2)) / a->count;
+    tsdb_point_t p = { .t = a->bucket * BUCKET(level), .series = series, .count = a->count, .mean = (int32_t)mean, .lo = a->lo, .hi = a->hi };
+    rc = level_append(db, level, &p);
+    if(level + 1 < TSDB_LEVELS) { rc |= acc_roll(db, level + 1, series, p.t); acc_add(&db->acc[level][series], p.t / BUCKET(level + 1), a->count, a->sum, a->lo, a->hi); }
+    a->count = 0; return rc;
+}
+
+// The clock only moves forward inside the store: a sample older than the last one is filed at the last time, which
+// keeps every ring in time order for the binary searches (the RTC is only ever set once, forwards, from 2000).
+// Every append closes the stale buckets of all series, not just its own, so a series that stops reporting (GPS
+// losing its fix) cannot emit a rollup out of order later. Bounded cost: the rollups one append can emit are
+// smaller than a block, so it writes at most one sector per level.
+int tsdb_append(tsdb_t *db, uint8_t series, uint32_t t, int32_t value) {
+    tsdb_point_t p = { .t = t, .series = series, .count = 1, .mean = value, .lo = value, .hi = value }; int rc;
+    if(series >= TSDB_MAX_SERIES) return -1;
+    if(p.t < db->ring[TSDB_RAW].t_last) p.t = db->ring[TSDB_RAW].t_last;
+    rc = level_append(db, TSDB_RAW, &p);
+    for(int s = 0; s < TSDB_MAX_SERIES; s++) rc |= acc_roll(db, TSDB_MIN, s, p.t);
+    for(int s = 0; s < TSDB_MAX_SERIES; s++) rc |= acc_roll(db, TSDB_HOUR, s, p.t);
+    acc_add(&db->acc[0][series], p.t / 60, 1, value, value, value);
+    return rc;
+}
+
+/* ==================== 5.0 Open, Sync & Close ==================== */
+// Head = last slot of the current lap: slot i belongs to it while its seq is slot 0's seq + i
+static int ring_open(tsdb_t *db, int level, const char *dir, uint32_t nblocks) {
+    tsdb_ring_t *r = &db->ring[level]; ts_block_hdr_t h; char path[96]; long bytes; uint32_t lo = 0, hi, s0;
+    memset(r, 0, sizeof(*r)); r->nblocks = nblocks;
+    snprintf(path, sizeof(path), "%s/%s", dir, level_file[level]);
+    if(!(r->f = fopen(path, "r+b")) && !(r->f = fopen(path, "w+b"))) return -1;
+    if(fseek(r->f, 0, SEEK_END) || (bytes = ftell(r->f)) < 0) return -1;
+    r->size = (uint32_t)(bytes / TSDB_BLOCK_SIZE); if(r->size > nblocks) r->size = nblocks;
+    ring_reset(r, 0);
+    if(!slot_read(r, level, 0, db->scratch, &h)) return 0; // New or unreadable: start over at slot 0
+    s0 = h.seq; hi = r->size - 1;
+    while(lo < hi) { uint32_t mid = lo + (hi - lo + 1) / 2; if(slot_read(r, level, mid, db->scratch, &h) && h.seq == s0 + mid) lo = mid; else hi = mid - 1; }
+    slot_read(r, level, lo, db->scratch, &h);
+    if(h.used + REC_MAX > TSDB_BLOCK_SIZE) { ring_reset(r, h.seq + 1); r->t0 = r->t_last = h.t1; return 0; }
+    // Resume the partly filled head block in RAM; the decoder rebuilds the per-series deltas it was encoded against
+    ts_decoder_t d; tsdb_point_t p;
+    memcpy(r->buf, db->scratch, TSDB_BLOCK_SIZE); r->seq = h.seq; r->fill = h.used; r->count = h.count; r->t0 = h.t0; r->t_last = h.t1;
+    dec_begin(&d, r->buf); while(dec_next(&d, &p)) {}
+    memcpy(r->last, d.last, sizeof(r->last)); return 0;
+}
+
+// The open minute and hour buckets are rebuilt from what is already stored, so a restart mid-hour still yields one
+// complete rollup per bucket (to within the rounding of the stored minute means)
+static void rebuild_acc(tsdb_t *db) {
+    tsdb_point_t pts[16]; tsdb_cursor_t cur; int n; tsdb_ring_t *raw = &db->ring[TSDB_RAW];
+    if(!raw->count && !raw->seq) return;
+    memset(&cur, 0, sizeof(cur));
+    while((n = tsdb_query(db, TSDB_RAW, raw->t_last / 60 * 60, UINT32_MAX, UINT32_MAX, &cur, pts, 16)) > 0)
+        for(int i = 0; i < n; i++) acc_add(&db->acc[0][pts[i].series], pts[i].t / 60, 1, pts[i].mean, pts[i].mean, pts[i].mean);
+    memset(&cur, 0, sizeof(cur));
+    while((n = tsdb_query(db, TSDB_MIN, raw->t_last / 3600 * 3600, UINT32_MAX, UINT32_MAX, &cur, pts, 16)) > 0)
+        for(int i = 0; i < n; i++) acc_add(&db->acc[1][pts[i].series], pts[i].t / 3600, pts[i].count, (int64_t)pts[i].mean * pts[i].count, pts[i].lo, pts[i].hi);
+}
+
+// dir must exist. nblocks sets each ring's capacity (and so the most disk it will ever use); keep it fixed per card.
+int tsdb_open(tsdb_t *db, const char *dir, const uint32_t nblocks[TSDB_LEVELS]) {
+    memset(db, 0, sizeof(*db));
+    for(int l = 0; l < TSDB_LEVELS; l++) if(nblocks[l] < 2 || ring_open(db, l, dir, nblocks[l])) { tsdb_close(db); return -1; }
+    rebuild_acc(db); return 0;
+}
+
+// Rewrites each partly filled block in place and flushes it to the card: what a power cut can lose is what arrived
+// since the last sync. Costs at most one sector per level.
+int tsdb_sync(tsdb_t *db) {
+    int rc = 0;
+    for(int l = 0; l < TSDB_LEVELS; l++) {
+        tsdb_ring_t *r = &db->ring[l];
+        if(!r->f || !r->dirty) continue;
+        if(slot_write(r, l) || fsync(fileno(r->f))) rc = -1; else db->stats.syncs++;
+    }
+    return rc;
+}
+
+void tsdb_close(tsdb_t *db) { tsdb_sync(db); for(int l = 0; l < TSDB_LEVELS; l++) if(db->ring[l].f) { fclose(db->ring[l].f); db->ring[l].f = NULL; } }
+
+uint32_t tsdb_disk_bytes(const tsdb_t *db) { uint32_t n = 0; for(int l = 0; l < TSDB_LEVELS; l++) n += db->ring[l].size * TSDB_BLOCK_SIZE; return n; }
+
+/* ==================== 6.0 Range Queries ==================== */
+// Loads block seq into the scratch buffer (or points at the open block). False if it is gone or unreadable.
+static const uint8_t *block_at(tsdb_t *db, int level, uint32_t seq) {
+    tsdb_ring_t *r = &db->ring[level]; ts_block_hdr_t h;
+    if(seq == r->seq) { ts_block_hdr_t oh = { .magic = TSDB_MAGIC, .seq = r->seq, .t0 = r->t0, .t1 = r->t_last, .count = r->count, .used = r->fill, .level = level, .version = TSDB_VERSION }; memcpy(r->buf, &oh, HDR_LEN); return r->buf; }
+    return slot_read(r, level, seq % r->nblocks, db->scratch, &h) && h.seq == seq ? db->scratch : NULL;
+}
+
+// Pages through the points of one level with from <= t <= to and the series in series_mask, in time order.
+// Returns how many were written to out (0 once cur->done), or -1. The first call binary-searches for the first
+// block that can hold from, so a query near the end of a month of data reads a dozen headers, not the ring.
+int tsdb_query(tsdb_t *db, tsdb_level_t level, uint32_t from, uint32_t to, uint32_t series_mask, tsdb_cursor_t *cur, tsdb_point_t *out, int max) {
+    tsdb_ring_t *r = &db->ring[level]; int n = 0;
+    if(level >= TSDB_LEVELS || !r->f) return -1;
+    uint32_t oldest = r->seq - (r->seq < r->nblocks - 1 ? r->seq : r->nblocks - 1);
+    if(!cur->started) {
+        uint32_t lo = oldest, hi = r->seq; // First block whose last record is at or after from; the open block always qualifies
+        while(lo < hi) { uint32_t mid = lo + (hi - lo) / 2; const uint8_t *b = block_at(db, level, mid); ts_block_hdr_t h; if(b) memcpy(&h, b, HDR_LEN); if(b && h.t1 >= from) hi = mid; else lo = mid + 1; }
+        cur->seq = lo; cur->rec = 0; cur->started = true; cur->done = false;
+    }
+    if(cur->seq < oldest) { cur->seq = oldest; cur->rec = 0; } // The ring lapped between pages
+    while(!cur->done && n < max) {
+        const uint8_t *b = block_at(db, level, cur->seq); ts_decoder_t d; tsdb_point_t p; uint32_t i = 0; ts_block_hdr_t h;
+        if(!b) { if(cur->seq >= r->seq) cur->done = true; else { cur->seq++; cur->rec = 0; } continue; }
+        memcpy(&h, b, HDR_LEN);
+        if(h.count && h.t0 > to) { cur->done = true; break; }
+        dec_begin(&d, b);
+        while(n < max && dec_next(&d, &p)) {
+            if(i++ < cur->rec) continue;
+            cur->rec++;
+            if(p.t > to) { cur->done = true; break; }
+            if(p.t >= from && (series_mask >> p.series & 1)) out[n++] = p;
+        }
+        if(cur->done || n == max) break;
+        if(cur->seq == r->seq) cur->done = true; else { cur->seq++; cur->rec = 0; }
+    }
+    return n;
+}
@@ -0,0 +1,85 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Embedded Time-Series Store Header */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Definitions
+   2.0 Structs
+   3.0 Prototypes
+========================================*/
+
+/* ==================== 1.0 Includes & Definitions ==================== */
+#ifndef TSDB_H
+#define TSDB_H
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TSDB_BLOCK_SIZE 512        // One sector: a block write is a single aligned sector on the card
+#define TSDB_MAX_SERIES 16
+#define TSDB_MAGIC 0x42445354      // "TSDB"
+#define TSDB_VERSION 1
+
+typedef enum { TSDB_RAW, TSDB_MIN, TSDB_HOUR, TSDB_LEVELS } tsdb_level_t;
+
+/* ==================== 2.0 Structs ==================== */
+// One value of one series. Raw samples have count 1 and lo == hi == mean; rollups cover [t, t + 60 or 3600).
+typedef struct {
+    uint32_t t;                // UTC seconds
+    uint8_t series;
+    uint32_t count;
+    int32_t mean, lo, hi;
+} tsdb_point_t;
+
+// Where a paged query stopped; zero it before the first call
+typedef struct { uint32_t seq, rec; bool started, done; } tsdb_cursor_t;
+
+typedef struct {
+    uint32_t points[TSDB_LEVELS], blocks[TSDB_LEVELS], syncs; // Points appended, full blocks written, in-place rewrites of open blocks
+    uint64_t enc_bytes[TSDB_LEVELS];                            // Encoded record bytes, block headers excluded
+} tsdb_stats_t;
+
+typedef struct {
+    FILE *f;
+    uint32_t nblocks, size;    // Ring capacity and current file size, both in blocks
+    uint32_t seq, fill, count, t0, t_last; bool dirty;
+    int32_t last[TSDB_MAX_SERIES];
+    uint8_t buf[TSDB_BLOCK_SIZE];
+} tsdb_ring_t;
+
+typedef struct { uint32_t bucket, count; int64_t sum; int32_t lo, hi; } tsdb_acc_t;
+
+typedef struct {
+    tsdb_ring_t ring[TSDB_LEVELS];
+    tsdb_acc_t acc[TSDB_LEVELS - 1][TSDB_MAX_SERIES]; // Minute and hour buckets still open
+    tsdb_stats_t stats;
+    uint8_t scratch[TSDB_BLOCK_SIZE]; // Block being read back by a query or at open
+} tsdb_t;
+
+/* ==================== 3.0 Prototypes ==================== */
+int tsdb_open(tsdb_t *db, const char *dir, const uint32_t nblocks[TSDB_LEVELS]);
+void tsdb_close(tsdb_t *db);
+int tsdb_append(tsdb_t *db, uint8_t series, uint32_t t, int32_t value);
+int tsdb_sync(tsdb_t *db);
+int tsdb_query(tsdb_t *db, tsdb_level_t level, uint32_t from, uint32_t to, uint32_t series_mask, tsdb_cursor_t *cur, tsdb_point_t *out, int max);
+uint32_t tsdb_disk_bytes(const tsdb_t *db);
+
+#endif
@@ -0,0 +1,174 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* USB Disk Mode (TinyUSB Mass Storage) */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Definitions
+   2.0 Boot Request & Dirty Flag
+   3.0 Descriptors
+   4.0 TinyUSB Mass Storage Callbacks
+   5.0 USB Disk Mode Main
+========================================*/
+
+/* ==================== 1.0 Includes & Definitions ==================== */
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_mac.h"
+#include "nvs.h"
+#include "esp_private/usb_phy.h"
+#include "tusb.h"
+#include "globals.h"
+#include "gps_module.h"
+#include "sd_clock.h"
+#include "storage_service.h"
+#include "msc_disk.h"
+#include "usb_msc.h"
+
+#define NVS_NAMESPACE "echolog_usb"
+#define USB_VID 0x303A          // Espressif
+#define USB_PID 0x4002          // TinyUSB's PID map with only MSC set
+#define USB_POLL_MS 250         // Mode switch and cable checks between TinyUSB events
+
+static const char *TAG = "USB_MSC";
+static blockdev_t sd_dev;
+static msc_disk_t disk;
+static bool dirty_noted = false;
+static char serial[13];
+
+/* ==================== 2.0 Boot Request & Dirty Flag ==================== */
+// USB disk mode is one boot long: the BLE command sets "boot", the next boot in the Bluetooth position takes it
+static void set_flag(const char *key, uint8_t v) {
+    nvs_handle_t h;
+    if(nvs_open(NVS_NAMESPACE, NVS_READWRITE, &h) == ESP_OK) { nvs_set_u8(h, key, v); nvs_commit(h); nvs_close(h); }
+}
+
+static bool get_flag(const char *key) {
+    nvs_handle_t h; uint8_t v = 0;
+    if(nvs_open(NVS_NAMESPACE, NVS_READONLY, &h) == ESP_OK) { nvs_get_u8(h, key, &v); nvs_close(h); }
+    return v != 0;
+}
+
+void usb_msc_request(void) { set_flag("boot", 1); }
+bool usb_msc_pending(void) { return get_flag("boot"); }
+
+// Set on the first host write of a session and consumed by the next mount, which then rebuilds the catalog:
+// a host may add, rename or delete anything, and idx.dat cannot know
+bool usb_msc_take_dirty(void) { if(!get_flag("dirty")) return false; set_flag("dirty", 0); return true; }
+
+/* ==================== 3.0 Descriptors ==================== */
+static const tusb_desc_device_t desc_device = {
+    .bLength = sizeof(tusb_desc_device_t), .bDescriptorType = TUSB_DESC_DEVICE, .bcdUSB = 0x0200,
+    .bDeviceClass = 0x00, .bDeviceSubClass = 0x00, .bDeviceProtocol = 0x00, .bMaxPacketSize0 = CFG_TUD_ENDPOINT0_SIZE,
+    .idVendor = USB_VID, .idProduct = USB_PID, .bcdDevice = 0x0100, .iManufacturer = 1, .iProduct = 2, .iSerialNumber = 3, .bNumConfigurations = 1
+};
+
+#define CONFIG_TOTAL_LEN (TUD_CONFIG_DESC_LEN + TUD_MSC_DESC_LEN)
+static const uint8_t desc_config[] = {
+    TUD_CONFIG_DESCRIPTOR(1, 1, 0, CONFIG_TOTAL_LEN, 0, 100),
+    TUD_MSC_DESCRIPTOR(0, 0, 0x01, 0x81, 64), // Full speed bulk endpoints are 64 bytes
+};
+
+static const char *desc_strings[] = { NULL, "Team EchoLog", "EchoLog SD Card", serial };
+
+const uint8_t *tud_descriptor_device_cb(void) { return (const uint8_t*)&desc_device; }
+const uint8_t *tud_descriptor_configuration_cb(uint8_t index) { return desc_config; }
+
+const uint16_t *tud_descriptor_string_cb(uint8_t index, uint16_t langid) {
+    static uint16_t out[32]; uint8_t n = 0;
+    if(index == 0) { out[1] = 0x0409; n = 1; }
+    else if(index < sizeof(desc_strings) / sizeof(desc_strings[0])) { for(const char *s = desc_strings[index]; s[n] && n < 31; n++) out[1 + n] = s[n]; }
+    else return NULL;
+    out[0] = (TUSB_DESC_STRING << 8) | (2 * n + 2); return out;
+}
+
+/* ==================== 4.0 TinyUSB Mass Storage Callbacks ==================== */
+// All of these run inside tud_task_ext on the mode's own task, which holds both volume locks for the session
+static int sd_read(void *ctx, uint32_t lba, void *buf, uint32_t count) { return sd_clock_read((sdmmc_card_t*)ctx, buf, lba, count) != ESP_OK; }
+static int sd_write(void *ctx, uint32_t lba, const void *buf, uint32_t count) { return sd_clock_write((sdmmc_card_t*)ctx, buf, lba, count) != ESP_OK; }
+
+static int32_t sense(uint8_t lun, int32_t err) {
+    if(err == MSC_DISK_ERR_NOTREADY) tud_msc_set_sense(lun, SCSI_SENSE_NOT_READY, 0x3A, 0x00);               // Medium not present
+    else if(err == MSC_DISK_ERR_RANGE) tud_msc_set_sense(lun, SCSI_SENSE_ILLEGAL_REQUEST, 0x21, 0x00);       // LBA out of range
+    else if(err == MSC_DISK_ERR_RO) tud_msc_set_sense(lun, SCSI_SENSE_DATA_PROTECT, 0x27, 0x00);             // Write protected
+    else tud_msc_set_sense(lun, SCSI_SENSE_MEDIUM_ERROR, 0x11, 0x00);                                         // Unrecovered read/write error
+    return -1;
+}
+
+void tud_msc_inquiry_cb(uint8_t lun, uint8_t vendor_id[8], uint8_t product_id[16], uint8_t product_rev[4]) {
+    memcpy(vendor_id, "EchoLog", 7); memcpy(product_id, "SD Card", 7); memcpy(product_rev, "1.0", 3);
+}
+
+bool tud_msc_test_unit_ready_cb(uint8_t lun) { if(msc_disk_ready(&disk)) return true; sense(lun, MSC_DISK_ERR_NOTREADY); return false; }
+void tud_msc_capacity_cb(uint8_t lun, uint32_t *block_count, uint16_t *block_size) { msc_disk_capacity(&disk, block_count, block_size); }
+bool tud_msc_start_stop_cb(uint8_t lun, uint8_t power_condition, bool start, bool load_eject) { msc_disk_start_stop(&disk, start, load_eject); return true; }
+bool tud_msc_is_writable_cb(uint8_t lun) { return !disk.read_only; }
+
+int32_t tud_msc_read10_cb(uint8_t lun, uint32_t lba, uint32_t offset, void *buffer, uint32_t bufsize) {
+    int32_t n = msc_disk_read(&disk, lba, offset, buffer, bufsize); return n < 0 ? sense(lun, n) : n;
+}
+
+int32_t tud_msc_write10_cb(uint8_t lun, uint32_t lba, uint32_t offset, uint8_t *buffer, uint32_t bufsize) {
+    if(!dirty_noted) { set_flag("dirty", 1); dirty_noted = true; } // Before the first sector changes, so a yanked cable still counts
+    int32_t n = msc_disk_write(&disk, lba, offset, buffer, bufsize); return n < 0 ? sense(lun, n) : n;
+}
+
+// Everything TinyUSB does not answer itself. Medium removal lock is accepted (the host only ever holds it while
+// mounted); the rest is unsupported.
+int32_t tud_msc_scsi_cb(uint8_t lun, const uint8_t scsi_cmd[16], void *buffer, uint16_t bufsize) {
+    if(scsi_cmd[0] == SCSI_CMD_PREVENT_ALLOW_MEDIUM_REMOVAL) return 0;
+    tud_msc_set_sense(lun, SCSI_SENSE_ILLEGAL_REQUEST, 0x20, 0x00); return -1;
+}
+
+/* ==================== 5.0 USB Disk Mode Main ==================== */
+// The whole card, FAT and log partitions alike, goes to the host as one LUN at the card's trained SPI clock.
+// The internal PHY is shared with USB-Serial-JTAG, so the serial console is gone until the restart that ends the mode.
+// Ends on eject, on unplug after enumeration, or when the mode switch leaves the Bluetooth position.
+void usb_msc_mode_main(void) {
+    set_flag("boot", 0); gps_force_sleep();
+    storage_start(); sdmmc_card_t *card = storage_mount() ? storage_export() : NULL;
+    if(!card || !storage_lock_volume(STORAGE_VOL_FAT, 1000) || !storage_lock_volume(STORAGE_VOL_LOG, 1000)) {
+        ESP_LOGE(TAG, "No card to expose"); sys_led_state = LED_REC_ERROR; vTaskDelay(pdMS_TO_TICKS(1500)); return;
+    }
+    sd_dev = (blockdev_t){ .ctx = card, .sector_count = (uint64_t)card->csd.capacity * card->csd.sector_size / BLOCKDEV_SECTOR_SIZE, .read = sd_read, .write = sd_write };
+    msc_disk_init(&disk, &sd_dev, false); dirty_noted = false;
+    uint8_t mac[6]; esp_efuse_mac_get_default(mac); snprintf(serial, sizeof(serial), "%02X%02X%02X%02X%02X%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+
+    usb_phy_config_t phy_conf = { .controller = USB_PHY_CTRL_OTG, .target = USB_PHY_TARGET_INT, .otg_mode = USB_OTG_MODE_DEVICE };
+    usb_phy_handle_t phy = NULL;
+    if(usb_new_phy(&phy_conf, &phy) != ESP_OK || !tusb_init()) { ESP_LOGE(TAG, "USB init failed"); sys_led_state = LED_REC_ERROR; vTaskDelay(pdMS_TO_TICKS(1500)); return; }
+    ESP_LOGI(TAG, "Exposing %lu MB", (unsigned long)(sd_dev.sector_count >> 11));
+
+    int64_t t0 = esp_timer_get_time(), last_poll = 0; bool was_mounted = false;
+    while(1) {
+        tud_task_ext(USB_POLL_MS, false);
+        if(tud_mounted()) was_mounted = true;
+        else if(was_mounted) break; // Unplugged or the host reset the port
+        if(!msc_disk_ready(&disk)) { vTaskDelay(pdMS_TO_TICKS(100)); tud_task_ext(0, false); break; } // Let the eject's status phase complete
+        if(esp_timer_get_time() - last_poll > USB_POLL_MS * 1000) { last_poll = esp_timer_get_time(); if(get_system_mode() != MODE_BLUETOOTH) break; }
+    }
+    tud_disconnect();
+    uint32_t secs = (esp_timer_get_time() - t0) / 1000000;
+    ESP_LOGI(TAG, "Session %lu s: %lu KB read, %lu KB written, %lu errors", (unsigned long)secs, (unsigned long)(disk.rd_sectors >> 1), (unsigned long)(disk.wr_sectors >> 1), (unsigned long)disk.errors);
+}
@@ -0,0 +1,122 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Recording Metadata Chunks (bext / LIST INFO / elog) Implementation */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Definitions
+   2.0 Capture
+   3.0 Header Builder
+   4.0 Parser
+========================================*/
+
+/* ==================== 1.0 Includes & Definitions ==================== */
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include "esp_mac.h"
+#include "wav_meta.h"
+#include "gps_module.h"
+#include "timebase.h"
+#include "catalog.h"
+
+#define BEXT_LEN 602 // Fixed part of an EBU Tech 3285 v1 bext chunk; no coding history
+#define INFO_NAM 64  // LIST INFO strings are NUL-padded to fixed sizes so the header never moves
+#define INFO_CRD 20
+#define INFO_SFT 24
+#define INFO_CMT 112
+#define LIST_LEN (4 + 8 + INFO_NAM + 8 + INFO_CRD + 8 + INFO_SFT + 8 + INFO_CMT)
+#define HDR_USED (12 + 8 + 16 + 8 + sizeof(wav_meta_t) + 8 + BEXT_LEN + 8 + LIST_LEN + 8 + 8) // Through the JUNK and data chunk headers
+
+typedef struct __attribute__((packed)) { uint16_t format, channels; uint32_t sample_rate, byterate; uint16_t block_align, bits; } fmt_body_t;
+
+_Static_assert(HDR_USED <= WAV_META_HDR_SIZE, "metadata chunks overflow the fixed WAV header");
+
+static const char *trig_names[] = { "motion", "rollover", "spool" };
+static const char *mic_names[] = { "left", "right", "sum", "stereo" };
+
+/* ==================== 2.0 Capture ==================== */
+// Snapshot taken when a clip opens; cfg is NULL for clips replayed from the spool, whose settings were not kept
+void wav_meta_capture(wav_meta_t *m, const device_config_t *cfg, uint8_t trigger, int64_t start_time, uint32_t sample_rate, uint16_t channels) {
+    gps_fix_t fix; int64_t utc, rx; memset(m, 0, sizeof(*m));
+    m->version = WAV_META_VERSION; m->trigger = trigger; m->start_time = start_time; m->sample_rate = sample_rate; m->channels = channels; m->bits = 16;
+    esp_efuse_mac_get_default(m->device_id);
+    if(gps_get_fix(&fix)) { m->lat_e7 = (int32_t)(fix.lat * 1e7); m->lon_e7 = (int32_t)(fix.lon * 1e7); } else { m->lat_e7 = CAT_NO_GPS; m->lon_e7 = CAT_NO_GPS; }
+    m->fix_quality = fix.quality; m->sats = fix.sats; m->hdop_x10 = fix.hdop_x10; m->time_source = gps_get_time(&utc, &rx) ? TB_SRC_GPS : TB_SRC_RTC;
+    if(!cfg) { m->mic_mode = WAV_META_UNKNOWN; return; }
+    m->mic_mode = cfg->mic_mode; m->record_length_sec = cfg->record_length_sec; m->record_max_sec = cfg->record_max_sec;
+    m->accel_act_thresh = cfg->accel_act_thresh; m->accel_act_time = cfg->accel_act_time; m->accel_inact_thresh = cfg->accel_inact_thresh; m->accel_inact_time = cfg->accel_inact_time;
+}
+
+/* ==================== 3.0 Header Builder ==================== */
+static uint8_t *put_chunk(uint8_t *p, const char *id, uint32_t len) { memcpy(p, id, 4); memcpy(p + 4, &len, 4); return p + 8; }
+static uint8_t *put_str(uint8_t *p, const char *id, const char *s, uint32_t len) { p = put_chunk(p, id, len); strncpy((char*)p, s, len - 1); return p + len; }
+
+// Layout: RIFF, fmt, elog, bext, LIST INFO, JUNK padding, data. Always WAV_META_HDR_SIZE bytes, so the placeholder
+// written at open and the final header written at close are the same size and only the sizes change
+void wav_meta_build(uint8_t *out, const wav_meta_t *m, const char *stem, uint32_t data_size, uint32_t extra_size) {
+    struct tm ti; time_t t = (time_t)m->start_time; localtime_r(&t, &ti); // The stem and the RTC are local time
+    char dev[16], gps[48], txt[INFO_CMT]; uint8_t *p = out; memset(out, 0, WAV_META_HDR_SIZE);
+    const char *trig = m->trigger < 3 ? trig_names[m->trigger] : "unknown", *mic = m->mic_mode < 4 ? mic_names[m->mic_mode] : "unknown";
+    snprintf(dev, sizeof(dev), "EL%02X%02X%02X%02X%02X%02X", m->device_id[0], m->device_id[1], m->device_id[2], m->device_id[3], m->device_id[4], m->device_id[5]);
+    if(m->lat_e7 != CAT_NO_GPS) snprintf(gps, sizeof(gps), "%.6f,%.6f", m->lat_e7 / 1e7, m->lon_e7 / 1e7); else snprintf(gps, sizeof(gps), "no fix");
+
+    p = put_chunk(p, "RIFF", WAV_META_HDR_SIZE - 8 + data_size + extra_size); memcpy(p, "WAVE", 4); p += 4;
+    fmt_body_t fmt = { 1, m->channels, m->sample_rate, m->sample_rate * m->channels * m->bits / 8, m->channels * m->bits / 8, m->bits };
+    p = put_chunk(p, "fmt ", sizeof(fmt)); memcpy(p, &fmt, sizeof(fmt)); p += sizeof(fmt);
+    p = put_chunk(p, "elog", sizeof(*m)); memcpy(p, m, sizeof(*m)); p += sizeof(*m);
+
+    p = put_chunk(p, "bext", BEXT_LEN);
+    snprintf((char*)p, 256, "EchoLog %s-triggered clip, GPS %s", trig, gps); // Description
+    snprintf((char*)p + 256, 32, "EchoLog");                                 // Originator
+    snprintf((char*)p + 288, 32, "%s", dev);                                 // OriginatorReference
+    snprintf(txt, sizeof(txt), "%04d-%02d-%02d%02d:%02d:%02d", ti.tm_year + 1900, ti.tm_mon + 1, ti.tm_mday, ti.tm_hour, ti.tm_min, ti.tm_sec);
+    memcpy(p + 320, txt, 18);                                                // OriginationDate + OriginationTime, not NUL-terminated
+    uint64_t ref = (uint64_t)(ti.tm_hour * 3600 + ti.tm_min * 60 + ti.tm_sec) * m->sample_rate; memcpy(p + 338, &ref, 8); // TimeReference: samples since midnight
+    uint16_t ver = 1; memcpy(p + 346, &ver, 2); p += BEXT_LEN;
+
+    p = put_chunk(p, "LIST", LIST_LEN); memcpy(p, "INFO", 4); p += 4;
+    p = put_str(p, "INAM", stem, INFO_NAM);
+    snprintf(txt, sizeof(txt), "%04d-%02d-%02dT%02d:%02d:%02d", ti.tm_year + 1900, ti.tm_mon + 1, ti.tm_mday, ti.tm_hour, ti.tm_min, ti.tm_sec); p = put_str(p, "ICRD", txt, INFO_CRD);
+    p = put_str(p, "ISFT", "EchoLog onboardos", INFO_SFT);
+    snprintf(txt, sizeof(txt), "trigger=%s fix=%u sats=%u hdop=%u.%u mic=%s dev=%s", trig, m->fix_quality, m->sats, m->hdop_x10 / 10, m->hdop_x10 % 10, mic, dev); p = put_str(p, "ICMT", txt, INFO_CMT);
+
+    put_chunk(p, "JUNK", WAV_META_HDR_SIZE - (p - out) - 16);
+    put_chunk(out + WAV_META_HDR_SIZE - 8, "data", data_size);
+}
+
+/* ==================== 4.0 Parser ==================== */
+// Walks the chunks in the first len bytes of a file. Returns 1 with the elog block, 0 for a plain PCM16 WAV (m holds
+// the fmt fields only) and -1 for anything else. data_off stays 0 if the data chunk starts beyond len.
+int wav_meta_parse(const uint8_t *buf, size_t len, wav_meta_t *m, uint32_t *data_off, uint32_t *data_size) {
+    memset(m, 0, sizeof(*m)); m->trigger = m->fix_quality = m->time_source = m->mic_mode = WAV_META_UNKNOWN; m->lat_e7 = CAT_NO_GPS; m->lon_e7 = CAT_NO_GPS;
+    *data_off = 0; *data_size = 0; bool pcm = false; int found = 0;
+    if(len < 12 || memcmp(buf, "RIFF", 4) || memcmp(buf + 8, "WAVE", 4)) return -1;
+    for(size_t off = 12; off + 8 <= len; ) {
+        uint32_t sz; memcpy(&sz, buf + off + 4, 4); const uint8_t *b = buf + off + 8;
+        if(!memcmp(buf + off, "data", 4)) { *data_off = off + 8; *data_size = sz; break; }
+        if(sz > len - off - 8) break; // Runs past what was read (or a hostile size that would wrap off): stop here
+        if(!memcmp(buf + off, "fmt ", 4) && sz >= sizeof(fmt_body_t)) { fmt_body_t f; memcpy(&f, b, sizeof(f)); pcm = f.format == 1 && f.bits == 16 && f.channels && f.sample_rate; m->channels = f.channels; m->sample_rate = f.sample_rate; m->bits = f.bits; }
+        else if(!memcmp(buf + off, "elog", 4) && sz >= 1 && b[0] >= 1) { memcpy(m, b, sz < sizeof(*m) ? sz : sizeof(*m)); found = 1; } // Newer versions only append
+        off += 8 + (size_t)sz + (sz & 1);
+    }
+    return pcm ? found : -1;
+}
@@ -0,0 +1,69 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Recording Metadata Chunks (bext / LIST INFO / elog) Header */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Definitions
+   2.0 Structs
+   3.0 Prototypes
+========================================*/
+
+/* ==================== 1.0 Includes & Definitions ==================== */
+#ifndef WAV_META_H
+#define WAV_META_H
+#include <stdint.h>
+#include <stddef.h>
+#include "config_manager.h"
+
+#define WAV_META_HDR_SIZE 1024 // Everything before the PCM, so audio starts on a sector boundary
+#define WAV_META_VERSION 1
+#define WAV_META_UNKNOWN 0xFF  // Field not known, e.g. a clip replayed from the flash spool
+
+typedef enum { WAV_TRIG_MOTION, WAV_TRIG_ROLLOVER, WAV_TRIG_SPOOL } wav_trigger_t;
+
+/* ==================== 2.0 Structs ==================== */
+// Body of the "elog" chunk, little-endian. It sits right after fmt, so it is inside the first 100 bytes of the
+// file, and it is also the payload of the BLE meta reply. New fields are only ever appended.
+typedef struct __attribute__((packed)) {
+    uint8_t version;             // WAV_META_VERSION, 0 when parsed from a WAV without an elog chunk
+    uint8_t trigger;             // wav_trigger_t
+    uint8_t fix_quality, sats;   // GGA quality (0 = no fix) and satellites in use at clip start
+    uint16_t hdop_x10;
+    uint8_t time_source;         // tb_source_t: whether a GPS time reference was available at clip start
+    uint8_t mic_mode;            // mic_mode_t used for the clip
+    uint8_t device_id[6];        // Factory base MAC
+    uint16_t channels;
+    int64_t start_time;          // Unix seconds
+    int32_t lat_e7, lon_e7;      // Degrees * 1e7, CAT_NO_GPS without a fix
+    uint32_t sample_rate;
+    uint32_t effective_rate_mhz; // Measured I2S rate from the timebase, 0 when not known
+    uint16_t bits;
+    uint16_t record_length_sec, record_max_sec;
+    uint16_t accel_act_thresh, accel_act_time, accel_inact_thresh, accel_inact_time;
+    uint16_t reserved;
+} wav_meta_t;
+
+/* ==================== 3.0 Prototypes ==================== */
+void wav_meta_capture(wav_meta_t *m, const device_config_t *cfg, uint8_t trigger, int64_t start_time, uint32_t sample_rate, uint16_t channels);
+void wav_meta_build(uint8_t *out, const wav_meta_t *m, const char *stem, uint32_t data_size, uint32_t extra_size);
+int wav_meta_parse(const uint8_t *buf, size_t len, wav_meta_t *m, uint32_t *data_off, uint32_t *data_size);
+
+#endif
@@ -0,0 +1,134 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Framed BLE Download Protocol (Sliding Window Sender) */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Variables
+   2.0 Framing
+   3.0 Sender Window
+   4.0 Acknowledgements
+========================================*/
+
+/* ==================== 1.0 Includes & Variables ==================== */
+#include <string.h>
+#include "xfer_proto.h"
+#include "crc32.h"
+#include "lz_block.h"
+
+enum { SLOT_FREE = 0, SLOT_INFLIGHT, SLOT_ACKED, SLOT_LOST };
+
+static xfer_slot_t *slot_of(xfer_tx_t *t, uint32_t seq) { return &t->slot[seq % XFER_WINDOW]; }
+
+/* ==================== 2.0 Framing ==================== */
+static void put16(uint8_t *p, uint16_t v) { p[0] = v; p[1] = v >> 8; }
+static void put32(uint8_t *p, uint32_t v) { p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24; }
+
+// Writes the header at out; the END frame's payload (the range CRC) is written too, data payloads are the caller's
+void xfer_pack(const xfer_tx_t *t, const xfer_hdr_t *h, uint8_t *out) {
+    out[0] = XFER_MAGIC; out[1] = h->flags; put16(out + 2, h->seq); put32(out + 4, h->offset); put16(out + 8, h->len);
+    if(h->flags & XFER_F_END) put32(out + XFER_HDR_LEN, t->crc);
+}
+
+// For a frame xfer_tx_poll marked XFER_F_LZ, src holds the h->len file bytes at h->offset. Compresses as much of
+// them as fits a frame; if that is no more than a plain frame carries, the frame is sent plain instead and the flag
+// is cleared. h->len becomes the wire payload length; returns the file bytes the frame covers.
+uint16_t xfer_lz_fill(const xfer_tx_t *t, xfer_hdr_t *h, const uint8_t *src, uint8_t *payload) {
+    int used = 0, n = h->len > t->chunk ? lz_compress(src, h->len, payload + 2, t->chunk - 2, &used) : 0;
+    if(used > t->chunk) { put16(payload, used); h->len = n + 2; return used; }
+    h->flags &= ~XFER_F_LZ; if(h->len > t->chunk) h->len = t->chunk;
+    memmove(payload, src, h->len); return h->len;
+}
+
+/* ==================== 3.0 Sender Window ==================== */
+void xfer_tx_begin(xfer_tx_t *t, uint32_t start, uint32_t end, uint16_t chunk, uint16_t span, uint32_t now_ms) {
+    memset(t, 0, sizeof(*t)); t->next_off = start; t->total = end; t->chunk = chunk ? chunk : 1; t->progress_ms = now_ms;
+    t->span = span > t->chunk && t->chunk > 2 ? span : 0;
+}
+
+static uint16_t span_at(const xfer_tx_t *t, uint32_t off) { uint32_t left = t->total - off; return left < t->span ? left : t->span; }
+
+// Picks the next frame to send without changing any state, so a failed notify can simply be retried. Frames the
+// client reported missing or that have gone unacknowledged for XFER_RTO_MS go first, oldest first; then new data
+// while the window has room; then the END frame, which goes out as soon as the last data frame has. A compressed
+// frame asks for its whole span again on a resend, which compresses to the same block.
+bool xfer_tx_poll(const xfer_tx_t *t, uint32_t now_ms, xfer_hdr_t *h) {
+    for(uint32_t s = t->base; s != t->next_seq; s++) {
+        const xfer_slot_t *sl = &t->slot[s % XFER_WINDOW];
+        if(sl->state == SLOT_LOST || (sl->state == SLOT_INFLIGHT && now_ms - sl->sent_ms >= XFER_RTO_MS)) {
+            h->magic = XFER_MAGIC; h->flags = sl->flags | XFER_F_RETX; h->seq = s; h->offset = sl->offset;
+            h->len = (sl->flags & XFER_F_LZ) ? span_at(t, sl->offset) : sl->len; return true;
+        }
+    }
+    if(t->next_seq - t->base >= XFER_WINDOW || t->end_sent) return false;
+    h->magic = XFER_MAGIC; h->seq = t->next_seq; h->offset = t->next_off;
+    if(t->next_off < t->total && t->span && !t->lz_skip) { h->flags = XFER_F_LZ; h->len = span_at(t, t->next_off); }
+    else if(t->next_off < t->total) { uint32_t left = t->total - t->next_off; h->flags = 0; h->len = left < t->chunk ? left : t->chunk; }
+    else { h->flags = XFER_F_END; h->len = 4; }
+    return true;
+}
+
+// Commits a frame from xfer_tx_poll once the stack has taken it; data is the raw file bytes it carried (raw of them,
+// equal to h->len unless the frame was compressed)
+void xfer_tx_sent(xfer_tx_t *t, const xfer_hdr_t *h, const void *data, uint16_t raw, uint32_t now_ms) {
+    if(h->flags & XFER_F_RETX) {
+        xfer_slot_t *sl = slot_of(t, t->base + (uint16_t)(h->seq - (uint16_t)t->base));
+        sl->state = SLOT_INFLIGHT; sl->sent_ms = now_ms; t->retx++; return;
+    }
+    xfer_slot_t *sl = slot_of(t, t->next_seq);
+    sl->offset = h->offset; sl->len = raw; sl->flags = h->flags; sl->state = SLOT_INFLIGHT; sl->sent_ms = now_ms;
+    if(h->flags & XFER_F_END) t->end_sent = true;
+    else { t->crc = crc32_update(t->crc, data, raw); t->next_off += raw; }
+    if(h->flags & XFER_F_LZ) { t->lz_miss = 0; t->lz_frames++; t->lz_raw += raw; t->lz_wire += h->len; }
+    else if(t->span && !(h->flags & XFER_F_END)) { if(t->lz_skip) t->lz_skip--; else if(++t->lz_miss >= XFER_LZ_MISS) { t->lz_skip = XFER_LZ_SKIP; t->lz_miss = 0; } }
+    t->next_seq++; t->frames++;
+}
+
+// Time until the oldest in-flight frame is due for a resend, so a sender with a full window can sleep until then
+uint32_t xfer_tx_wait_ms(const xfer_tx_t *t, uint32_t now_ms) {
+    uint32_t w = XFER_RTO_MS;
+    for(uint32_t s = t->base; s != t->next_seq; s++) {
+        const xfer_slot_t *sl = &t->slot[s % XFER_WINDOW]; if(sl->state != SLOT_INFLIGHT) continue;
+        uint32_t age = now_ms - sl->sent_ms, left = age < XFER_RTO_MS ? XFER_RTO_MS - age : 0; if(left < w) w = left;
+    }
+    return w;
+}
+
+bool xfer_tx_done(const xfer_tx_t *t) { return t->end_sent && t->base == t->next_seq; }
+
+bool xfer_tx_stalled(const xfer_tx_t *t, uint32_t now_ms) { return now_ms - t->progress_ms > XFER_IDLE_MS; }
+
+/* ==================== 4.0 Acknowledgements ==================== */
+// ack: magic, lowest sequence still missing (LE16), bitmap of base+1..base+32 received (LE32). Everything below the
+// base is done. A hole below the highest frame the client has seen is a loss once the frame has been out for
+// XFER_NAK_HOLD_MS, which keeps an ACK written before a retransmission landed from triggering another one.
+void xfer_tx_ack(xfer_tx_t *t, const uint8_t ack[XFER_ACK_LEN], uint32_t now_ms) {
+    if(ack[0] != XFER_ACK_MAGIC) return;
+    uint16_t b16 = ack[1] | (ack[2] << 8); uint32_t bits = ack[3] | (ack[4] << 8) | (ack[5] << 16) | ((uint32_t)ack[6] << 24);
+    uint32_t base = t->base + (int16_t)(b16 - (uint16_t)t->base), hi = base;
+    if((int32_t)(base - t->base) < 0 || (int32_t)(t->next_seq - base) < 0) return; // Stale or from another transfer
+    t->acks++;
+    if(base != t->base) { while(t->base != base) slot_of(t, t->base++)->state = SLOT_FREE; t->progress_ms = now_ms; }
+    for(int i = 0; i < 32 && (int32_t)(t->next_seq - (base + 1 + i)) > 0; i++) if(bits & (1UL << i)) { hi = base + 1 + i; slot_of(t, hi)->state = SLOT_ACKED; }
+    for(uint32_t s = base; s != hi; s++) {
+        xfer_slot_t *sl = slot_of(t, s);
+        if(sl->state == SLOT_INFLIGHT && now_ms - sl->sent_ms >= XFER_NAK_HOLD_MS) sl->state = SLOT_LOST;
+    }
+}
@@ -0,0 +1,90 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* Framed BLE Download Protocol Header */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Wire Format
+   2.0 Sender State
+   3.0 Prototypes
+========================================*/
+
+/* ==================== 1.0 Includes & Wire Format ==================== */
+#ifndef XFER_PROTO_H
+#define XFER_PROTO_H
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Every download notification is a 10-byte little-endian header and up to MTU - 13 bytes of file data. Frames carry a
+   16-bit sequence number; the client writes ACKs to the command characteristic with the lowest sequence it is still
+   missing and a bitmap of the 32 after it, and the sender resends what the bitmap shows lost or what times out.
+   A transfer covers one byte range of the file (all of it unless a get resumes); frame offsets are file offsets, and
+   the last frame (XFER_F_END) has offset = end of the range and the CRC-32 of the range as its payload.
+   A get that asks for compression may send XFER_F_LZ frames: the payload is the LE16 count of file bytes the frame
+   covers and an lz_block of them, and len is the payload on the wire. Each frame compresses on its own, so a resend
+   is the same read and the same block; frames that would not carry more than a plain one go out plain. */
+#define XFER_MAGIC     0xD7 // First byte of a data frame; no text reply starts with it
+#define XFER_ACK_MAGIC 0xA5 // First byte of a client ACK: magic, base seq (2), bitmap (4)
+#define XFER_HDR_LEN   10
+#define XFER_ACK_LEN   7
+#define XFER_WINDOW    32   // Frames in flight; also the width of the ACK bitmap
+#define XFER_RTO_MS    600  // Resend an unacknowledged frame after this long
+#define XFER_NAK_HOLD_MS 150 // A gap in an ACK only counts as a loss once the frame has been out this long
+#define XFER_IDLE_MS   15000 // No ACK progress for this long: the client has gone
+
+#define XFER_F_END  0x01
+#define XFER_F_RETX 0x02
+#define XFER_F_LZ   0x04
+
+#define XFER_LZ_SPAN  2048 // File bytes offered to the compressor per frame
+#define XFER_LZ_MISS  4    // Frames in a row that did not compress before the sender stops trying for a while
+#define XFER_LZ_SKIP  32   // Plain frames sent before the next attempt
+
+typedef struct __attribute__((packed)) { uint8_t magic, flags; uint16_t seq; uint32_t offset; uint16_t len; } xfer_hdr_t;
+
+/* ==================== 2.0 Sender State ==================== */
+typedef struct { uint32_t offset, sent_ms; uint16_t len; uint8_t flags, state; } xfer_slot_t;
+
+// Sequence numbers are kept 32-bit here and truncated on the wire; the window is far smaller than the 16-bit space
+typedef struct {
+    uint32_t total, next_off, crc;    // total is the end offset of the range
+    uint32_t base, next_seq;          // Oldest unacknowledged frame and the next new one
+    uint32_t progress_ms;             // Last time the window moved
+    uint16_t chunk;                   // Data bytes per frame
+    uint16_t span;                    // File bytes offered per compressed frame, 0 for a plain transfer
+    uint16_t lz_miss, lz_skip;        // Back-off for data that does not compress (recordings, mostly)
+    bool end_sent;
+    xfer_slot_t slot[XFER_WINDOW];    // Indexed by seq % XFER_WINDOW
+    uint32_t frames, retx, acks;
+    uint32_t lz_frames, lz_raw, lz_wire; // Compressed frames sent and the file and wire bytes they carried
+} xfer_tx_t;
+
+/* ==================== 3.0 Prototypes ==================== */
+void xfer_tx_begin(xfer_tx_t *t, uint32_t start, uint32_t end, uint16_t chunk, uint16_t span, uint32_t now_ms);
+bool xfer_tx_poll(const xfer_tx_t *t, uint32_t now_ms, xfer_hdr_t *h);
+uint16_t xfer_lz_fill(const xfer_tx_t *t, xfer_hdr_t *h, const uint8_t *src, uint8_t *payload);
+void xfer_tx_sent(xfer_tx_t *t, const xfer_hdr_t *h, const void *data, uint16_t raw, uint32_t now_ms);
+void xfer_tx_ack(xfer_tx_t *t, const uint8_t ack[XFER_ACK_LEN], uint32_t now_ms);
+uint32_t xfer_tx_wait_ms(const xfer_tx_t *t, uint32_t now_ms);
+bool xfer_tx_done(const xfer_tx_t *t);
+bool xfer_tx_stalled(const xfer_tx_t *t, uint32_t now_ms);
+void xfer_pack(const xfer_tx_t *t, const xfer_hdr_t *h, uint8_t *out);
+
+#endif
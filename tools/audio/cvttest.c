@@ -0,0 +1,119 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* cvttest: Mic Conversion Kernel Tests */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Definitions
+   2.0 Reference Conversion
+   3.0 Checks
+   4.0 Main
+========================================*/
+
+/* ==================== 1.0 Includes & Definitions ==================== */
+#include <stdio.h>
+#include <string.h>
+#include "audio_convert.h"
+
+#define MAX_FRAMES 37     // Every remainder of the unrolled loops, several times over
+#define CANARY     0x5a5a // Fills the output past the end; a kernel that writes too far overwrites it
+
+static int failed;
+static void check(int ok, const char *what) { printf("%-4s %s\n", ok ? "ok" : "FAIL", what); if(!ok) failed = 1; }
+
+// Full-scale words, both sides of each int16 rail after the shift, and the smallest steps around zero
+static const int32_t edges[] = {
+    INT32_MAX, INT32_MIN, 32767 << AUDIO_SAMPLE_SHIFT, 32768 << AUDIO_SAMPLE_SHIFT, -32768 * (1 << AUDIO_SAMPLE_SHIFT),
+    -32769 * (1 << AUDIO_SAMPLE_SHIFT), 0x7fffc000, (int32_t)0x80000000u + (1 << AUDIO_SAMPLE_SHIFT), 1 << AUDIO_SAMPLE_SHIFT,
+    -(1 << AUDIO_SAMPLE_SHIFT), (1 << AUDIO_SAMPLE_SHIFT) - 1, -1, 0 };
+
+static uint32_t rnd_state = 0x9e3779b9;
+static int32_t rnd(void) { rnd_state ^= rnd_state << 13; rnd_state ^= rnd_state >> 17; rnd_state ^= rnd_state << 5; return (int32_t)rnd_state; }
+
+/* ==================== 2.0 Reference Conversion ==================== */
+// The plain per-sample arithmetic the unrolled kernels must agree with
+static int16_t ref(int64_t word) { int64_t v = word >> AUDIO_SAMPLE_SHIFT; return (int16_t)(v > 32767 ? 32767 : v < -32768 ? -32768 : v); }
+static int16_t ref_sum(int32_t l, int32_t r) { return ref((l >> 1) + (r >> 1)); }
+
+/* ==================== 3.0 Checks ==================== */
+// Interleaved L/R words: random, with the edge values mixed in so each lands at every position of the unroll
+static void fill(int32_t *in, size_t words, int round) {
+    for(size_t i = 0; i < words; i++) in[i] = (i + round) % 3 ? rnd() : edges[(i + round) % (sizeof(edges) / sizeof(edges[0]))];
+}
+
+// Runs one mode over every length from 0 to MAX_FRAMES; returns the first length that disagrees with the reference, or -1
+static int run_mode(int mode) {
+    static int32_t in[2 * MAX_FRAMES]; static int16_t out[2 * MAX_FRAMES + 8];
+    for(int round = 0; round < 40; round++) for(size_t n = 0; n <= MAX_FRAMES; n++) {
+        size_t produced = mode == 0 ? n : mode == 1 ? 2 * n : n;
+        fill(in, 2 * n, round);
+        for(size_t i = 0; i < sizeof(out) / sizeof(out[0]); i++) out[i] = CANARY;
+        switch(mode) {
+            case 0: audio_convert_mono(in, out, n); break;
+            case 1: audio_convert_stereo(in, out, n); break;
+            case 2: audio_select_channel(in, out, n, 0); break;
+            case 3: audio_select_channel(in, out, n, 1); break;
+            case 4: audio_sum_channels(in, out, n); break;
+        }
+        for(size_t i = 0; i < produced; i++) {
+            int16_t want = mode <= 1 ? ref(in[i]) : mode == 2 ? ref(in[2 * i]) : mode == 3 ? ref(in[2 * i + 1]) : ref_sum(in[2 * i], in[2 * i + 1]);
+            if(out[i] != want) return (int)n;
+        }
+        for(size_t i = produced; i < sizeof(out) / sizeof(out[0]); i++) if(out[i] != CANARY) return (int)n;
+    }
+    return -1;
+}
+
+static void check_kernels(void) {
+    static const char *names[] = { "mono", "stereo", "left", "right", "sum" };
+    char what[96];
+    for(int mode = 0; mode < 5; mode++) {
+        int n = run_mode(mode);
+        if(n < 0) snprintf(what, sizeof(what), "%s: lengths 0..%d match the reference, nothing written past the end", names[mode], MAX_FRAMES);
+        else snprintf(what, sizeof(what), "%s: wrong output at %d frames", names[mode], n);
+        check(n < 0, what);
+    }
+}
+
+// The rails by hand, so a reference that drifted with the kernel would still be caught
+static void check_clipping(void) {
+    int32_t in[8]; int16_t out[8];
+    in[0] = INT32_MAX; in[1] = INT32_MIN; in[2] = 32767 << AUDIO_SAMPLE_SHIFT; in[3] = 32768 << AUDIO_SAMPLE_SHIFT;
+    in[4] = -32768 * (1 << AUDIO_SAMPLE_SHIFT); in[5] = -32769 * (1 << AUDIO_SAMPLE_SHIFT); in[6] = 0x7fffc000; in[7] = -1;
+    audio_convert_mono(in, out, 7);
+    check(out[0] == 32767 && out[1] == -32768 && out[2] == 32767 && out[3] == 32767 && out[4] == -32768 && out[5] == -32768 && out[6] == 32767, "mono clips at the int16 rails instead of wrapping");
+    audio_convert_mono(in + 7, out, 1);
+    check(out[0] == -1, "  -1 stays -1 (arithmetic shift)");
+    audio_convert_stereo(in, out, 3);
+    check(out[0] == 32767 && out[1] == -32768 && out[3] == 32767 && out[4] == -32768, "stereo clips each channel");
+    int32_t pair[6] = { INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN, INT32_MAX, INT32_MIN };
+    audio_sum_channels(pair, out, 3);
+    check(out[0] == 32767 && out[1] == -32768 && (out[2] == 0 || out[2] == -1), "sum of two full-scale mics clips, opposite ones cancel");
+    audio_select_channel(pair + 4, out, 1, 0); audio_select_channel(pair + 4, out + 1, 1, 1); audio_select_channel(pair + 4, out + 2, 1, 2);
+    check(out[0] == 32767 && out[1] == -32768 && out[2] == -32768, "select takes left for 0 and right for any other channel");
+}
+
+/* ==================== 4.0 Main ==================== */
+int main(void) {
+    check_kernels();
+    check_clipping();
+    printf(failed ? "FAILED\n" : "all checks passed\n");
+    return failed;
+}
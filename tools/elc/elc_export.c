@@ -0,0 +1,133 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Host Tools for EchoLog Recordings */
+/* Multi-Stream Container (.elc) Exporters (WAV / CSV / GPX) */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Helpers
+   2.0 WAV
+   3.0 CSV
+   4.0 GPX
+========================================*/
+
+/* ==================== 1.0 Includes & Helpers ==================== */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "elc_reader.h"
+
+static void wr16(uint8_t *p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void wr32(uint8_t *p, uint32_t v) { wr16(p, (uint16_t)v); wr16(p + 2, (uint16_t)(v >> 16)); }
+
+// Times are the device clock (set from the DevTool or GPS) plus the chunk offset
+static void iso_time(char *out, size_t len, int64_t utc_us) {
+    time_t s = (time_t)(utc_us / 1000000); struct tm *tm = gmtime(&s);
+    if(!tm) { snprintf(out, len, "?"); return; }
+    size_t n = strftime(out, len, "%Y-%m-%dT%H:%M:%S", tm);
+    snprintf(out + n, len - n, ".%03uZ", (unsigned)((utc_us % 1000000 + 1000000) % 1000000 / 1000));
+}
+
+static int in_range(int64_t t, int64_t from_us, int64_t to_us) { return t >= from_us && (to_us < 0 || t < to_us); }
+
+/* ==================== 2.0 WAV ==================== */
+// The audio stream between from_us and to_us (to_us < 0 for the end) as plain PCM16 WAV. Only the chunks in range
+// are read: the seek index takes the reader straight to the first one.
+int elc_export_wav(elc_reader_t *r, const char *path, int64_t from_us, int64_t to_us) {
+    const elc_stream_info_t *s = elc_find_kind(r, ELC_KIND_AUDIO); elc_chunk_t c; uint8_t h[44]; uint32_t data = 0; int rc; FILE *o;
+    if(!s || !s->rate_hz || !s->channels) return ELC_ERR_NOSTREAM;
+    uint32_t frame = s->channels * 2u;
+    if(!(o = fopen(path, "wb"))) return ELC_ERR_IO;
+    memset(h, 0, sizeof(h)); fwrite(h, 1, sizeof(h), o); // Placeholder until the size is known
+    elc_seek(r, s->id, from_us);
+    while((rc = elc_next_in(r, s->id, &c)) == 1) {
+        int64_t a = 0, b = c.len / frame;
+        if(to_us >= 0 && c.t_us >= to_us) break;
+        if(c.t_us < from_us) a = ((from_us - c.t_us) * s->rate_hz + 999999) / 1000000;
+        if(to_us >= 0 && (to_us - c.t_us) * s->rate_hz / 1000000 < b) b = (to_us - c.t_us) * s->rate_hz / 1000000;
+        if(b > a) { fwrite(c.data + a * frame, frame, (size_t)(b - a), o); data += (uint32_t)(b - a) * frame; }
+    }
+    memcpy(h, "RIFF", 4); wr32(h + 4, 36 + data); memcpy(h + 8, "WAVEfmt ", 8); wr32(h + 16, 16); wr16(h + 20, 1); wr16(h + 22, s->channels);
+    wr32(h + 24, s->rate_hz); wr32(h + 28, s->rate_hz * frame); wr16(h + 32, (uint16_t)frame); wr16(h + 34, 16); memcpy(h + 36, "data", 4); wr32(h + 40, data);
+    rc = (fseek(o, 0, SEEK_SET) || fwrite(h, 1, sizeof(h), o) != sizeof(h)) ? ELC_ERR_IO : rc;
+    if(fclose(o)) rc = ELC_ERR_IO;
+    return rc < 0 ? rc : ELC_OK;
+}
+
+/* ==================== 3.0 CSV ==================== */
+static void csv_text(FILE *o, const uint8_t *p, size_t n) {
+    fputc('"', o);
+    for(size_t i = 0; i < n; i++) { if(p[i] == '"') fputc('"', o); fputc(p[i], o); }
+    fputc('"', o);
+}
+
+// One row per record of the first stream of this kind (ELC_KIND_ACCEL, ELC_KIND_GPS or ELC_KIND_EVENT), with time
+// both relative to the start of the clip and as absolute UTC
+int elc_export_csv(elc_reader_t *r, int kind, const char *path, int64_t from_us, int64_t to_us) {
+    static const char *ev_names[] = { "", "start", "stop", "rollover", "card_full" };
+    const elc_stream_info_t *s = elc_find_kind(r, kind); elc_chunk_t c; char ts[32]; int rc; FILE *o; int64_t t0 = elc_start_utc_us(r);
+    if(!s || kind == ELC_KIND_AUDIO) return ELC_ERR_NOSTREAM;
+    if(!(o = fopen(path, "w"))) return ELC_ERR_IO;
+    fputs(kind == ELC_KIND_ACCEL ? "t_s,utc,x_mg,y_mg,z_mg\n" : kind == ELC_KIND_GPS ? "t_s,utc,lat,lon,quality,sats,hdop\n" : "t_s,utc,code,event,detail\n", o);
+    elc_seek(r, s->id, from_us);
+    while((rc = elc_next_in(r, s->id, &c)) == 1) {
+        if(to_us >= 0 && c.t_us >= to_us) break;
+        if(kind == ELC_KIND_ACCEL) for(uint32_t i = 0; i + ELC_ACCEL_LEN <= c.len; i += ELC_ACCEL_LEN) {
+            const uint8_t *p = c.data + i; int64_t t = c.t_us + elc_rd32(p);
+            if(!in_range(t, from_us, to_us)) continue;
+            iso_time(ts, sizeof(ts), t0 + t); fprintf(o, "%.6f,%s,%d,%d,%d\n", t / 1e6, ts, (int16_t)elc_rd16(p + 4), (int16_t)elc_rd16(p + 6), (int16_t)elc_rd16(p + 8));
+        }
+        else if(kind == ELC_KIND_GPS) for(uint32_t i = 0; i + ELC_GPS_LEN <= c.len; i += ELC_GPS_LEN) {
+            const uint8_t *p = c.data + i;
+            if(!in_range(c.t_us, from_us, to_us)) continue;
+            iso_time(ts, sizeof(ts), t0 + c.t_us); fprintf(o, "%.6f,%s,%.7f,%.7f,%u,%u,%.1f\n", c.t_us / 1e6, ts, (int32_t)elc_rd32(p) / 1e7, (int32_t)elc_rd32(p + 4) / 1e7, p[8], p[9], elc_rd16(p + 10) / 10.0);
+        }
+        else for(uint32_t i = 0; i + ELC_EVENT_LEN <= c.len; ) {
+            uint16_t code = elc_rd16(c.data + i), n = elc_rd16(c.data + i + 2);
+            if(i + ELC_EVENT_LEN + n > c.len) break;
+            if(in_range(c.t_us, from_us, to_us)) {
+                iso_time(ts, sizeof(ts), t0 + c.t_us); fprintf(o, "%.6f,%s,%u,%s,", c.t_us / 1e6, ts, code, code < 5 ? ev_names[code] : "");
+                csv_text(o, c.data + i + ELC_EVENT_LEN, n); fputc('\n', o);
+            }
+            i += ELC_EVENT_LEN + n;
+        }
+    }
+    if(fclose(o)) return ELC_ERR_IO;
+    return rc < 0 ? rc : ELC_OK;
+}
+
+/* ==================== 4.0 GPX ==================== */
+// The GPS stream as a single GPX 1.1 track; fixes with quality 0 are never written by the firmware
+int elc_export_gpx(elc_reader_t *r, const char *path) {
+    const elc_stream_info_t *s = elc_find_kind(r, ELC_KIND_GPS); elc_chunk_t c; char ts[32]; int rc; FILE *o; int64_t t0 = elc_start_utc_us(r);
+    if(!s) return ELC_ERR_NOSTREAM;
+    if(!(o = fopen(path, "w"))) return ELC_ERR_IO;
+    iso_time(ts, sizeof(ts), t0);
+    fprintf(o, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<gpx version=\"1.1\" creator=\"EchoLog elcconv\" xmlns=\"http://www.topografix.com/GPX/1/1\">\n");
+    fprintf(o, " <metadata><time>%s</time></metadata>\n <trk><name>EchoLog %s</name><trkseg>\n", ts, ts);
+    elc_seek(r, s->id, 0);
+    while((rc = elc_next_in(r, s->id, &c)) == 1) for(uint32_t i = 0; i + ELC_GPS_LEN <= c.len; i += ELC_GPS_LEN) {
+        const uint8_t *p = c.data + i;
+        iso_time(ts, sizeof(ts), t0 + c.t_us);
+        fprintf(o, "  <trkpt lat=\"%.7f\" lon=\"%.7f\"><time>%s</time><sat>%u</sat><hdop>%.1f</hdop></trkpt>\n", (int32_t)elc_rd32(p) / 1e7, (int32_t)elc_rd32(p + 4) / 1e7, ts, p[9], elc_rd16(p + 10) / 10.0);
+    }
+    fputs(" </trkseg></trk>\n</gpx>\n", o);
+    if(fclose(o)) return ELC_ERR_IO;
+    return rc < 0 ? rc : ELC_OK;
+}
@@ -0,0 +1,189 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Host Tools for EchoLog Recordings */
+/* Multi-Stream Container (.elc) Reader Library Implementation */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Definitions
+   2.0 Chunk Access
+   3.0 Open & Recovery
+   4.0 Navigation
+========================================*/
+
+/* ==================== 1.0 Includes & Definitions ==================== */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "crc32.h"
+#include "elc_reader.h"
+
+#define ELC_MAX_STREAMS 16
+
+struct elc_reader {
+    FILE *f; uint32_t size, first, data_end, pos; // data_end: the index chunk, or the end of the last good chunk
+    int64_t start_utc_us, end_us; uint8_t device_id[6]; int complete;
+    elc_stream_info_t streams[ELC_MAX_STREAMS]; int nstreams;
+    uint8_t *index; uint32_t index_count, index_cap; // Raw ELC_INDEX_LEN entries, from the file or from a recovery scan
+    uint8_t buf[ELC_CHUNK_HDR_LEN + ELC_MAX_PAYLOAD];
+};
+
+uint16_t elc_rd16(const uint8_t *p) { return (uint16_t)(p[0] | p[1] << 8); }
+uint32_t elc_rd32(const uint8_t *p) { return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24; }
+int64_t elc_rd64(const uint8_t *p) { return (int64_t)((uint64_t)elc_rd32(p) | (uint64_t)elc_rd32(p + 4) << 32); }
+
+/* ==================== 2.0 Chunk Access ==================== */
+// Reads and verifies the chunk at off: 1 on success, 0 at the end of the data, -1 on a torn or corrupt chunk
+static int read_chunk(elc_reader_t *r, uint32_t off, elc_chunk_t *c) {
+    uint8_t *h = r->buf, z[ELC_CHUNK_HDR_LEN]; uint32_t len, crc;
+    if(off + ELC_CHUNK_HDR_LEN > r->data_end) return 0;
+    if(fseek(r->f, (long)off, SEEK_SET) || fread(h, 1, ELC_CHUNK_HDR_LEN, r->f) != ELC_CHUNK_HDR_LEN) return -1;
+    len = elc_rd16(h + 2); crc = elc_rd32(h + 4);
+    if(off + ELC_CHUNK_HDR_LEN + len > r->data_end || fread(h + ELC_CHUNK_HDR_LEN, 1, len, r->f) != len) return -1;
+    memcpy(z, h, sizeof(z)); memset(z + 4, 0, 4);
+    if(crc32_update(crc32_update(0, h + ELC_CHUNK_HDR_LEN, len), z, sizeof(z)) != crc) return -1;
+    c->stream = h[0]; c->t_us = elc_rd64(h + 8); c->offset = off; c->len = len; c->data = h + ELC_CHUNK_HDR_LEN;
+    return 1;
+}
+
+static const elc_stream_info_t *find_id(const elc_reader_t *r, int id) {
+    for(int i = 0; i < r->nstreams; i++) if(r->streams[i].id == id) return &r->streams[i];
+    return NULL;
+}
+
+// Time covered by a chunk, so the recovered length of a cut file includes its last chunk
+static int64_t chunk_span(const elc_reader_t *r, const elc_chunk_t *c) {
+    const elc_stream_info_t *s = find_id(r, c->stream);
+    if(!s) return 0;
+    if(s->kind == ELC_KIND_AUDIO && s->rate_hz && s->channels) return (int64_t)(c->len / (s->channels * 2u)) * 1000000 / s->rate_hz;
+    if(s->kind == ELC_KIND_ACCEL && c->len >= ELC_ACCEL_LEN) return elc_rd32(c->data + (c->len / ELC_ACCEL_LEN - 1) * ELC_ACCEL_LEN);
+    return 0;
+}
+
+/* ==================== 3.0 Open & Recovery ==================== */
+static int add_index(elc_reader_t *r, uint8_t stream, int64_t t_us, uint32_t off) {
+    if(r->index_count == r->index_cap) {
+        uint32_t cap = r->index_cap ? r->index_cap * 2 : 256; uint8_t *p = realloc(r->index, (size_t)cap * ELC_INDEX_LEN);
+        if(!p) return ELC_ERR_MEM;
+        r->index = p; r->index_cap = cap;
+    }
+    uint8_t *e = r->index + (size_t)r->index_count++ * ELC_INDEX_LEN; memset(e, 0, ELC_INDEX_LEN);
+    for(int i = 0; i < 8; i++) e[i] = (uint8_t)((uint64_t)t_us >> (8 * i));
+    for(int i = 0; i < 4; i++) e[8 + i] = (uint8_t)(off >> (8 * i));
+    e[12] = stream; return ELC_OK;
+}
+
+// A file cut by power loss has no footer: one pass indexes every data chunk and finds where the good data ends
+static int recover(elc_reader_t *r) {
+    uint32_t off = r->first; elc_chunk_t c;
+    while(read_chunk(r, off, &c) == 1) {
+        if(c.stream < ELC_STREAM_DECL) {
+            int64_t end = c.t_us + chunk_span(r, &c);
+            if(add_index(r, c.stream, c.t_us, off)) return ELC_ERR_MEM;
+            if(end > r->end_us) r->end_us = end;
+        }
+        off += ELC_CHUNK_HDR_LEN + c.len;
+    }
+    r->data_end = off; return ELC_OK;
+}
+
+// The footer gives the index and the length without touching the data; only a cut file is scanned
+static int load_footer(elc_reader_t *r) {
+    uint8_t ft[ELC_FOOTER_LEN]; elc_chunk_t c; uint32_t io, n;
+    if(r->size < r->first + ELC_FOOTER_LEN || fseek(r->f, (long)(r->size - ELC_FOOTER_LEN), SEEK_SET) || fread(ft, 1, sizeof(ft), r->f) != sizeof(ft)) return 0;
+    if(memcmp(ft, ELC_FOOTER_MAGIC, 4) || elc_rd32(ft + 24) != crc32_update(0, ft, 24)) return 0;
+    io = elc_rd32(ft + 4); n = elc_rd32(ft + 8); r->data_end = r->size - ELC_FOOTER_LEN;
+    if(read_chunk(r, io, &c) != 1 || c.stream != ELC_STREAM_INDEX || c.len != n * ELC_INDEX_LEN) { r->data_end = r->size; return 0; }
+    if(!(r->index = malloc(c.len ? c.len : 1))) return ELC_ERR_MEM;
+    memcpy(r->index, c.data, c.len); r->index_count = r->index_cap = n;
+    r->data_end = io; r->end_us = elc_rd64(ft + 16); r->complete = 1; return 1;
+}
+
+elc_reader_t *elc_open(const char *path, int *err) {
+    elc_reader_t *r = calloc(1, sizeof(*r)); uint8_t fh[ELC_FILE_HDR_LEN]; elc_chunk_t c; uint32_t off; long size; int e = ELC_ERR_MEM, rc;
+    if(!r) goto fail;
+    e = ELC_ERR_IO;
+    if(!(r->f = fopen(path, "rb")) || fseek(r->f, 0, SEEK_END) || (size = ftell(r->f)) < 0 || fseek(r->f, 0, SEEK_SET)) goto fail;
+    e = ELC_ERR_FORMAT;
+    if(fread(fh, 1, sizeof(fh), r->f) != sizeof(fh) || memcmp(fh, ELC_MAGIC, 4) || elc_rd16(fh + 6) < ELC_FILE_HDR_LEN) goto fail;
+    r->size = (uint32_t)size; r->first = elc_rd16(fh + 6); r->start_utc_us = elc_rd64(fh + 8); memcpy(r->device_id, fh + 16, 6);
+    r->end_us = -1; r->data_end = r->size;
+    if((rc = load_footer(r)) < 0) { e = rc; goto fail; }
+    // Declarations and the opening meta chunks lead the file
+    for(off = r->first; read_chunk(r, off, &c) == 1 && c.stream >= ELC_STREAM_DECL; off += ELC_CHUNK_HDR_LEN + c.len) {
+        if(c.stream != ELC_STREAM_DECL || c.len < ELC_DECL_LEN || r->nstreams == ELC_MAX_STREAMS) continue;
+        elc_stream_info_t *s = &r->streams[r->nstreams++];
+        s->id = c.data[0]; s->kind = c.data[1]; s->channels = elc_rd16(c.data + 2); s->rate_hz = elc_rd32(c.data + 4);
+        s->bits = elc_rd16(c.data + 8); s->record_size = elc_rd16(c.data + 10); memcpy(s->name, c.data + 12, 12); s->name[12] = 0;
+    }
+    if(!r->complete && (rc = recover(r))) { e = rc; goto fail; }
+    r->pos = r->first; if(err) *err = ELC_OK; return r;
+fail:
+    if(err) *err = e;
+    elc_close(r); return NULL;
+}
+
+void elc_close(elc_reader_t *r) { if(!r) return; if(r->f) fclose(r->f); free(r->index); free(r); }
+
+int elc_stream_count(const elc_reader_t *r) { return r->nstreams; }
+const elc_stream_info_t *elc_stream(const elc_reader_t *r, int i) { return (i >= 0 && i < r->nstreams) ? &r->streams[i] : NULL; }
+const elc_stream_info_t *elc_find_kind(const elc_reader_t *r, int kind) { for(int i = 0; i < r->nstreams; i++) if(r->streams[i].kind == kind) return &r->streams[i]; return NULL; }
+int64_t elc_start_utc_us(const elc_reader_t *r) { return r->start_utc_us; }
+int64_t elc_end_us(const elc_reader_t *r) { return r->end_us; }
+const uint8_t *elc_device_id(const elc_reader_t *r) { return r->device_id; }
+int elc_is_complete(const elc_reader_t *r) { return r->complete; }
+
+/* ==================== 4.0 Navigation ==================== */
+// Positions the reader at the last indexed chunk of the stream at or before t_us (the first chunk if there is none).
+// Chunks of one stream are in time order, so at most a few chunks are read before reaching t_us. A negative stream rewinds.
+int elc_seek(elc_reader_t *r, int stream, int64_t t_us) {
+    uint32_t best = r->first; int64_t best_t = INT64_MIN;
+    if(stream < 0) { r->pos = r->first; return ELC_OK; } // Rewind to the first chunk after the declarations
+    if(!find_id(r, stream)) return ELC_ERR_NOSTREAM;
+    for(uint32_t i = 0; i < r->index_count; i++) {
+        const uint8_t *e = r->index + (size_t)i * ELC_INDEX_LEN; int64_t t = elc_rd64(e);
+        if(e[12] == stream && t <= t_us && t >= best_t) { best_t = t; best = elc_rd32(e + 8); }
+    }
+    r->pos = best; return ELC_OK;
+}
+
+// Next chunk of any type in file order: 1, 0 at the end, or ELC_ERR_FORMAT at a corrupt chunk, after which it is the end
+int elc_next(elc_reader_t *r, elc_chunk_t *c) {
+    int rc = read_chunk(r, r->pos, c);
+    if(rc != 1) { r->pos = r->data_end; return rc < 0 ? ELC_ERR_FORMAT : 0; }
+    r->pos += ELC_CHUNK_HDR_LEN + c->len; return 1;
+}
+
+int elc_next_in(elc_reader_t *r, int stream, elc_chunk_t *c) {
+    int rc;
+    while((rc = elc_next(r, c)) == 1) if(c->stream == stream) return 1;
+    return rc;
+}
+
+// Copies the payload of the first meta chunk with this tag. Tags written at open ("elog") are found in the first
+// few chunks; ones written at close ("tbas") take a pass over the file. Returns the length, or -1 if absent.
+int elc_meta(elc_reader_t *r, const char *tag, uint8_t *out, size_t cap) {
+    elc_chunk_t c; uint32_t save = r->pos; int found = -1;
+    r->pos = r->first;
+    while(elc_next(r, &c) == 1) {
+        if(c.stream != ELC_STREAM_META || c.len < 4 || memcmp(c.data, tag, 4)) continue;
+        found = (int)(c.len - 4); memcpy(out, c.data + 4, (size_t)found < cap ? (size_t)found : cap); break;
+    }
+    r->pos = save; return found;
+}
@@ -0,0 +1,82 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Host Tools for EchoLog Recordings */
+/* Multi-Stream Container (.elc) Reader Library Header */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Types
+   2.0 Reader
+   3.0 Exporters
+========================================*/
+
+/* ==================== 1.0 Includes & Types ==================== */
+// Portable C99 over stdio: no packed structs and no host endianness assumptions, so it builds anywhere
+// the analysts run it. The format itself is defined once, in the firmware's elc_format.h.
+#ifndef ELC_READER_H
+#define ELC_READER_H
+#include <stdint.h>
+#include <stddef.h>
+#include "elc_format.h"
+
+typedef enum { ELC_OK = 0, ELC_ERR_IO = -1, ELC_ERR_FORMAT = -2, ELC_ERR_NOSTREAM = -3, ELC_ERR_MEM = -4 } elc_err_t;
+
+typedef struct {
+    uint8_t id, kind;          // kind: elc_kind_t
+    uint16_t channels;
+    uint32_t rate_hz;
+    uint16_t bits, record_size;
+    char name[13];
+} elc_stream_info_t;
+
+// One chunk as returned by elc_next; data stays valid until the next call on the same reader
+typedef struct {
+    uint8_t stream;
+    int64_t t_us;              // Relative to elc_start_utc_us
+    uint32_t offset, len;
+    const uint8_t *data;
+} elc_chunk_t;
+
+typedef struct elc_reader elc_reader_t;
+
+/* ==================== 2.0 Reader ==================== */
+elc_reader_t *elc_open(const char *path, int *err);
+void elc_close(elc_reader_t *r);
+int elc_stream_count(const elc_reader_t *r);
+const elc_stream_info_t *elc_stream(const elc_reader_t *r, int i);
+const elc_stream_info_t *elc_find_kind(const elc_reader_t *r, int kind);
+int64_t elc_start_utc_us(const elc_reader_t *r);
+int64_t elc_end_us(const elc_reader_t *r);
+const uint8_t *elc_device_id(const elc_reader_t *r);
+int elc_is_complete(const elc_reader_t *r);
+int elc_seek(elc_reader_t *r, int stream, int64_t t_us);
+int elc_next(elc_reader_t *r, elc_chunk_t *c);
+int elc_next_in(elc_reader_t *r, int stream, elc_chunk_t *c);
+int elc_meta(elc_reader_t *r, const char *tag, uint8_t *out, size_t cap);
+
+uint16_t elc_rd16(const uint8_t *p);
+uint32_t elc_rd32(const uint8_t *p);
+int64_t elc_rd64(const uint8_t *p);
+
+/* ==================== 3.0 Exporters ==================== */
+int elc_export_wav(elc_reader_t *r, const char *path, int64_t from_us, int64_t to_us);
+int elc_export_csv(elc_reader_t *r, int kind, const char *path, int64_t from_us, int64_t to_us);
+int elc_export_gpx(elc_reader_t *r, const char *path);
+
+#endif
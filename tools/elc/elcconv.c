@@ -0,0 +1,83 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Host Tools for EchoLog Recordings */
+/* elcconv: Inspect and Convert .elc Recordings */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Usage
+   2.0 Info
+   3.0 Main
+========================================*/
+
+/* ==================== 1.0 Includes & Usage ==================== */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "elc_reader.h"
+
+static const char *kind_names[] = { "?", "audio", "accel", "gps", "event" };
+
+static int usage(void) {
+    fprintf(stderr, "usage: elcconv info <file.elc>\n"
+                    "       elcconv wav <file.elc> <out.wav> [from_s [to_s]]\n"
+                    "       elcconv csv <file.elc> <accel|gps|events> <out.csv> [from_s [to_s]]\n"
+                    "       elcconv gpx <file.elc> <out.gpx>\n");
+    return 2;
+}
+
+static const char *err_str(int e) {
+    switch(e) { case ELC_ERR_IO: return "I/O error"; case ELC_ERR_FORMAT: return "not an .elc file or corrupt"; case ELC_ERR_NOSTREAM: return "no such stream in this file"; case ELC_ERR_MEM: return "out of memory"; default: return "ok"; }
+}
+
+/* ==================== 2.0 Info ==================== */
+static int info(elc_reader_t *r) {
+    const uint8_t *d = elc_device_id(r); elc_chunk_t c; uint32_t chunks[256] = {0}; uint64_t bytes[256] = {0}; uint8_t meta[64]; int rc;
+    printf("device    %02X%02X%02X%02X%02X%02X\n", d[0], d[1], d[2], d[3], d[4], d[5]);
+    printf("start     %lld us UTC\nduration  %.3f s%s\n", (long long)elc_start_utc_us(r), elc_end_us(r) / 1e6, elc_is_complete(r) ? "" : " (no footer: recovered from a cut file)");
+    elc_seek(r, -1, 0);
+    while(elc_next(r, &c) == 1) { chunks[c.stream]++; bytes[c.stream] += c.len; }
+    for(int i = 0; i < elc_stream_count(r); i++) {
+        const elc_stream_info_t *s = elc_stream(r, i);
+        printf("stream %u  %-6s %-12s %u ch  %lu Hz  %u bit  %lu chunks  %llu bytes\n", s->id, kind_names[s->kind < 5 ? s->kind : 0], s->name, s->channels,
+               (unsigned long)s->rate_hz, s->bits, (unsigned long)chunks[s->id], (unsigned long long)bytes[s->id]);
+    }
+    if((rc = elc_meta(r, "elog", meta, sizeof(meta))) > 0) printf("meta      elog, %d bytes (recording metadata, same block as a WAV clip)\n", rc);
+    if((rc = elc_meta(r, "tbas", meta, sizeof(meta))) > 0) printf("meta      tbas, %d bytes (clock anchors)\n", rc);
+    return 0;
+}
+
+/* ==================== 3.0 Main ==================== */
+int main(int argc, char **argv) {
+    int err = 0, rc; elc_reader_t *r;
+    if(argc < 3) return usage();
+    if(!(r = elc_open(argv[2], &err))) { fprintf(stderr, "%s: %s\n", argv[2], err_str(err)); return 1; }
+    if(!strcmp(argv[1], "info")) rc = info(r);
+    else if(!strcmp(argv[1], "wav") && argc >= 4) rc = elc_export_wav(r, argv[3], argc > 4 ? (int64_t)(atof(argv[4]) * 1e6) : 0, argc > 5 ? (int64_t)(atof(argv[5]) * 1e6) : -1);
+    else if(!strcmp(argv[1], "csv") && argc >= 5) {
+        int kind = !strcmp(argv[3], "accel") ? ELC_KIND_ACCEL : !strcmp(argv[3], "gps") ? ELC_KIND_GPS : !strcmp(argv[3], "events") ? ELC_KIND_EVENT : 0;
+        rc = kind ? elc_export_csv(r, kind, argv[4], argc > 5 ? (int64_t)(atof(argv[5]) * 1e6) : 0, argc > 6 ? (int64_t)(atof(argv[6]) * 1e6) : -1) : (elc_close(r), usage());
+        if(!kind) return rc;
+    }
+    else if(!strcmp(argv[1], "gpx") && argc >= 4) rc = elc_export_gpx(r, argv[3]);
+    else { elc_close(r); return usage(); }
+    elc_close(r);
+    if(rc < 0) { fprintf(stderr, "elcconv: %s\n", err_str(rc)); return 1; }
+    return 0;
+}
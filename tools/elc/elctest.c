@@ -0,0 +1,201 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* elctest: Container Reader & Exporter Tests */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Test Clip
+   2.0 Writer
+   3.0 Checks
+   4.0 Main
+========================================*/
+
+/* ==================== 1.0 Includes & Test Clip ==================== */
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "crc32.h"
+#include "elc_reader.h"
+
+// A 20 s clip laid out the way the firmware writes one: 16 kHz mono audio in 0.5 s chunks whose samples count up,
+// 400 Hz accel in 20-record batches, a GPS fix a second and a start and stop event. The seek index only gets every
+// fourth audio and accel chunk (one entry per stream every 2 s), so a seek has to read forward a few chunks.
+#define CLIP_S      20
+#define RATE        16000
+#define HALF        (RATE / 2)               // Samples per audio chunk
+#define T_UTC       1760000000000000LL       // 2025-10-09T08:53:20Z
+#define CHUNK_US(k) ((int64_t)(k) * 500000)
+enum { S_AUDIO, S_ACCEL, S_GPS, S_EVENT };
+
+static char dir[] = "/tmp/elctestXXXXXX";
+static int failed;
+
+static void check(int ok, const char *what) { printf("%-4s %s\n", ok ? "ok" : "FAIL", what); if(!ok) failed = 1; }
+static const char *tmp(const char *name) { static char path[4][64]; static int n; char *p = path[n++ % 4]; snprintf(p, 64, "%s/%s", dir, name); return p; }
+
+static int16_t sample(uint32_t i) { return (int16_t)(i * 3); }
+static int32_t lat_at(int s) { return 454215000 + s * 10; }
+
+/* ==================== 2.0 Writer ==================== */
+// The records are the packed structs from elc_format.h, written as they are in memory: this runs on little-endian
+// hosts only, like the firmware writing them.
+static FILE *out; static uint32_t pos; static elc_index_t idx[256]; static uint32_t nidx, nchunks;
+
+static void put_chunk(uint8_t stream, int64_t t_us, const void *data, uint16_t len, int indexed) {
+    elc_chunk_hdr_t h = { stream, 0, len, 0, t_us };
+    h.crc = crc32_update(crc32_update(0, data, len), &h, sizeof(h));
+    if(indexed && nidx < 256) { idx[nidx].t_us = t_us; idx[nidx].offset = pos; idx[nidx].stream = stream; nidx++; }
+    fwrite(&h, sizeof(h), 1, out); fwrite(data, 1, len, out); pos += sizeof(h) + len; nchunks++;
+}
+
+static void put_event(int64_t t_us, uint16_t code, const char *detail) {
+    uint8_t b[64]; elc_event_t e = { code, (uint16_t)strlen(detail) };
+    memcpy(b, &e, sizeof(e)); memcpy(b + sizeof(e), detail, e.len); put_chunk(S_EVENT, t_us, b, sizeof(e) + e.len, 1);
+}
+
+// Writes the clip; returns the offset just past the data, where the index chunk starts
+static uint32_t write_clip(const char *path) {
+    elc_file_hdr_t fh = { { 'E', 'L', 'C', 'F' }, ELC_VERSION, sizeof(elc_file_hdr_t), T_UTC, { 0x24, 0x58, 0x7c, 0x01, 0x02, 0x03 }, 0 };
+    elc_stream_decl_t decl[4] = {
+        { S_AUDIO, ELC_KIND_AUDIO, 1, RATE, 16, 2, "mic" }, { S_ACCEL, ELC_KIND_ACCEL, 3, 400, 16, ELC_ACCEL_LEN, "adxl362" },
+        { S_GPS, ELC_KIND_GPS, 1, 1, 0, ELC_GPS_LEN, "pa1010d" }, { S_EVENT, ELC_KIND_EVENT, 0, 0, 0, 0, "events" } };
+    static int16_t pcm[HALF]; uint8_t meta[4 + 16] = "elog";
+    out = fopen(path, "wb"); pos = 0; nidx = nchunks = 0;
+    fwrite(&fh, sizeof(fh), 1, out); pos += sizeof(fh);
+    for(int i = 0; i < 4; i++) put_chunk(ELC_STREAM_DECL, 0, &decl[i], sizeof(decl[i]), 0);
+    memset(meta + 4, 0x5a, 16); put_chunk(ELC_STREAM_META, 0, meta, sizeof(meta), 0);
+    put_event(0, ELC_EV_START, "motion, \"manual\"");
+    for(int k = 0; k < CLIP_S * 2; k++) {
+        elc_accel_t a[20];
+        for(int i = 0; i < 20; i++) { a[i].dt_us = i * 25000; a[i].x = (int16_t)k; a[i].y = (int16_t)i; a[i].z = 1000; }
+        put_chunk(S_ACCEL, CHUNK_US(k), a, sizeof(a), k % 4 == 0);
+        if(k % 2 == 0) { elc_gps_t g = { lat_at(k / 2), -756972000, 1, 7, 12 }; put_chunk(S_GPS, CHUNK_US(k), &g, sizeof(g), 1); }
+        for(int i = 0; i < HALF; i++) pcm[i] = sample((uint32_t)k * HALF + i);
+        put_chunk(S_AUDIO, CHUNK_US(k), pcm, sizeof(pcm), k % 4 == 0);
+    }
+    put_event(CHUNK_US(CLIP_S * 2), ELC_EV_STOP, "button");
+    uint32_t data_end = pos; uint32_t chunks = nchunks;
+    put_chunk(ELC_STREAM_INDEX, 0, idx, (uint16_t)(nidx * sizeof(elc_index_t)), 0);
+    elc_footer_t ft = { { 'E', 'L', 'C', 'X' }, data_end, nidx, chunks, CHUNK_US(CLIP_S * 2), 0 };
+    ft.crc = crc32_update(0, &ft, offsetof(elc_footer_t, crc));
+    fwrite(&ft, sizeof(ft), 1, out); fclose(out);
+    return data_end;
+}
+
+// The first len bytes of src, optionally with one byte flipped: a clip cut by power loss, or one with a bad sector
+static void copy_cut(const char *src, const char *dst, uint32_t len, long flip) {
+    FILE *i = fopen(src, "rb"), *o = fopen(dst, "wb"); uint8_t *b = malloc(len);
+    if(fread(b, 1, len, i) == len) { if(flip >= 0) b[flip] ^= 0x40; fwrite(b, 1, len, o); }
+    free(b); fclose(i); fclose(o);
+}
+
+/* ==================== 3.0 Checks ==================== */
+static char *slurp(const char *path, long *len) {
+    FILE *f = fopen(path, "rb"); char *b = NULL; *len = -1;
+    if(f && !fseek(f, 0, SEEK_END) && (*len = ftell(f)) >= 0 && !fseek(f, 0, SEEK_SET) && (b = malloc(*len + 1)) && fread(b, 1, *len, f) == (size_t)*len) b[*len] = 0;
+    if(f) fclose(f);
+    return b;
+}
+
+static int count_lines(const char *text, const char *needle) { int n = 0; for(const char *p = text; (p = strstr(p, needle)); p++) n++; return n; }
+
+// Seeks each stream to t and reads forward to the chunk holding t: it must start at or before t and get there
+// within the index spacing
+static int seek_ok(elc_reader_t *r, int stream, int64_t t, int64_t span) {
+    elc_chunk_t c; int reads = 0;
+    if(elc_seek(r, stream, t)) return 0;
+    while(elc_next_in(r, stream, &c) == 1 && ++reads <= 4) {
+        if(reads == 1 && c.t_us > t) return 0;
+        if(c.t_us <= t && t < c.t_us + span) return 1;
+    }
+    return 0;
+}
+
+// A WAV export must hold exactly the samples [first, end) of the clip
+static int wav_ok(const char *path, uint32_t first, uint32_t end) {
+    long len; uint8_t *b = (uint8_t *)slurp(path, &len); int ok = b && len == 44 + (long)(end - first) * 2 && !memcmp(b, "RIFF", 4) && elc_rd32(b + 24) == RATE && elc_rd16(b + 22) == 1 && elc_rd32(b + 40) == (end - first) * 2;
+    for(uint32_t i = first; ok && i < end; i++) ok = (int16_t)elc_rd16(b + 44 + (i - first) * 2) == sample(i);
+    free(b); return ok;
+}
+
+static void check_complete(const char *clip) {
+    int err; elc_reader_t *r = elc_open(clip, &err); uint8_t meta[32]; char line[96], *text; long len;
+    check(r && elc_is_complete(r) && elc_stream_count(r) == 4, "complete clip opens from its footer with 4 streams");
+    if(!r) return;
+    check(elc_end_us(r) == CHUNK_US(CLIP_S * 2) && elc_start_utc_us(r) == T_UTC && elc_device_id(r)[0] == 0x24, "length, start time and device id");
+    check(elc_meta(r, "elog", meta, sizeof(meta)) == 16 && meta[0] == 0x5a && elc_meta(r, "tbas", meta, sizeof(meta)) < 0, "meta chunk by tag");
+
+    int ok = 1;
+    for(int64_t t = 0; t < CHUNK_US(CLIP_S * 2); t += 730000) ok &= seek_ok(r, S_AUDIO, t, 500000) && seek_ok(r, S_ACCEL, t, 500000) && seek_ok(r, S_GPS, t, 1000000);
+    check(ok, "seek by time lands on or just before the chunk, for audio, accel and gps");
+
+    check(!elc_export_wav(r, tmp("all.wav"), 0, -1) && wav_ok(tmp("all.wav"), 0, CLIP_S * RATE), "wav export of the whole clip");
+    check(!elc_export_wav(r, tmp("cut.wav"), 1300000, 7250000) && wav_ok(tmp("cut.wav"), 20800, 116000), "wav export of 1.3 s to 7.25 s, sample exact");
+
+    check(!elc_export_csv(r, ELC_KIND_ACCEL, tmp("a.csv"), 2000000, 3000000) && (text = slurp(tmp("a.csv"), &len)), "accel csv export of 2 s to 3 s");
+    if(text) {
+        check(count_lines(text, "\n") == 41 && !strncmp(text, "t_s,utc,x_mg,y_mg,z_mg\n2.000000,2025-10-09T08:53:22.000Z,4,0,1000\n", 66) && strstr(text, "\n2.975000,2025-10-09T08:53:22.975Z,5,19,1000\n"), "  40 rows with relative and UTC time, first and last exact");
+        free(text);
+    }
+    check(!elc_export_csv(r, ELC_KIND_GPS, tmp("g.csv"), 0, -1) && (text = slurp(tmp("g.csv"), &len)), "gps csv export");
+    if(text) { snprintf(line, sizeof(line), "\n19.000000,2025-10-09T08:53:39.000Z,%.7f,-75.6972000,1,7,1.2\n", lat_at(19) / 1e7); check(count_lines(text, "\n") == CLIP_S + 1 && strstr(text, line), "  one row per fix"); free(text); }
+    check(!elc_export_csv(r, ELC_KIND_EVENT, tmp("e.csv"), 0, -1) && (text = slurp(tmp("e.csv"), &len)), "events csv export");
+    if(text) { check(strstr(text, "0.000000,2025-10-09T08:53:20.000Z,1,start,\"motion, \"\"manual\"\"\"\n") && strstr(text, ",2,stop,\"button\"\n"), "  start and stop, detail quoted"); free(text); }
+    check(!elc_export_gpx(r, tmp("t.gpx")) && (text = slurp(tmp("t.gpx"), &len)), "gpx export");
+    if(text) { check(count_lines(text, "<trkpt ") == CLIP_S && strstr(text, "<trkpt lat=\"45.4215000\" lon=\"-75.6972000\"><time>2025-10-09T08:53:20.000Z</time><sat>7</sat><hdop>1.2</hdop></trkpt>") && strstr(text, "</gpx>\n"), "  one trackpoint per fix"); free(text); }
+    elc_close(r);
+}
+
+// Power lost part way into the audio chunk that starts at 12 s: no footer, so the reader rebuilds the index by
+// scanning and everything before that chunk must still export. A flipped byte further back ends the data there.
+static void check_cut(const char *clip, uint32_t data_end) {
+    int err; elc_reader_t *r; elc_chunk_t c; uint32_t cut = 0;
+    if((r = elc_open(clip, &err))) { elc_seek(r, S_AUDIO, 12000000); if(elc_next_in(r, S_AUDIO, &c) == 1 && c.t_us == 12000000) cut = c.offset + ELC_CHUNK_HDR_LEN + 5000; elc_close(r); }
+    check(cut && cut < data_end, "cut point found");
+    copy_cut(clip, tmp("cut.elc"), cut, -1);
+    r = elc_open(tmp("cut.elc"), &err);
+    check(r && !elc_is_complete(r) && elc_stream_count(r) == 4 && elc_end_us(r) == 12475000, "cut clip opens by recovery, ending with the last whole chunk (accel at 12 s)");
+    if(r) {
+        check(seek_ok(r, S_AUDIO, 11900000, 500000) && seek_ok(r, S_ACCEL, 3300000, 500000), "seek works on the rebuilt index");
+        check(!elc_export_wav(r, tmp("rec.wav"), 0, -1) && wav_ok(tmp("rec.wav"), 0, 24 * HALF), "wav export of a cut clip has every sample before the cut");
+        check(!elc_export_csv(r, ELC_KIND_GPS, tmp("rec.csv"), 0, -1), "csv export of a cut clip");
+        elc_close(r);
+    }
+    copy_cut(clip, tmp("bad.elc"), cut, cut - 3 * (ELC_CHUNK_HDR_LEN + HALF * 2));
+    r = elc_open(tmp("bad.elc"), &err);
+    check(r && !elc_is_complete(r) && elc_end_us(r) < 12000000 && elc_end_us(r) >= 10000000, "a corrupt chunk ends the recovered data there");
+    if(r) elc_close(r);
+}
+
+/* ==================== 4.0 Main ==================== */
+int main(void) {
+    if(!mkdtemp(dir)) { perror("mkdtemp"); return 1; }
+    char clip[64]; snprintf(clip, sizeof(clip), "%s", tmp("clip.elc"));
+    uint32_t data_end = write_clip(clip);
+    check_complete(clip);
+    check_cut(clip, data_end);
+    static const char *files[] = { "clip.elc", "all.wav", "cut.wav", "a.csv", "g.csv", "e.csv", "t.gpx", "cut.elc", "rec.wav", "rec.csv", "bad.elc" };
+    for(size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) remove(tmp(files[i]));
+    rmdir(dir);
+    printf(failed ? "FAILED\n" : "all checks passed\n");
+    return failed;
+}
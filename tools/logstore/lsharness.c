@@ -0,0 +1,213 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* lsharness: Log Store Power-Cut Harness */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Definitions
+   2.0 File-Backed Block Device
+   3.0 Workload
+   4.0 Recovery Checks
+   5.0 Main
+========================================*/
+
+/* ==================== 1.0 Includes & Definitions ==================== */
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "logstore.h"
+
+#define SLOTS     24     // Ring size; the workload writes about 30 slots, so it wraps
+#define CHUNK     2048   // Append size, one recording-mode I2S read
+#define MAX_ENT   16
+
+enum { OP_BEGIN, OP_HIDDEN, OP_APPEND, OP_END, OP_DELETE };
+typedef struct { uint8_t op; uint32_t n; } step_t; // n: bytes for OP_APPEND, entry number for OP_DELETE
+
+// Recordings, a hidden bench entry and deletions, ending with a clip still open as if the card lost power mid-recording
+static const step_t workload[] = {
+    { OP_BEGIN, 0 }, { OP_APPEND, 40000 }, { OP_END, 0 },
+    { OP_BEGIN, 0 }, { OP_APPEND, 100000 }, { OP_END, 0 },
+    { OP_HIDDEN, 0 }, { OP_APPEND, 35000 }, { OP_END, 0 },
+    { OP_DELETE, 0 },
+    { OP_BEGIN, 0 }, { OP_APPEND, 70000 }, { OP_END, 0 },
+    { OP_BEGIN, 0 }, { OP_APPEND, 150000 }, { OP_END, 0 },
+    { OP_BEGIN, 0 }, { OP_APPEND, 20000 }, { OP_END, 0 },
+    { OP_DELETE, 3 },
+    { OP_BEGIN, 0 }, { OP_APPEND, 200000 }, { OP_END, 0 },
+    { OP_BEGIN, 0 }, { OP_APPEND, 90000 }, { OP_END, 0 },
+    { OP_BEGIN, 0 }, { OP_APPEND, 70000 },
+};
+
+static uint8_t pattern(int entry, uint32_t off) { return (uint8_t)(off * 7 + entry * 31 + (off >> 9)); }
+
+/* ==================== 2.0 File-Backed Block Device ==================== */
+// Sectors live in an image file. A power cut at sector write N lands every sector before it, tears sector N (its
+// first half new, the rest old) when torn is set, and fails that write and all I/O after it until the next mount.
+typedef struct { FILE *f; long writes, cut; int torn, dead; } image_t;
+
+static int img_read(void *ctx, uint32_t lba, void *buf, uint32_t count) {
+    image_t *im = ctx; if(im->dead) return -1;
+    return fseek(im->f, (long)lba * BLOCKDEV_SECTOR_SIZE, SEEK_SET) || fread(buf, BLOCKDEV_SECTOR_SIZE, count, im->f) != count;
+}
+
+static int img_write(void *ctx, uint32_t lba, const void *buf, uint32_t count) {
+    image_t *im = ctx; const uint8_t *p = buf; if(im->dead) return -1;
+    for(uint32_t i = 0; i < count; i++, im->writes++) {
+        if(fseek(im->f, (long)(lba + i) * BLOCKDEV_SECTOR_SIZE, SEEK_SET)) return -1;
+        if(im->writes == im->cut) { if(im->torn) fwrite(p + i * BLOCKDEV_SECTOR_SIZE, 1, BLOCKDEV_SECTOR_SIZE / 2, im->f); im->dead = 1; fflush(im->f); return -1; }
+        if(fwrite(p + i * BLOCKDEV_SECTOR_SIZE, BLOCKDEV_SECTOR_SIZE, 1, im->f) != 1) return -1;
+    }
+    return 0;
+}
+
+static void img_blank(image_t *im) {
+    static const uint8_t zero[BLOCKDEV_SECTOR_SIZE];
+    rewind(im->f); for(int i = 0; i < SLOTS * LOG_SEG_SECTORS; i++) fwrite(zero, sizeof(zero), 1, im->f);
+    fflush(im->f); im->writes = 0; im->dead = 0;
+}
+
+/* ==================== 3.0 Workload ==================== */
+// What the device had acknowledged when the power went: its index just before the failing call, the entry being
+// written and how much of it had reached the card, and the entries the failing call was overwriting or deleting.
+// A write that fails part way may still have landed everything that mattered (a header fits in the first half of a
+// torn sector), so those two may be gone or not, and the open entry may have gained the segment being written.
+typedef struct {
+    logstore_entry_t index[MAX_ENT]; int count;
+    int open; uint32_t open_id, open_bytes, evicting, deleting;
+    uint32_t id[MAX_ENT], total; int entries;
+} model_t;
+
+static int entry_of(const model_t *m, uint32_t id) { for(int i = 0; i < m->entries; i++) if(m->id[i] == id) return i; return -1; }
+
+static void snapshot(model_t *m, const logstore_t *ls) {
+    m->count = ls->count < MAX_ENT ? ls->count : MAX_ENT; memcpy(m->index, ls->entries, m->count * sizeof(logstore_entry_t));
+    m->open = ls->writing && !(ls->cur.meta.flags & LOG_F_HIDDEN); m->open_id = ls->cur.id; m->open_bytes = ls->cur.bytes; m->evicting = m->deleting = 0;
+    for(int i = 0; i < ls->count; i++) {
+        const logstore_entry_t *e = &ls->entries[i]; uint32_t span = (e->last_slot + ls->nslots - e->first_slot) % ls->nslots;
+        if((ls->head + ls->nslots - e->first_slot) % ls->nslots <= span) m->evicting = e->id;
+    }
+}
+
+// Runs the workload until it ends or the power cut fails a call. Returns 1 if it was cut.
+static int run_workload(logstore_t *ls, blockdev_t *dev, model_t *m) {
+    uint8_t buf[CHUNK]; int e = -1;
+    memset(m, 0, sizeof(*m));
+    if(logstore_mount(ls, dev, 0, dev->sector_count)) return 1;
+    for(size_t s = 0; s < sizeof(workload) / sizeof(workload[0]); s++) {
+        const step_t *st = &workload[s]; int r = 0;
+        snapshot(m, ls);
+        if(st->op == OP_BEGIN || st->op == OP_HIDDEN) {
+            logstore_meta_t meta = { .start_time = 1760000000 + s, .sample_rate = 16000, .channels = 1, .bits = 16, .flags = st->op == OP_HIDDEN ? LOG_F_HIDDEN : 0 };
+            e = m->entries++; snprintf(meta.name, sizeof(meta.name), "e%d", e); r = logstore_begin(ls, &meta); m->id[e] = ls->cur.id;
+        } else if(st->op == OP_APPEND) {
+            for(uint32_t off = 0; off < st->n && !r; off += CHUNK) {
+                uint32_t n = st->n - off < CHUNK ? st->n - off : CHUNK; snapshot(m, ls);
+                for(uint32_t i = 0; i < n; i++) buf[i] = pattern(e, off + i);
+                r = logstore_append(ls, buf, n);
+            }
+        } else if(st->op == OP_END) r = logstore_end(ls);
+        else { m->deleting = m->id[st->n]; r = logstore_delete(ls, m->id[st->n]); }
+        if(r) return 1;
+    }
+    snapshot(m, ls); return 0;
+}
+
+/* ==================== 4.0 Recovery Checks ==================== */
+static const char *check_entry(logstore_t *ls, const logstore_entry_t *e, int n) {
+    static uint8_t buf[LOG_SEG_PAYLOAD]; char name[8]; snprintf(name, sizeof(name), "e%d", n);
+    if(strcmp(e->meta.name, name)) return "entry metadata differs";
+    for(uint32_t off = 0; off < e->bytes; off += sizeof(buf)) {
+        uint32_t len = e->bytes - off < sizeof(buf) ? e->bytes - off : sizeof(buf);
+        if(logstore_read(ls, e, off, buf, len) != (int)len) return "read failed";
+        for(uint32_t i = 0; i < len; i++) if(buf[i] != pattern(n, off + i)) return "data differs";
+    }
+    return NULL;
+}
+
+// After the cut: the log mounts, every entry the device had indexed is back with the same length and data, the open
+// clip is back with every flushed segment (unclosed, unless its last one landed after all), and nothing else shows
+// up. Then the log must take a new entry that survives a remount.
+static const char *check_recovery(logstore_t *ls, blockdev_t *dev, const model_t *m) {
+    const char *why; int seen[MAX_ENT] = {0};
+    if(logstore_mount(ls, dev, 0, dev->sector_count)) return "mount failed";
+    for(int i = 0; i < ls->count; i++) {
+        const logstore_entry_t *e = &ls->entries[i]; int n = entry_of(m, e->id), k;
+        if(n < 0) return "unknown entry";
+        if((why = check_entry(ls, e, n))) return why;
+        for(k = 0; k < m->count && m->index[k].id != e->id; k++) {}
+        if(k < m->count) { if(e->bytes != m->index[k].bytes || e->closed != m->index[k].closed) return "indexed entry changed"; }
+        else if(m->open && e->id == m->open_id) { if(e->bytes < m->open_bytes || e->bytes > m->open_bytes + LOG_SEG_PAYLOAD || (e->closed && e->bytes == m->open_bytes)) return "open entry not recovered as flushed"; }
+        else return "deleted or hidden entry came back";
+        seen[n] = 1;
+    }
+    for(int k = 0; k < m->count; k++) if(!seen[entry_of(m, m->index[k].id)] && m->index[k].id != m->evicting && m->index[k].id != m->deleting) return "indexed entry lost";
+    if(m->open && m->open_bytes && !seen[entry_of(m, m->open_id)]) return "open entry lost";
+
+    uint8_t buf[CHUNK]; uint32_t id; logstore_meta_t meta = { .sample_rate = 16000, .channels = 1, .bits = 16 }; strcpy(meta.name, "e15");
+    for(int i = 0; i < CHUNK; i++) buf[i] = pattern(15, i);
+    if(logstore_begin(ls, &meta) || logstore_append(ls, buf, CHUNK) || logstore_end(ls)) return "write after recovery failed";
+    id = ls->cur.id; logstore_unmount(ls);
+    if(logstore_mount(ls, dev, 0, dev->sector_count)) return "remount failed";
+    const logstore_entry_t *e = logstore_find(ls, id);
+    if(!e || !e->closed || e->bytes != CHUNK) return "entry written after recovery lost";
+    if((why = check_entry(ls, e, 15))) return why;
+    logstore_unmount(ls); return NULL;
+}
+
+/* ==================== 5.0 Main ==================== */
+static int usage(void) {
+    fprintf(stderr, "usage: lsharness [-k every] [image]\n"
+                    "  -k     cut power at every k-th sector write (default 1: all of them)\n"
+                    "  image  file for the log region (default: a temporary file)\n");
+    return 2;
+}
+
+int main(int argc, char **argv) {
+    int every = 1, i = 1, bad = 0; image_t im = { .cut = -1 }; logstore_t ls; model_t m;
+    for(; i < argc && argv[i][0] == '-'; i += 2) { if(strcmp(argv[i], "-k") || i + 1 >= argc || (every = atoi(argv[i + 1])) < 1) return usage(); }
+    if(i + 1 < argc) return usage();
+    if(!(im.f = i < argc ? fopen(argv[i], "w+b") : tmpfile())) { perror(i < argc ? argv[i] : "tmpfile"); return 1; }
+    blockdev_t dev = { &im, SLOTS * LOG_SEG_SECTORS, img_read, img_write };
+
+    img_blank(&im);
+    if(run_workload(&ls, &dev, &m)) { fprintf(stderr, "workload failed without a power cut\n"); return 1; }
+    long total = im.writes; free(ls.entries); free(ls.seg_buf); free(ls.sector_buf); // Left open, as if the power went
+
+    const char *why = check_recovery(&ls, &dev, &m);
+    printf("uncut: %ld sector writes, %d entries listed%s%s\n", total, m.count, why ? ", FAIL: " : "", why ? why : ""); bad |= why != NULL;
+
+    for(int torn = 0; torn < 2; torn++) {
+        int runs = 0, fails = 0;
+        for(long cut = 0; cut < total; cut += every, runs++) {
+            img_blank(&im); im.cut = cut; im.torn = torn;
+            int was_cut = run_workload(&ls, &dev, &m); free(ls.entries); free(ls.seg_buf); free(ls.sector_buf);
+            im.cut = -1; im.dead = 0;
+            if(!was_cut) why = "cut never happened"; else why = check_recovery(&ls, &dev, &m);
+            if(why && fails++ < 10) printf("  cut at sector write %ld (%s): %s\n", cut, torn ? "torn" : "clean", why);
+        }
+        printf("%s cuts: %d runs, %d failed\n", torn ? "torn" : "clean", runs, fails); bad |= fails != 0;
+    }
+    fclose(im.f);
+    printf(bad ? "FAILED\n" : "every cut recovered\n");
+    return bad;
+}
@@ -0,0 +1,176 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* msctest: USB Mass Storage Block Shim Tests */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Definitions
+   2.0 File-Backed Block Device
+   3.0 Checks
+   4.0 Main
+========================================*/
+
+/* ==================== 1.0 Includes & Definitions ==================== */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "msc_disk.h"
+
+#define SECTORS 64
+#define BYTES   (SECTORS * BLOCKDEV_SECTOR_SIZE)
+
+static int failed;
+static void check(int ok, const char *what) { printf("%-4s %s\n", ok ? "ok" : "FAIL", what); if(!ok) failed = 1; }
+
+/* ==================== 2.0 File-Backed Block Device ==================== */
+// Sectors live in a temporary file, mirrored by model[]: every check compares the whole image with what the model
+// says it should hold. fail_lba makes any access to that sector an I/O error, as a card would on a bad block.
+typedef struct { FILE *f; uint32_t reads, writes; long fail_lba; } image_t;
+static uint8_t model[BYTES];
+
+static int img_read(void *ctx, uint32_t lba, void *buf, uint32_t count) {
+    image_t *im = ctx; im->reads++;
+    if(im->fail_lba >= lba && im->fail_lba < (long)lba + count) return -1;
+    return fseek(im->f, (long)lba * BLOCKDEV_SECTOR_SIZE, SEEK_SET) || fread(buf, BLOCKDEV_SECTOR_SIZE, count, im->f) != count;
+}
+
+static int img_write(void *ctx, uint32_t lba, const void *buf, uint32_t count) {
+    image_t *im = ctx; im->writes++;
+    if(im->fail_lba >= lba && im->fail_lba < (long)lba + count) return -1;
+    return fseek(im->f, (long)lba * BLOCKDEV_SECTOR_SIZE, SEEK_SET) || fwrite(buf, BLOCKDEV_SECTOR_SIZE, count, im->f) != count;
+}
+
+static int img_matches(image_t *im) {
+    static uint8_t b[BYTES];
+    return !fseek(im->f, 0, SEEK_SET) && fread(b, 1, BYTES, im->f) == BYTES && !memcmp(b, model, BYTES);
+}
+
+static uint32_t rnd_state = 0x2545f491;
+static uint32_t rnd(uint32_t n) { rnd_state ^= rnd_state << 13; rnd_state ^= rnd_state >> 17; rnd_state ^= rnd_state << 5; return rnd_state % n; }
+
+/* ==================== 3.0 Checks ==================== */
+static void check_range(msc_disk_t *d, image_t *im) {
+    uint8_t b[2 * BLOCKDEV_SECTOR_SIZE]; uint32_t sectors; uint16_t size;
+    msc_disk_capacity(d, &sectors, &size);
+    check(msc_disk_ready(d) && sectors == SECTORS && size == BLOCKDEV_SECTOR_SIZE, "capacity of the image");
+    check(msc_disk_read(d, SECTORS - 1, 0, b, BLOCKDEV_SECTOR_SIZE) == BLOCKDEV_SECTOR_SIZE && !memcmp(b, model + BYTES - BLOCKDEV_SECTOR_SIZE, BLOCKDEV_SECTOR_SIZE), "last sector reads");
+    b[0] = 0xa5; model[BYTES - 1] = 0xa5;
+    check(msc_disk_write(d, SECTORS - 1, 511, b, 1) == 1 && img_matches(im), "last byte writes");
+    uint32_t reads = im->reads, writes = im->writes;
+    check(msc_disk_read(d, SECTORS, 0, b, BLOCKDEV_SECTOR_SIZE) == MSC_DISK_ERR_RANGE, "read of the sector past the end is refused");
+    check(msc_disk_read(d, SECTORS - 1, 0, b, 2 * BLOCKDEV_SECTOR_SIZE) == MSC_DISK_ERR_RANGE, "read running past the end is refused whole");
+    check(msc_disk_write(d, SECTORS - 1, 511, b, 2) == MSC_DISK_ERR_RANGE, "write one byte past the end is refused whole");
+    check(msc_disk_write(d, SECTORS - 2, BLOCKDEV_SECTOR_SIZE + 1, b, BLOCKDEV_SECTOR_SIZE) == MSC_DISK_ERR_RANGE, "offset past a sector counts towards the end");
+    check(msc_disk_write(d, 0xffffffffu, 0, b, BLOCKDEV_SECTOR_SIZE) == MSC_DISK_ERR_RANGE && msc_disk_read(d, 0x00800000u, 0, b, 1) == MSC_DISK_ERR_RANGE, "lba that overflows 32-bit byte offsets is refused");
+    check(im->reads == reads && im->writes == writes && img_matches(im) && d->errors == 0, "  no device access and the image unchanged");
+    check(msc_disk_read(d, 3, 0, b, 0) == 0 && msc_disk_write(d, SECTORS - 1, 0, b, 0) == 0 && msc_disk_write(d, SECTORS + 1, 0, b, 0) == MSC_DISK_ERR_RANGE, "empty transfers: 0 in range, refused past the end");
+}
+
+static void check_eject(msc_disk_t *d, image_t *im) {
+    uint8_t b[BLOCKDEV_SECTOR_SIZE] = { 0 }; uint32_t sectors; uint16_t size; uint32_t writes = im->writes;
+    msc_disk_start_stop(d, false, false);
+    check(msc_disk_ready(d), "stop without LoEj leaves the medium in");
+    msc_disk_start_stop(d, false, true); msc_disk_capacity(d, &sectors, &size);
+    check(!msc_disk_ready(d) && sectors == 0, "eject: not ready, no capacity");
+    check(msc_disk_read(d, 0, 0, b, sizeof(b)) == MSC_DISK_ERR_NOTREADY && msc_disk_write(d, 0, 0, b, sizeof(b)) == MSC_DISK_ERR_NOTREADY, "  reads and writes refused");
+    check(msc_disk_write(d, SECTORS, 0, b, sizeof(b)) == MSC_DISK_ERR_NOTREADY, "  not ready wins over range");
+    check(im->writes == writes && img_matches(im), "  image unchanged");
+    msc_disk_start_stop(d, true, false);
+    check(!msc_disk_ready(d), "start without LoEj does not load it");
+    msc_disk_start_stop(d, true, true); msc_disk_capacity(d, &sectors, &size);
+    check(msc_disk_ready(d) && sectors == SECTORS && msc_disk_read(d, 5, 0, b, sizeof(b)) == sizeof(b) && !memcmp(b, model + 5 * BLOCKDEV_SECTOR_SIZE, sizeof(b)), "load brings it back");
+    blockdev_t empty = { im, 0, img_read, img_write }; msc_disk_t e;
+    msc_disk_init(&e, &empty, false); msc_disk_start_stop(&e, true, true);
+    check(!msc_disk_ready(&e), "a device with no sectors never becomes ready");
+}
+
+static void check_read_only(image_t *im, blockdev_t *dev) {
+    msc_disk_t d; uint8_t b[3 * BLOCKDEV_SECTOR_SIZE] = { 0 }; uint32_t writes = im->writes;
+    msc_disk_init(&d, dev, true);
+    check(msc_disk_write(&d, 2, 0, b, sizeof(b)) == MSC_DISK_ERR_RO && msc_disk_write(&d, 2, 100, b, 7) == MSC_DISK_ERR_RO && im->writes == writes && img_matches(im), "read-only disk refuses writes");
+    check(msc_disk_read(&d, 2, 100, b, 1000) == 1000 && !memcmp(b, model + 2 * BLOCKDEV_SECTOR_SIZE + 100, 1000), "  and still reads");
+    check(msc_disk_write(&d, SECTORS, 0, b, 1) == MSC_DISK_ERR_RANGE, "  range is checked first");
+}
+
+// Partial-sector writes go through the bounce: read, patch, write back. The bytes around them must survive.
+static void check_rmw(msc_disk_t *d, image_t *im) {
+    static uint8_t b[8 * BLOCKDEV_SECTOR_SIZE]; int ok = 1;
+    for(uint32_t i = 0; i < 300; i++) b[i] = (uint8_t)(i ^ 0x3c);
+    uint32_t reads = im->reads, writes = im->writes;
+    ok = msc_disk_write(d, 7, 100, b, 300) == 300; memcpy(model + 7 * BLOCKDEV_SECTOR_SIZE + 100, b, 300);
+    check(ok && img_matches(im) && im->reads == reads + 1 && im->writes == writes + 1, "write inside one sector: one read, one write back");
+
+    reads = im->reads; writes = im->writes; uint32_t wr = d->wr_sectors;
+    for(uint32_t i = 0; i < 2100; i++) b[i] = (uint8_t)(i * 13);
+    ok = msc_disk_write(d, 10, 100, b, 2100) == 2100; memcpy(model + 10 * BLOCKDEV_SECTOR_SIZE + 100, b, 2100);
+    check(ok && img_matches(im), "write with a partial head and tail");
+    check(im->reads == reads + 2 && im->writes == writes + 3 && d->wr_sectors == wr + 5, "  head and tail bounced, the 3 sectors between in one call");
+
+    reads = im->reads; memset(b, 0, 2100);
+    check(msc_disk_read(d, 10, 100, b, 2100) == 2100 && !memcmp(b, model + 10 * BLOCKDEV_SECTOR_SIZE + 100, 2100) && im->reads == reads + 3, "read it back: head, middle, tail");
+    reads = im->reads;
+    check(msc_disk_read(d, 20, 0, b, sizeof(b)) == sizeof(b) && im->reads == reads + 1, "aligned read is a single device call");
+
+    // Transfers at every kind of alignment against the model, including offsets past the first sector
+    for(int i = 0; i < 2000 && ok; i++) {
+        uint32_t lba = rnd(SECTORS), off = rnd(3 * BLOCKDEV_SECTOR_SIZE), len = 1 + rnd(sizeof(b) - 1);
+        if(rnd(4) == 0) { off = 0; len = (1 + rnd(8)) * BLOCKDEV_SECTOR_SIZE; }
+        uint64_t at = (uint64_t)lba * BLOCKDEV_SECTOR_SIZE + off; int fits = at + len <= BYTES;
+        if(rnd(2)) {
+            for(uint32_t k = 0; k < len; k++) b[k] = (uint8_t)rnd(256);
+            ok = msc_disk_write(d, lba, off, b, len) == (fits ? (int32_t)len : MSC_DISK_ERR_RANGE);
+            if(fits) memcpy(model + at, b, len);
+        } else ok = fits ? msc_disk_read(d, lba, off, b, len) == (int32_t)len && !memcmp(b, model + at, len) : msc_disk_read(d, lba, off, b, len) == MSC_DISK_ERR_RANGE;
+        ok = ok && img_matches(im);
+    }
+    check(ok && d->errors == 0, "2000 random reads and writes match the model");
+}
+
+// A card error anywhere in the transfer fails it and counts; sectors before the bad one may have been written
+static void check_io(msc_disk_t *d, image_t *im) {
+    uint8_t b[4 * BLOCKDEV_SECTOR_SIZE] = { 0 }; uint32_t errors = d->errors;
+    im->fail_lba = 30;
+    check(msc_disk_read(d, 29, 200, b, 1000) == MSC_DISK_ERR_IO, "read across a bad sector fails");
+    check(msc_disk_write(d, 30, 5, b, 10) == MSC_DISK_ERR_IO && img_matches(im), "partial write to it fails before touching the image");
+    check(msc_disk_write(d, 28, 0, b, sizeof(b)) == MSC_DISK_ERR_IO && d->errors == errors + 3, "whole-sector write over it fails, every error counted");
+    im->fail_lba = -1;
+    fseek(im->f, 0, SEEK_SET); check(fread(model, 1, BYTES, im->f) == BYTES, "image readable after the errors");
+    memset(b, 0x77, 10); memset(model + 30 * BLOCKDEV_SECTOR_SIZE + 5, 0x77, 10);
+    check(msc_disk_write(d, 30, 5, b, 10) == 10 && img_matches(im), "  and writable once the sector recovers");
+}
+
+/* ==================== 4.0 Main ==================== */
+int main(void) {
+    image_t im = { .fail_lba = -1 }; msc_disk_t d;
+    if(!(im.f = tmpfile())) { perror("tmpfile"); return 1; }
+    for(uint32_t i = 0; i < BYTES; i++) model[i] = (uint8_t)(i * 7 + (i >> 9));
+    if(fwrite(model, 1, BYTES, im.f) != BYTES) { perror("image"); return 1; }
+    blockdev_t dev = { &im, SECTORS, img_read, img_write };
+
+    msc_disk_init(&d, &dev, false);
+    check_range(&d, &im);
+    check_eject(&d, &im);
+    check_read_only(&im, &dev);
+    check_rmw(&d, &im);
+    check_io(&d, &im);
+    fclose(im.f);
+    printf(failed ? "FAILED\n" : "all checks passed\n");
+    return failed;
+}
@@ -0,0 +1,179 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* tsdbsim: Telemetry Store Month Simulation */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Simulated Sensors
+   2.0 Ingest
+   3.0 Query Checks
+   4.0 Main
+========================================*/
+
+/* ==================== 1.0 Includes & Simulated Sensors ==================== */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <unistd.h>
+#include "tsdb.h"
+
+#define SERIES    6            // Same set and order as ts_series_t in telemetry.h
+#define T_START   1760000000u  // 2025-10-09, on an hour boundary below
+#define Q_BATCH   64           // Points per query call, about what one BLE page carries
+
+static const uint32_t ring_blocks[TSDB_LEVELS] = { 8192, 4096, 1024 }; // As telemetry.c sizes them on the card
+static const char *names[SERIES] = { "temp", "motion", "sats", "hdop", "lat", "lon" };
+static uint32_t period = 10;
+
+static double now_s(void) { struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts); return ts.tv_sec + ts.tv_nsec / 1e9; }
+
+// The GPS drops its fix for an hour in every 17, so the fix-only series have gaps and short buckets like on a device
+static bool has_value(int s, uint32_t t) { return s < 3 || (t / 3600) % 17 != 5; }
+
+// Daily temperature swing in 0.01 degC, motion in bursts, slowly changing satellite counts and a fix wandering by a
+// few metres: roughly what a stationary logger in a field reports
+static int32_t value(int s, uint32_t t) {
+    switch(s) {
+    case 0: return 1800 + (int32_t)(600 * sin(t / 86400.0 * 6.2831853)) + (int32_t)(t * 7 % 13);
+    case 1: return (t / 600) % 7 == 0 ? (int32_t)(t % 100) : 0;
+    case 2: return 6 + (int32_t)((t / 3000) % 4);
+    case 3: return 12 + (int32_t)((t / 700) % 5);
+    case 4: return 454215000 + (int32_t)((t * 2654435761u) % 60) - 30;
+    default: return -756972000 + (int32_t)((t * 40503u) % 40) - 20;
+    }
+}
+
+/* ==================== 2.0 Ingest ==================== */
+// Every series each period, syncing every minute as telemetry.c does, with one restart (close and reopen) part way
+typedef struct { uint64_t points; double secs, max_us; uint64_t enc[TSDB_LEVELS], blocks[TSDB_LEVELS], pts[TSDB_LEVELS]; } ingest_t;
+
+static void add_stats(ingest_t *in, const tsdb_t *db) {
+    for(int l = 0; l < TSDB_LEVELS; l++) { in->enc[l] += db->stats.enc_bytes[l]; in->blocks[l] += db->stats.blocks[l]; in->pts[l] += db->stats.points[l]; }
+}
+
+static int ingest(tsdb_t *db, const char *dir, uint32_t t0, uint32_t samples, uint32_t restart_at, ingest_t *in) {
+    memset(in, 0, sizeof(*in));
+    if(tsdb_open(db, dir, ring_blocks)) return -1;
+    for(uint32_t i = 0; i < samples; i++) {
+        uint32_t t = t0 + i * period;
+        if(i && i == restart_at) { tsdb_close(db); add_stats(in, db); if(tsdb_open(db, dir, ring_blocks)) return -1; }
+        for(int s = 0; s < SERIES; s++) {
+            if(!has_value(s, t)) continue;
+            double a = now_s(); if(tsdb_append(db, s, t, value(s, t))) return -1; double us = (now_s() - a) * 1e6;
+            in->secs += us / 1e6; in->points++; if(us > in->max_us) in->max_us = us;
+        }
+        if((t - t0) % 60 == 0 && tsdb_sync(db)) return -1;
+    }
+    if(tsdb_sync(db)) return -1;
+    add_stats(in, db); return 0;
+}
+
+/* ==================== 3.0 Query Checks ==================== */
+// Reference rollup of one bucket straight from the generator: count, sum, lo and hi of the raw values in it
+typedef struct { uint32_t count; int64_t sum; int32_t lo, hi; } ref_t;
+
+static ref_t reference(int s, uint32_t from, uint32_t len) {
+    ref_t r = { 0, 0, INT32_MAX, INT32_MIN };
+    for(uint32_t t = from; t < from + len; t += period) if(has_value(s, t)) { int32_t v = value(s, t); r.count++; r.sum += v; if(v < r.lo) r.lo = v; if(v > r.hi) r.hi = v; }
+    return r;
+}
+
+static int64_t rounded_mean(const ref_t *r) { return r->sum >= 0 ? (r->sum + r->count / 2) / r->count : (r->sum - (int64_t)(r->count / 2)) / r->count; }
+
+// Pages a whole query through Q_BATCH-point calls, checking every point against the generator. Raw means are exact;
+// a rollup's count, lo and hi are exact and its mean within tol (hour means rebuilt after a restart are made from
+// rounded minute means). Buckets cut by the ring or by the ends of the run are only checked for order.
+typedef struct { uint32_t points, bad; double ms; } query_t;
+
+static query_t run_query(tsdb_t *db, tsdb_level_t level, uint32_t from, uint32_t to, uint32_t mask, uint32_t t0, uint32_t t_end, int tol) {
+    query_t q = {0}; tsdb_point_t out[Q_BATCH]; tsdb_cursor_t cur; uint32_t prev = 0; int n;
+    uint32_t len = level == TSDB_RAW ? 1 : level == TSDB_MIN ? 60 : 3600;
+    memset(&cur, 0, sizeof(cur)); double a = now_s();
+    while((n = tsdb_query(db, level, from, to, mask, &cur, out, Q_BATCH)) > 0) {
+        for(int i = 0; i < n; i++) {
+            const tsdb_point_t *p = &out[i]; q.points++;
+            if(p->t < prev || p->t < from || p->t > to || p->series >= SERIES || !(mask & (1u << p->series))) { q.bad++; continue; }
+            prev = p->t;
+            if(level == TSDB_RAW) { if(p->count != 1 || p->mean != value(p->series, p->t) || p->lo != p->mean || p->hi != p->mean) q.bad++; continue; }
+            if(p->t < t0 || p->t + len > t_end) continue;
+            ref_t r = reference(p->series, p->t, len);
+            if(p->count != r.count || p->lo != r.lo || p->hi != r.hi || llabs(p->mean - rounded_mean(&r)) > tol) q.bad++;
+        }
+    }
+    q.ms = (now_s() - a) * 1e3; if(n < 0) q.bad++;
+    return q;
+}
+
+static void report_query(const char *what, const query_t *q, uint32_t runs, int *bad) {
+    printf("  %-34s %8u points %6.3f ms%s\n", what, q->points / runs, q->ms / runs, q->bad ? "  MISMATCH" : ""); if(q->bad) *bad = 1;
+}
+
+/* ==================== 4.0 Main ==================== */
+static int usage(void) {
+    fprintf(stderr, "usage: tsdbsim [-d days] [-p seconds] [dir]\n"
+                    "  -d   days of telemetry to simulate (default 30)\n"
+                    "  -p   sample period (default 10, as on the device)\n"
+                    "  dir  where the store files go (default: a temporary directory, removed afterwards)\n");
+    return 2;
+}
+
+int main(int argc, char **argv) {
+    static tsdb_t db; ingest_t in; query_t q; int days = 30, i = 1, bad = 0; char tmp[] = "/tmp/tsdbsimXXXXXX"; const char *dir;
+    for(; i + 1 < argc && argv[i][0] == '-'; i += 2) {
+        if(!strcmp(argv[i], "-d")) days = atoi(argv[i + 1]);
+        else if(!strcmp(argv[i], "-p")) period = atoi(argv[i + 1]);
+        else return usage();
+    }
+    if(days < 1 || period < 1 || period > 60 || 60 % period || i + 1 < argc) return usage();
+    if(!(dir = i < argc ? argv[i] : mkdtemp(tmp))) { perror("mkdtemp"); return 1; }
+
+    uint32_t t0 = T_START / 3600 * 3600, samples = (uint32_t)days * 86400 / period, t_end = t0 + samples * period;
+    printf("%d days of %d series every %u s into %s, ring %u/%u/%u blocks\n", days, SERIES, period, dir, ring_blocks[0], ring_blocks[1], ring_blocks[2]);
+    if(ingest(&db, dir, t0, samples, samples / 2 + 7, &in)) { fprintf(stderr, "ingest failed\n"); return 1; } // Restart mid-hour
+
+    printf("ingest:      %llu points, %.0f points/s, append avg %.2f us, max %.0f us\n", (unsigned long long)in.points, in.points / in.secs, in.secs * 1e6 / in.points, in.max_us);
+    for(int l = 0; l < TSDB_LEVELS; l++) { // Against fixed-width records: u32 t + i32 value raw, u32 t + count + mean, lo, hi for a rollup
+        static const char *lv[TSDB_LEVELS] = { "raw", "minute", "hour" }; double bpp = in.pts[l] ? (double)in.enc[l] / in.pts[l] : 0, plain = l == TSDB_RAW ? 8 : 20;
+        printf("%-7s      %9llu points, %.2f B/point encoded, %.2f B/point with block headers, %.1fx smaller than %.0f-byte records\n", lv[l], (unsigned long long)in.pts[l], bpp,
+               in.pts[l] ? (double)in.blocks[l] * TSDB_BLOCK_SIZE / in.pts[l] : 0, bpp > 0 ? plain / bpp : 0, plain);
+    }
+    printf("on card:     %u KB\n", tsdb_disk_bytes(&db) >> 10);
+
+    printf("queries (per call):\n");
+    uint32_t last_day = t_end - 86400; srand(1);
+    q = run_query(&db, TSDB_RAW, last_day, t_end - 1, 1, t0, t_end, 0); q.bad += q.points != 86400 / period; report_query("raw, last day, temp", &q, 1, &bad);
+    q = (query_t){0};
+    for(int k = 0; k < 100; k++) {
+        uint32_t f = t0 + (uint32_t)(rand() % (days * 24)) * 3600;
+        query_t r = run_query(&db, TSDB_RAW, f, f + 3599, (1u << SERIES) - 1, t0, t_end, 0); q.points += r.points; q.bad += r.bad; q.ms += r.ms;
+    }
+    report_query("raw, random hour, all series", &q, 100, &bad);
+    q = run_query(&db, TSDB_MIN, t0, t_end - 1, 1, t0, t_end, 0); report_query("minute, whole run, temp", &q, 1, &bad);
+    q = run_query(&db, TSDB_MIN, last_day, t_end - 1, (1u << SERIES) - 1, t0, t_end, 0); report_query("minute, last day, all series", &q, 1, &bad);
+    q = run_query(&db, TSDB_HOUR, t0, t_end - 1, (1u << SERIES) - 1, t0, t_end, 1); report_query("hour, whole run, all series", &q, 1, &bad);
+    for(int s = 0; s < SERIES; s++) { char what[40]; snprintf(what, sizeof(what), "hour, whole run, %s", names[s]); q = run_query(&db, TSDB_HOUR, t0, t_end - 1, 1u << s, t0, t_end, 1); if(q.bad) report_query(what, &q, 1, &bad); }
+
+    tsdb_close(&db);
+    if(i >= argc) { char path[64]; static const char *files[] = { "raw.tsd", "min.tsd", "hour.tsd" }; for(int k = 0; k < 3; k++) { snprintf(path, sizeof(path), "%s/%s", dir, files[k]); remove(path); } rmdir(dir); }
+    printf(bad ? "FAILED: queries disagree with the simulated sensors\n" : "all queried points match the simulated sensors\n");
+    return bad;
+}
@@ -0,0 +1,98 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* xferbench: Compressed Download Benchmark */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Usage
+   2.0 Sender Model
+   3.0 Main
+========================================*/
+
+/* ==================== 1.0 Includes & Usage ==================== */
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "xfer_proto.h"
+
+#define BLOCK_MAX 512 // TRANSFER_BLOCK_SIZE in bluetooth_mode.c
+
+typedef struct { uint64_t size, wire; uint32_t frames, plain_frames, lz_frames; double cpu_us; } bench_t;
+
+static int usage(void) {
+    fprintf(stderr, "usage: xferbench [-m mtu] [-r KB/s] [-c us/MB] <file>...\n"
+                    "  -m  negotiated ATT MTU (default 247)\n"
+                    "  -r  plain download rate of the link, from LINK stats (default 80)\n"
+                    "  -c  device compressor cost from LINK stats after a compressed get (default: this host's)\n");
+    return 2;
+}
+
+static double now_us(void) { struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts); return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3; }
+
+/* ==================== 2.0 Sender Model ==================== */
+// Runs the firmware's own sender over the file with every frame acknowledged at once: the same polls, the same
+// compress-or-plain decisions and back-off as a compressed get, so frame counts match what goes over the air.
+static void run(const uint8_t *buf, uint32_t size, uint16_t chunk, bench_t *b) {
+    static xfer_tx_t t; uint8_t payload[BLOCK_MAX]; xfer_hdr_t h;
+    memset(b, 0, sizeof(*b)); b->size = size; b->plain_frames = (size + chunk - 1) / chunk + 1;
+    xfer_tx_begin(&t, 0, size, chunk, XFER_LZ_SPAN, 0);
+    while(!xfer_tx_done(&t) && xfer_tx_poll(&t, 0, &h)) {
+        uint16_t raw = h.len;
+        if(h.flags & XFER_F_LZ) { double t0 = now_us(); raw = xfer_lz_fill(&t, &h, buf + h.offset, payload); b->cpu_us += now_us() - t0; }
+        if(!(h.flags & XFER_F_END)) b->wire += h.len;
+        xfer_tx_sent(&t, &h, buf + h.offset, raw, 0);
+        uint8_t ack[XFER_ACK_LEN] = { XFER_ACK_MAGIC, (uint8_t)t.next_seq, (uint8_t)(t.next_seq >> 8) }; xfer_tx_ack(&t, ack, 0);
+    }
+    b->frames = t.frames; b->lz_frames = t.lz_frames;
+}
+
+static void report(const char *name, const bench_t *b, double kbps, double dev_us_mb) {
+    double mb = b->size / 1048576.0, host_us_mb = mb > 0 ? b->cpu_us / mb : 0, cost = dev_us_mb >= 0 ? dev_us_mb : host_us_mb;
+    double plain_s = b->size / (kbps * 1024), air_s = plain_s * b->frames / b->plain_frames, cpu_s = cost * mb / 1e6;
+    double lz_s = air_s > cpu_s ? air_s : cpu_s; // Compression overlaps the radio draining the frames already queued
+    printf("%-32s %10llu %8u %8u %5.1f%% %6.1f%% %9.0f %8.2f %8.2f %+6.1f%%\n", name, (unsigned long long)b->size, b->plain_frames, b->frames,
+           b->size ? 100.0 * b->wire / b->size : 0, b->frames ? 100.0 * b->lz_frames / b->frames : 0, host_us_mb, plain_s, lz_s, plain_s > 0 ? 100 * (plain_s - lz_s) / plain_s : 0);
+}
+
+/* ==================== 3.0 Main ==================== */
+int main(int argc, char **argv) {
+    int mtu = 247, i = 1; double kbps = 80, dev_us_mb = -1; bench_t all = {0};
+    for(; i + 1 < argc && argv[i][0] == '-'; i += 2) {
+        if(!strcmp(argv[i], "-m")) mtu = atoi(argv[i + 1]);
+        else if(!strcmp(argv[i], "-r")) kbps = atof(argv[i + 1]);
+        else if(!strcmp(argv[i], "-c")) dev_us_mb = atof(argv[i + 1]);
+        else return usage();
+    }
+    if(i >= argc || mtu < 23 || kbps <= 0) return usage();
+    uint16_t chunk = (mtu - 3 < BLOCK_MAX ? mtu - 3 : BLOCK_MAX) - XFER_HDR_LEN;
+    printf("chunk %u bytes, span %u, link %.0f KB/s, compressor cost %s\n", chunk, XFER_LZ_SPAN, kbps, dev_us_mb >= 0 ? "from -c (device)" : "measured on this host");
+    printf("%-32s %10s %8s %8s %6s %7s %9s %8s %8s %7s\n", "file", "bytes", "plain", "lz", "air", "lzfrm", "host_us/MB", "plain_s", "lz_s", "saved");
+    for(; i < argc; i++) {
+        FILE *f = fopen(argv[i], "rb"); long size; uint8_t *buf; bench_t b;
+        if(!f) { fprintf(stderr, "%s: cannot open\n", argv[i]); continue; }
+        fseek(f, 0, SEEK_END); size = ftell(f); rewind(f);
+        if(size < 0 || size > 0x7FFFFFFF || !(buf = malloc(size ? size : 1)) || fread(buf, 1, size, f) != (size_t)size) { fprintf(stderr, "%s: read failed\n", argv[i]); fclose(f); continue; }
+        fclose(f); run(buf, size, chunk, &b); free(buf); report(argv[i], &b, kbps, dev_us_mb);
+        all.size += b.size; all.wire += b.wire; all.frames += b.frames; all.plain_frames += b.plain_frames; all.lz_frames += b.lz_frames; all.cpu_us += b.cpu_us;
+    }
+    if(all.plain_frames) report("TOTAL", &all, kbps, dev_us_mb);
+    return 0;
+}
@@ -0,0 +1,154 @@
+/*
+┌──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┐
+│    _______   ________  ___  ___  ________  ___       ________  ________          ________  _________  ________  ________         │
+│   |\  ___ \ |\   ____\|\  \|\  \|\   __  \|\  \     |\   __  \|\   ____\        |\   __  \|\___   ___\\   __  \|\   ____\        │
+│   \ \   __/|\ \  \___|\ \  \\\  \ \  \|\  \ \  \    \ \  \|\  \ \  \___|        \ \  \|\  \|___ \  \_\ \  \|\  \ \  \___|_       │
+│    \ \  \_|/_\ \  \    \ \   __  \ \  \\\  \ \  \    \ \  \\\  \ \  \  ___       \ \   _  _\   \ \  \ \ \  \\\  \ \_____  \      │
+│     \ \  \_|\ \ \  \____\ \  \ \  \ \  \\\  \ \  \____\ \  \\\  \ \  \|\  \       \ \  \\  \|   \ \  \ \ \  \\\  \|____|\  \     │
+│      \ \_______\ \_______\ \__\ \__\ \_______\ \_______\ \_______\ \_______\       \ \__\\ _\    \ \__\ \ \_______\____\_\  \    │
+│       \|_______|\|_______|\|__|\|__|\|_______|\|_______|\|_______|\|_______|        \|__|\|__|    \|__|  \|_______|\_________\   │
+│                                                                                                                   \|_________|   │
+└──────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────────┘
+*/
+
+/* Team EchoLog (Group 2) */
+/* CEG4912/3 Capstone Project */
+/* School of Electrical Engineering and Computer Science at the University of Ottawa */
+
+/* Onboard OS for ESP32-S3 based ESP-32 S3 Supermini */
+/* xferloop: Lossy Download Loopback Test */
+
+/* Author(s): Gordon, A., Spacek, A., Liu, M., Nyannak, D., Escalante, A. */
+
+/* ========== TABLE OF CONTENTS ========== 
+   1.0 Includes & Link Model
+   2.0 Receiver
+   3.0 Transfer Loop
+   4.0 Main
+========================================*/
+
+/* ==================== 1.0 Includes & Link Model ==================== */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xfer_proto.h"
+#include "lz_block.h"
+#include "crc32.h"
+
+#define LINK_DELAY_MS 25     // One way, each direction
+#define LINK_PER_MS   3      // Notifications the sender may queue per millisecond
+#define LINK_QUEUE    4096   // Frames or ACKs in flight on the model link
+#define RUN_LIMIT_MS  600000 // Ten simulated minutes; every case here finishes in well under one
+#define ACK_EVERY     8      // Client ACKs after this many frames, or sooner once it has something and 100 ms pass
+#define BLOCK_MAX     512    // TRANSFER_BLOCK_SIZE in bluetooth_mode.c
+
+// Frames and ACKs share one model: a FIFO with a fixed delay that drops each packet with probability loss
+typedef struct { uint32_t at; uint16_t len; uint8_t b[BLOCK_MAX]; } pkt_t;
+typedef struct { pkt_t q[LINK_QUEUE]; uint32_t head, tail; double loss; uint32_t sent, dropped; } link_t;
+
+static uint32_t rng = 1;
+static uint32_t rnd(void) { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; } // xorshift32: same runs on every host
+
+static pkt_t *link_slot(link_t *l) { return &l->q[l->tail % LINK_QUEUE]; }
+static void link_send(link_t *l, uint32_t now, uint16_t len) {
+    link_slot(l)->at = now + LINK_DELAY_MS; link_slot(l)->len = len; l->sent++;
+    if(rnd() / 4294967296.0 < l->loss) l->dropped++; else l->tail++;
+}
+static pkt_t *link_recv(link_t *l, uint32_t now) { return l->head < l->tail && l->q[l->head % LINK_QUEUE].at <= now ? &l->q[l->head++ % LINK_QUEUE] : NULL; }
+
+/* ==================== 2.0 Receiver ==================== */
+// What DevTool does with a download: place each frame at its offset (inflating LZ frames), track which sequence
+// numbers arrived, and ACK the lowest one still missing with a bitmap of the 32 after it.
+typedef struct {
+    uint8_t *dst; uint32_t start, end;
+    uint8_t got[XFER_WINDOW * 4]; uint32_t base, end_seq, crc, since, last_ack;
+    int have_end, done, error;
+} rx_t;
+
+static uint32_t le32(const uint8_t *p) { return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24; }
+
+static void rx_frame(rx_t *r, const pkt_t *pk) {
+    const uint8_t *b = pk->b; uint16_t s16 = b[2] | b[3] << 8, len = b[8] | b[9] << 8; uint32_t off = le32(b + 4);
+    uint32_t seq = r->base + (int16_t)(s16 - (uint16_t)r->base);
+    if(b[0] != XFER_MAGIC || pk->len != XFER_HDR_LEN + len) { r->error = 1; return; }
+    if((int32_t)(seq - r->base) < 0) { r->since = ACK_EVERY; return; } // Duplicate of something already ACKed: say so again
+    if(seq - r->base >= sizeof(r->got)) { r->error = 2; return; }
+    if(b[1] & XFER_F_END) { if(off != r->end || len != 4) { r->error = 3; return; } r->have_end = 1; r->end_seq = seq; r->crc = le32(b + XFER_HDR_LEN); }
+    else if(off < r->start || off >= r->end) { r->error = 4; return; }
+    else if(b[1] & XFER_F_LZ) { int n = b[10] | b[11] << 8; if(len < 2 || lz_decompress(b + 12, len - 2, r->dst + off, r->end - off) != n) { r->error = 5; return; } }
+    else if(len > r->end - off) { r->error = 6; return; }
+    else memcpy(r->dst + off, b + XFER_HDR_LEN, len);
+    r->got[seq % sizeof(r->got)] = 1; r->since++;
+    while(r->got[r->base % sizeof(r->got)]) r->got[r->base++ % sizeof(r->got)] = 0;
+    if(r->have_end && r->base == r->end_seq + 1) r->done = 1;
+}
+
+static void rx_ack(rx_t *r, link_t *up, uint32_t now) {
+    if(!(r->since >= ACK_EVERY || (r->since && now - r->last_ack >= 100) || now - r->last_ack >= 300)) return;
+    uint32_t bits = 0; for(int i = 0; i < 32; i++) if(r->got[(r->base + 1 + i) % sizeof(r->got)]) bits |= 1UL << i;
+    uint8_t *a = link_slot(up)->b; a[0] = XFER_ACK_MAGIC; a[1] = r->base; a[2] = r->base >> 8; a[3] = bits; a[4] = bits >> 8; a[5] = bits >> 16; a[6] = bits >> 24;
+    link_send(up, now, XFER_ACK_LEN); r->since = 0; r->last_ack = now;
+}
+
+/* ==================== 3.0 Transfer Loop ==================== */
+// Sends src[start, end) through the firmware's own sender over the lossy link and checks what arrived: every byte
+// of the range, nothing outside it, and the END frame's CRC against the range. Returns 0 when all of that holds.
+static link_t down, up;
+static int run(const uint8_t *src, uint32_t start, uint32_t end, uint16_t chunk, uint16_t span, double loss) {
+    static xfer_tx_t tx; rx_t r; uint32_t now; const char *why = NULL;
+    memset(&r, 0, sizeof(r)); r.dst = calloc(end + 1, 1); r.start = start; r.end = end;
+    memset(&down, 0, sizeof(down)); memset(&up, 0, sizeof(up)); down.loss = up.loss = loss;
+    xfer_tx_begin(&tx, start, end, chunk, span, 0);
+    for(now = 0; now < RUN_LIMIT_MS && !(r.done && xfer_tx_done(&tx)) && !r.error; now++) {
+        xfer_hdr_t h;
+        for(int k = 0; k < LINK_PER_MS && xfer_tx_poll(&tx, now, &h); k++) {
+            uint8_t *b = link_slot(&down)->b; uint16_t raw = h.len;
+            if(h.flags & XFER_F_LZ) raw = xfer_lz_fill(&tx, &h, src + h.offset, b + XFER_HDR_LEN);
+            else if(!(h.flags & XFER_F_END)) memcpy(b + XFER_HDR_LEN, src + h.offset, h.len);
+            xfer_tx_sent(&tx, &h, src + h.offset, raw, now);
+            xfer_pack(&tx, &h, b); link_send(&down, now, XFER_HDR_LEN + h.len); // Packed after sent(): the END frame's CRC is final then
+        }
+        for(pkt_t *pk; (pk = link_recv(&down, now)) && !r.error; ) rx_frame(&r, pk);
+        rx_ack(&r, &up, now);
+        for(pkt_t *pk; (pk = link_recv(&up, now)); ) xfer_tx_ack(&tx, pk->b, now);
+        if(xfer_tx_stalled(&tx, now)) { why = "sender stalled"; break; }
+    }
+    if(!why && r.error) why = "bad frame";
+    else if(!why && !r.done) why = "never finished";
+    else if(!why && memcmp(r.dst + start, src + start, end - start)) why = "range differs";
+    else if(!why) { for(uint32_t i = 0; i < start; i++) if(r.dst[i]) { why = "wrote outside the range"; break; } }
+    if(!why && r.crc != crc32_update(0, src + start, end - start)) why = "CRC differs";
+    printf("%-4s %8u-%-8u chunk %3u %-5s loss %2.0f%%  %6u ms  frames %6u  retx %5u (%4.1f%%)  lz %5u  dropped %u/%u\n", why ? "FAIL" : "ok", start, end, chunk, span ? "lz" : "plain",
+           loss * 100, now, tx.frames, tx.retx, tx.frames ? 100.0 * tx.retx / tx.frames : 0, tx.lz_frames, down.dropped + up.dropped, down.sent + up.sent);
+    if(why) printf("     %s (receiver error %d)\n", why, r.error);
+    free(r.dst); return why != NULL;
+}
+
+/* ==================== 4.0 Main ==================== */
+// Test data like what comes off the card: CSV sensor lines that compress, with stretches of noise that do not
+static void fill(uint8_t *buf, uint32_t len) {
+    char line[64]; uint32_t i = 0;
+    while(i < len) {
+        int n = snprintf(line, sizeof(line), "%u,ACC,%d,%d,%d,GPS,45.42%04u,-75.69%04u\n", i / 40, (int)(rnd() % 64) - 32, (int)(rnd() % 64) - 32, 1000 + (int)(rnd() % 16), rnd() % 10000, rnd() % 10000);
+        for(int k = 0; k < n && i < len; k++, i++) buf[i] = (i >> 15) % 3 == 2 ? (uint8_t)rnd() : (uint8_t)line[k];
+    }
+}
+
+int main(void) {
+    static const double losses[] = { 0.01, 0.02, 0.03, 0.05 };
+    static const uint32_t sizes[] = { 1, 243, 244, 100000, 1000003 };
+    uint32_t max = 1000003; uint8_t *src = malloc(max); int bad = 0;
+    fill(src, max);
+    for(int s = 0; s < 2; s++) {
+        uint16_t span = s ? XFER_LZ_SPAN : 0;
+        for(unsigned i = 0; i < sizeof(losses) / sizeof(losses[0]); i++) {
+            for(unsigned j = 0; j < sizeof(sizes) / sizeof(sizes[0]); j++) bad |= run(src, 0, sizes[j], 244, span, losses[i]);
+            bad |= run(src, 12345, 100000, 244, span, losses[i]); // A resumed get: only the tail of the file
+        }
+        bad |= run(src, 0, 50000, 10, span, 0.05); // Smallest MTU
+        bad |= run(src, 0, 0, 244, span, 0.05);    // Empty file: just the END frame
+    }
+    free(src);
+    printf(bad ? "FAILED\n" : "all transfers complete, range and CRC match\n");
+    return bad;
+}